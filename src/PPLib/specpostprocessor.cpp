@@ -0,0 +1,521 @@
+/* 
+ * **************************************************************************
+ * 
+ *  file:       specpostprocessor.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create gcode for toolpaths created from CAD models
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ * 
+ *  This program is free software: you can redistribute it and/or modify 
+ *  it under the terms of the GNU General Public License as published by 
+ *  the Free Software Foundation, either version 2 of the License, or 
+ *  (at your option) any later version. 
+ *   
+ *  This program is distributed in the hope that it will be useful, 
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ *  GNU General Public License for more details. 
+ *   
+ *  You should have received a copy of the GNU General Public License 
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * **************************************************************************
+ */
+#include "specpostprocessor.h"
+#include <gp_Pnt.hxx>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+
+const char* SpecPostProcessor::SlotNames[] = {
+  "X", "Y", "Z", "I", "J", "K", "A", "B", "C"
+, "feed", "speed", "motion", "tool", "nextTool", "num", "corr"
+, "depth", "topZ", "r0", "r1", "qMin", "qMax", "retract", "dwell"
+, "minX", "minY", "minZ", "maxX", "maxY", "maxZ"
+  };
+const char* SpecPostProcessor::StringSlotNames[] = {
+  "fixture", "coolant", "msg", "job"
+  };
+const char* SpecPostProcessor::BlockNames[] = {
+  "arc", "defineWorkpiece", "endCycle", "execCycle", "jobExit", "jobIntro"
+, "lengthCorrEnd", "lengthCorrStart", "lineComment", "opExit", "opIntro"
+, "prepareTool", "prominentComment", "radiusCorrEnd", "radiusCorrStart"
+, "rotation", "straightMove", "toolChange", "traverse"
+  };
+const char* SpecPostProcessor::CycleNames[] = {
+  "noCycle", "fineBoring", "spotDrill", "drillWithDwell", "peckDrilling", "tapping", "boring"
+  };
+
+
+SpecPostProcessor::SpecPostProcessor(QObject* parent)
+ : AbstractPostProcessor(parent)
+ , eol("\n")
+ , separator(' ')
+ , valid(false) {
+  for (int i=0; i < SlotCount; ++i) {
+      value[i]   = 0;
+      last[i]    = 0;
+      hasLast[i] = false;
+      }
+  }
+
+
+// fixed point without QString::arg - the hot path of all moves
+void SpecPostProcessor::appendNumber(QString& out, double v, int decimals) {
+  static const double scale[] = { 1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9 };
+  double a = std::abs(v) * scale[decimals] + 0.5;
+
+  if (a >= 9e18) {
+     out += QString::number(v, 'f', decimals);
+     return;
+     }
+  unsigned long long n = static_cast<unsigned long long>(a);
+  char               buf[32];
+  int                pos = sizeof(buf);
+
+  for (int i=0; i < decimals; ++i) {
+      buf[--pos] = '0' + n % 10;
+      n /= 10;
+      }
+  if (decimals) buf[--pos] = '.';
+  do {
+     buf[--pos] = '0' + n % 10;
+     n /= 10;
+     } while (n);
+  if (v < 0 && std::abs(v) * scale[decimals] >= 0.5) buf[--pos] = '-';
+  out += QLatin1String(buf + pos, sizeof(buf) - pos);
+  }
+
+
+bool SpecPostProcessor::compile(const QJsonObject& spec) {
+  QMap<QString, int> fieldIndex;
+  QJsonObject        jFields    = spec.value("fields").toObject();
+  QJsonObject        jTemplates = spec.value("templates").toObject();
+  QJsonObject        jCycles    = spec.value("cycles").toObject();
+  QString            sep        = spec.value("separator").toString(" ");
+
+  valid     = false;
+  specName  = spec.value("name").toString();
+  extension = spec.value("extension").toString("nc");
+  eol       = spec.value("endOfLine").toString("\n");
+  separator = sep.isEmpty() ? QChar() : sep.at(0);
+  fixtures.clear();
+  coolants.clear();
+  fields.clear();
+  for (const auto& v : spec.value("fixtures").toArray()) fixtures << v.toString();
+  for (const auto& v : spec.value("coolant").toArray())  coolants << v.toString();
+
+  for (auto it = jFields.begin(); it != jFields.end(); ++it) {
+      QJsonObject jf = it.value().toObject();
+      QString     sn = jf.value("value").toString(it.key());
+      Field       f;
+
+      for (int i=0; i < SlotCount; ++i) {
+          if (sn == SlotNames[i]) {
+             f.slot = i;
+             break;
+             }
+          }
+      if (f.slot < 0) {
+         qWarning() << "PP-spec" << specName << ": field" << it.key() << "has unknown value" << sn;
+         return false;
+         }
+      f.prefix   = jf.value("prefix").toString(it.key());
+      f.decimals = qBound(0, jf.value("decimals").toInt(Decimals), 9);
+      f.scale    = jf.value("scale").toDouble(1);
+      f.modal    = jf.value("modal").toBool(false);
+      f.skipZero = jf.value("skipZero").toBool(false);
+      fieldIndex[it.key()] = fields.size();
+      fields.push_back(f);
+      }
+  for (int b=0; b < BlkCycle; ++b) {
+      blocks[b].clear();
+      if (!compileTemplate(jTemplates.value(BlockNames[b]).toString(), blocks[b], fieldIndex)) return false;
+      }
+  for (int c=0; c < InvalidCycle; ++c) {
+      blocks[BlkCycle + c].clear();
+      if (!compileTemplate(jCycles.value(CycleNames[c]).toString(), blocks[BlkCycle + c], fieldIndex)) return false;
+      }
+  valid = true;
+
+  return valid;
+  }
+
+
+bool SpecPostProcessor::compileTemplate(const QString& src, Program& prog, const QMap<QString, int>& fieldIndex) {
+  QString text;
+  auto    flushText = [&]() {
+    if (text.isEmpty()) return;
+    Instr in;
+
+    in.kind = Instr::Text;
+    in.text = text;
+    prog.push_back(in);
+    text.clear();
+    };
+
+  for (int i=0; i < src.size(); ++i) {
+      QChar c = src.at(i);
+
+      if (c == '\n') {
+         flushText();
+         Instr in;
+
+         in.kind = Instr::EndOfLine;
+         prog.push_back(in);
+         continue;
+         }
+      if (c != '{') {
+         text += c;
+         continue;
+         }
+      int end = src.indexOf('}', i);
+
+      if (end < 0) {
+         qWarning() << "PP-spec" << specName << ": unterminated field in" << src;
+         return false;
+         }
+      QString ref = src.mid(i + 1, end - i - 1);
+      Instr   in;
+      int     eq  = ref.indexOf('=');
+
+      i = end;
+      if (eq >= 0) {
+         bool ok = false;
+
+         in.constant = ref.mid(eq + 1).toDouble(&ok);
+         in.assign   = ok;
+         ref         = ref.left(eq);
+         }
+      if (ref.endsWith('!')) {
+         in.forced = true;
+         ref.chop(1);
+         }
+      flushText();
+      if (fieldIndex.contains(ref)) {
+         in.kind  = Instr::Number;
+         in.field = fieldIndex.value(ref);
+         in.slot  = fields[in.field].slot;
+         in.text  = fields[in.field].prefix;
+         prog.push_back(in);
+         continue;
+         }
+      for (int s=0; s < StrCount; ++s) {
+          if (ref == StringSlotNames[s]) {
+             in.kind = Instr::String;
+             in.slot = s;
+             break;
+             }
+          }
+      if (in.slot < 0) {
+         qWarning() << "PP-spec" << specName << ": unknown field" << ref << "in" << src;
+         return false;
+         }
+      prog.push_back(in);
+      }
+  flushText();
+
+  return true;
+  }
+
+
+QString SpecPostProcessor::fixtureID(int f) {
+  return fixtures.value(f);
+  }
+
+
+QString SpecPostProcessor::genArc(const gp_Pnt& nxtPos, const gp_Pnt& center, bool ccw, double feed) {
+  value[SlotMotion] = ccw ? 3 : 2;
+  value[SlotX]      = nxtPos.X();
+  value[SlotY]      = nxtPos.Y();
+  value[SlotZ]      = nxtPos.Z();
+  value[SlotI]      = center.X() - lPos.X();
+  value[SlotJ]      = center.Y() - lPos.Y();
+  value[SlotK]      = center.Z() - lPos.Z();
+  value[SlotFeed]   = feed;
+  QString rv = run(BlkArc);
+
+  moveTo(nxtPos);
+
+  return rv;
+  }
+
+
+// r0 and r1 are passed as absolute heights to the spec
+QString SpecPostProcessor::genDefineCycle(int c, double topZ, double r0, double r1, double depth, double qMin, double qMax, double retract, double dwell, int feed) {
+  if (c < 0 || c >= InvalidCycle || depth >= topZ) return QString();
+  value[SlotTopZ]    = topZ;
+  value[SlotR0]      = topZ + r0;
+  value[SlotR1]      = topZ + r1;
+  value[SlotDepth]   = depth;
+  value[SlotQMin]    = qMin;
+  value[SlotQMax]    = qMax;
+  value[SlotRetract] = retract;
+  value[SlotDwell]   = dwell;
+  value[SlotFeed]    = feed;
+
+  return run(static_cast<Block>(BlkCycle + c));
+  }
+
+
+QString SpecPostProcessor::genDefineWorkpiece(const gp_Pnt& minCorner, const gp_Pnt& maxCorner) {
+  value[SlotMinX] = minCorner.X();
+  value[SlotMinY] = minCorner.Y();
+  value[SlotMinZ] = minCorner.Z();
+  value[SlotMaxX] = maxCorner.X();
+  value[SlotMaxY] = maxCorner.Y();
+  value[SlotMaxZ] = maxCorner.Z();
+
+  return run(BlkDefineWorkpiece);
+  }
+
+
+QString SpecPostProcessor::genEndCycle() {
+  return run(BlkEndCycle);
+  }
+
+
+QString SpecPostProcessor::genEndOfLine() {
+  return eol;
+  }
+
+
+QString SpecPostProcessor::genExecCycle(int, double x, double y) {
+  value[SlotX] = x;
+  value[SlotY] = y;
+  QString rv = run(BlkExecCycle);
+
+  moveTo(gp_Pnt(x, y, lPos.Z()));
+
+  return rv;
+  }
+
+
+QString SpecPostProcessor::genJobExit(const QString& jobName) {
+  str[StrJob] = jobName;
+
+  return run(BlkJobExit);
+  }
+
+
+// instances get reused for several jobs, so modal state starts
+// over with each new job
+QString SpecPostProcessor::genJobIntro(const QString& jobName) {
+  std::fill(hasLast, hasLast + SlotCount, false);
+  str[StrJob] = jobName;
+
+  return run(BlkJobIntro);
+  }
+
+
+QString SpecPostProcessor::genLengthCorrEnd() {
+  return run(BlkLengthCorrEnd);
+  }
+
+
+QString SpecPostProcessor::genLengthCorrStart(int toolNum) {
+  value[SlotTool] = toolNum;
+
+  return run(BlkLengthCorrStart);
+  }
+
+
+QString SpecPostProcessor::genLineComment(const QString& msg) {
+  str[StrMsg] = msg;
+
+  return run(BlkLineComment);
+  }
+
+
+QString SpecPostProcessor::genOPExit() {
+  return run(BlkOPExit);
+  }
+
+
+QString SpecPostProcessor::genOPIntro(int num, int fixture, const gp_Pnt& pos, double speed, double feed, int toolNum, int cooling, int nxtToolNum) {
+  value[SlotNum]      = num;
+  value[SlotX]        = pos.X();
+  value[SlotY]        = pos.Y();
+  value[SlotZ]        = pos.Z();
+  value[SlotSpeed]    = speed;
+  value[SlotFeed]     = feed;
+  value[SlotTool]     = toolNum;
+  value[SlotNextTool] = nxtToolNum;
+  str[StrFixture]     = fixtureID(fixture);
+  str[StrCoolant]     = coolants.value(cooling);
+  QString rv = run(BlkOPIntro);
+
+  moveTo(pos);
+
+  return rv;
+  }
+
+
+QString SpecPostProcessor::genPrepareTool(int toolNum) {
+  value[SlotTool] = toolNum;
+
+  return run(BlkPrepareTool);
+  }
+
+
+QString SpecPostProcessor::genProminentComment(const QString& msg) {
+  str[StrMsg] = msg;
+
+  return run(BlkProminentComment);
+  }
+
+
+QString SpecPostProcessor::genRadiusCorrEnd() {
+  radiusCorr = 0;
+
+  return run(BlkRadiusCorrEnd);
+  }
+
+
+QString SpecPostProcessor::genRadiusCorrStart(const gp_Pnt& nxtPos, int toolSetNum, bool right) {
+  value[SlotCorr] = right ? 42 : 41;
+  value[SlotTool] = toolSetNum;
+  value[SlotX]    = nxtPos.X();
+  value[SlotY]    = nxtPos.Y();
+  value[SlotZ]    = nxtPos.Z();
+  radiusCorr      = right ? 1 : -1;
+  QString rv = run(BlkRadiusCorrStart);
+
+  moveTo(nxtPos);
+
+  return rv;
+  }
+
+
+QString SpecPostProcessor::genRotation(double a, double b, double c) {
+  value[SlotA] = a;
+  value[SlotB] = b;
+  value[SlotC] = c;
+  rot.SetCoord(a, b, c);
+
+  return run(BlkRotation);
+  }
+
+
+QString SpecPostProcessor::genStraightMove(const gp_Pnt& nxtPos, double feed) {
+  value[SlotX]    = nxtPos.X();
+  value[SlotY]    = nxtPos.Y();
+  value[SlotZ]    = nxtPos.Z();
+  value[SlotFeed] = feed;
+  QString rv = run(BlkStraightMove);
+
+  moveTo(nxtPos);
+
+  return rv;
+  }
+
+
+QString SpecPostProcessor::genToolChange() {
+  return run(BlkToolChange);
+  }
+
+
+// writer tells about the last move, so motion code gets repeated,
+// whenever something else was output between
+QString SpecPostProcessor::genTraverse(const gp_Pnt& nxtPos, int lastCode) {
+  if (lastCode) hasLast[SlotMotion] = false;
+  value[SlotX] = nxtPos.X();
+  value[SlotY] = nxtPos.Y();
+  value[SlotZ] = nxtPos.Z();
+  QString rv = run(BlkTraverse);
+
+  moveTo(nxtPos);
+
+  return rv;
+  }
+
+
+QString SpecPostProcessor::getFileExtension() const {
+  return extension;
+  }
+
+
+gp_Pnt SpecPostProcessor::lastPos() const {
+  return lPos;
+  }
+
+
+bool SpecPostProcessor::load(const QString& fileName) {
+  QFile file(fileName);
+
+  if (!file.open(QIODevice::ReadOnly)) {
+     qWarning() << "failed to open PP-spec" << fileName;
+     return false;
+     }
+  QJsonParseError err;
+  QJsonDocument   doc = QJsonDocument::fromJson(file.readAll(), &err);
+
+  if (err.error != QJsonParseError::NoError) {
+     qWarning() << "PP-spec" << fileName << ":" << err.errorString() << "at" << err.offset;
+     return false;
+     }
+  return compile(doc.object());
+  }
+
+
+// modal state of coordinates is the last position, no matter,
+// whether the coordinate was written or not
+void SpecPostProcessor::moveTo(const gp_Pnt& p) {
+  setLastPos(p);
+  }
+
+
+QString SpecPostProcessor::run(Block b) {
+  QString rv;
+
+  rv.reserve(64);
+  for (const Instr& in : blocks[b]) {
+      switch (in.kind) {
+        case Instr::Text:
+             rv += in.text;
+             break;
+        case Instr::EndOfLine:
+             rv += eol;
+             break;
+        case Instr::Number: {
+             const Field& f = fields[in.field];
+
+             if (in.assign) value[in.slot] = in.constant;
+             double v = value[in.slot] * f.scale;
+
+             if (!in.forced) {
+                if (f.skipZero && std::abs(v) <= MinDelta) break;
+                if (f.modal && hasLast[in.slot] && std::abs(value[in.slot] - last[in.slot]) <= MinDelta) break;
+                }
+             if (!separator.isNull() && !rv.isEmpty() && !rv.endsWith(separator) && !rv.endsWith(eol))
+                rv += separator;
+             rv += in.text;
+             appendNumber(rv, v, f.decimals);
+             last[in.slot]    = value[in.slot];
+             hasLast[in.slot] = true;
+             } break;
+        case Instr::String:
+             if (str[in.slot].isEmpty()) break;
+             if (!separator.isNull() && !rv.isEmpty() && !rv.endsWith(separator) && !rv.endsWith(eol))
+                rv += separator;
+             rv += str[in.slot];
+             break;
+        }
+      }
+  return rv;
+  }
+
+
+void SpecPostProcessor::setLastPos(const gp_Pnt& pos) {
+  lPos = pos;
+  last[SlotX] = pos.X();
+  last[SlotY] = pos.Y();
+  last[SlotZ] = pos.Z();
+  hasLast[SlotX] = hasLast[SlotY] = hasLast[SlotZ] = true;
+  }
@@ -0,0 +1,153 @@
+/* 
+ * **************************************************************************
+ * 
+ *  file:       specpostprocessor.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create gcode for toolpaths created from CAD models
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ * 
+ *  This program is free software: you can redistribute it and/or modify 
+ *  it under the terms of the GNU General Public License as published by 
+ *  the Free Software Foundation, either version 2 of the License, or 
+ *  (at your option) any later version. 
+ *   
+ *  This program is distributed in the hope that it will be useful, 
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of 
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the 
+ *  GNU General Public License for more details. 
+ *   
+ *  You should have received a copy of the GNU General Public License 
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ * 
+ * **************************************************************************
+ */
+#ifndef SPECPOSTPROCESSOR_H
+#define SPECPOSTPROCESSOR_H
+#include "abstractpostprocessor.h"
+#include "DrillCycle.h"
+#include <QJsonObject>
+#include <QMap>
+#include <QStringList>
+#include <vector>
+
+
+// generic postprocessor driven by a declarative format spec (json).
+// Each block template of the spec gets compiled at load time into a
+// list of instructions, that reference value slots by index. Generating
+// a block fills the slots (block buffer) and runs the instructions
+// into a single output buffer - no parsing or lookup at runtime.
+//
+// Template syntax: literal text, "\n" for end of line and fields
+//   {name}        emit field by its spec (modal, skipZero)
+//   {name!}       emit field always
+//   {name=value}  set slot of field to constant before emitting
+// String slots (fixture, coolant, msg, job) are referenced the same way.
+// The writer passes feed 0 for "no feed", so feed fields need skipZero.
+class SpecPostProcessor : public AbstractPostProcessor, public PostProcessor
+{
+  Q_OBJECT
+  Q_INTERFACES(PostProcessor)
+public:
+  explicit SpecPostProcessor(QObject* parent = nullptr);
+  virtual ~SpecPostProcessor() = default;
+
+  bool            compile(const QJsonObject& spec);
+  bool            isValid() const { return valid; }
+  bool            load(const QString& fileName);
+  QString         name() const    { return specName; }
+
+  virtual QString fixtureID(int f) override;
+  virtual QString genArc(const gp_Pnt& nxtPos, const gp_Pnt& center, bool ccw, double feed) override;
+  virtual QString genDefineCycle(int c, double topZ, double r0, double r1, double depth, double qMin, double qMax, double retract, double dwell, int feed) override;
+  virtual QString genDefineWorkpiece(const gp_Pnt& minCorner, const gp_Pnt& maxCorner) override;
+  virtual QString genEndCycle() override;
+  virtual QString genEndOfLine()  override;
+  virtual QString genExecCycle(int c, double x, double y) override;
+  virtual QString genJobExit(const QString& jobName)  override;
+  virtual QString genJobIntro(const QString& jobName) override;
+  virtual QString genLengthCorrEnd() override;
+  virtual QString genLengthCorrStart(int toolNum) override;
+  virtual QString genLineComment(const QString& msg) override;
+  virtual QString genOPExit()     override;
+  virtual QString genOPIntro(int num, int fixture, const gp_Pnt& pos, double speed, double feed, int toolNum, int cooling, int nxtToolNum) override;
+  virtual QString genPrepareTool(int toolNum) override;
+  virtual QString genProminentComment(const QString& msg) override;
+  virtual QString genRadiusCorrEnd() override;
+  virtual QString genRadiusCorrStart(const gp_Pnt& nxtPos, int toolSetNum, bool right = false) override;
+  virtual QString genRotation(double a, double b, double c) override;
+  virtual QString genStraightMove(const gp_Pnt& nxtPos, double feed) override;
+  virtual QString genToolChange() override;
+  virtual QString genTraverse(const gp_Pnt& nxtPos, int lastCode) override;
+  virtual QString getFileExtension() const override;
+  virtual gp_Pnt  lastPos() const override;
+  virtual void    setLastPos(const gp_Pnt& pos) override;
+
+  enum Slot {
+    SlotX, SlotY, SlotZ, SlotI, SlotJ, SlotK, SlotA, SlotB, SlotC
+  , SlotFeed, SlotSpeed, SlotMotion, SlotTool, SlotNextTool, SlotNum, SlotCorr
+  , SlotDepth, SlotTopZ, SlotR0, SlotR1, SlotQMin, SlotQMax, SlotRetract, SlotDwell
+  , SlotMinX, SlotMinY, SlotMinZ, SlotMaxX, SlotMaxY, SlotMaxZ
+  , SlotCount
+    };
+  enum StringSlot {
+    StrFixture, StrCoolant, StrMsg, StrJob
+  , StrCount
+    };
+  enum Block {
+    BlkArc, BlkDefineWorkpiece, BlkEndCycle, BlkExecCycle, BlkJobExit, BlkJobIntro
+  , BlkLengthCorrEnd, BlkLengthCorrStart, BlkLineComment, BlkOPExit, BlkOPIntro
+  , BlkPrepareTool, BlkProminentComment, BlkRadiusCorrEnd, BlkRadiusCorrStart
+  , BlkRotation, BlkStraightMove, BlkToolChange, BlkTraverse
+  , BlkCycle                                        // one block per drill cycle
+  , BlkCount = BlkCycle + InvalidCycle
+    };
+  static const char* SlotNames[];
+  static const char* StringSlotNames[];
+  static const char* BlockNames[];
+  static const char* CycleNames[];
+
+protected:
+  struct Field {
+    QString prefix;
+    int     slot     = -1;
+    int     decimals = 3;
+    double  scale    = 1;
+    bool    modal    = false;
+    bool    skipZero = false;
+    };
+  struct Instr {
+    enum Kind { Text, Number, String, EndOfLine };
+    Kind    kind;
+    QString text;              // literal or prefix
+    int     field    = -1;     // Number
+    int     slot     = -1;     // Number and String
+    bool    forced   = false;
+    bool    assign   = false;
+    double  constant = 0;
+    };
+  typedef std::vector<Instr> Program;
+
+  bool    compileTemplate(const QString& src, Program& prog, const QMap<QString, int>& fields);
+  QString run(Block b);
+  void    moveTo(const gp_Pnt& p);
+
+  static void appendNumber(QString& out, double v, int decimals);
+
+private:
+  QString            specName;
+  QString            extension;
+  QString            eol;
+  QChar              separator;
+  QStringList        fixtures;
+  QStringList        coolants;
+  std::vector<Field> fields;
+  Program            blocks[BlkCount];
+  double             value[SlotCount];
+  double             last[SlotCount];
+  bool               hasLast[SlotCount];
+  QString            str[StrCount];
+  bool               valid;
+  };
+#endif // SPECPOSTPROCESSOR_H
@@ -0,0 +1,597 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       adaptivepathbuilder.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "adaptivepathbuilder.h"
+#include "core.h"
+#include "gocontour.h"
+#include "gopocket.h"
+#include "kuteCAM.h"
+#include "operation.h"
+#include "pathbuilderutil.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include "wsstraightmove.h"
+#include "wstraverse.h"
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepTools_WireExplorer.hxx>
+#include <Bnd_Box.hxx>
+#include <GCPnts_TangentialDeflection.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Wire.hxx>
+#include <gp_Vec2d.hxx>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+
+typedef std::vector<gp_Pnt2d> Polyline2d;
+
+
+namespace {
+
+// contour as polyline in direction of the contour
+Polyline2d toPolyline(GOContour* c, double z, double deflection) {
+  Polyline2d   rv;
+  TopoDS_Shape s = c->toWire(z);
+
+  if (s.IsNull() || s.ShapeType() != TopAbs_WIRE) return rv;
+  for (BRepTools_WireExplorer we(TopoDS::Wire(s)); we.More(); we.Next()) {
+      BRepAdaptor_Curve           ac(we.Current());
+      GCPnts_TangentialDeflection td(ac, 0.1, deflection);
+      Polyline2d                  ep;
+
+      for (int i=1; i <= td.NbPoints(); ++i)
+          ep.emplace_back(td.Value(i).X(), td.Value(i).Y());
+      if (we.Current().Orientation() == TopAbs_REVERSED) std::reverse(ep.begin(), ep.end());
+      for (auto& p : ep)
+          if (rv.empty() || rv.back().Distance(p) > kute::MinDelta) rv.push_back(p);
+      }
+  return rv;
+  }
+
+
+double distToSegment(const gp_Pnt2d& p, const gp_Pnt2d& a, const gp_Pnt2d& b) {
+  gp_Vec2d ab(a, b);
+  gp_Vec2d ap(a, p);
+  double   l2 = ab.SquareMagnitude();
+  double   t  = l2 > 0 ? std::max(0.0, std::min(1.0, ap.Dot(ab) / l2)) : 0;
+
+  return p.Distance(gp_Pnt2d(a.X() + t * ab.X(), a.Y() + t * ab.Y()));
+  }
+
+
+const double RampSlope = std::tan(3.0 * M_PI / 180);     // entry ramp of 3°
+
+
+// enter a level by ramping back and forth along the first points of
+// path (which are known to be clear of the part) instead of plunging
+// into stock. Ends at start of path on bottom.
+void rampDown(std::vector<Workstep*>& toolPath, const Polyline2d& path, double top, double bottom, double maxLeg) {
+  Polyline2d leg { path.front() };
+  double     len = 0;
+  gp_Pnt     e(path.front().X(), path.front().Y(), top);
+  double     z   = top;
+
+  for (size_t i=1; i < path.size() && len < maxLeg; ++i) {
+      len += path[i].Distance(path[i - 1]);
+      leg.push_back(path[i]);
+      }
+  if (len < kute::MinDelta) {                  // no room to ramp
+     gp_Pnt s(e.X(), e.Y(), bottom);
+
+     toolPath.push_back(new WSStraightMove(e, s));
+     return;
+     }
+  Polyline2d trip(leg);
+
+  trip.insert(trip.end(), leg.rbegin() + 1, leg.rend());
+  while (z > bottom + kute::MinDelta) {
+        for (size_t i=1; i < trip.size(); ++i) {
+            z = std::max(bottom, z - trip[i].Distance(trip[i - 1]) * RampSlope);
+            gp_Pnt nxt(trip[i].X(), trip[i].Y(), z);
+
+            toolPath.push_back(new WSStraightMove(e, nxt));
+            e = nxt;
+            }
+        }
+  }
+
+
+// raster of one region. Stock holds all material, target the part
+// of it this region has to remove. Allowed cells may take the tool
+// center.
+class EngagementGrid
+{
+public:
+  EngagementGrid(double x0, double y0, double x1, double y1, double cell, double toolRadius)
+   : x0(x0)
+   , y0(y0)
+   , h(cell)
+   , nx(std::max(1, (int)std::ceil((x1 - x0) / cell)))
+   , ny(std::max(1, (int)std::ceil((y1 - y0) / cell)))
+   , stock(nx * ny, 0)
+   , target(nx * ny, 0)
+   , allowed(nx * ny, 0) {
+    int r = std::ceil(toolRadius / h);
+
+    for (int dy=-r; dy <= r; ++dy)
+        for (int dx=-r; dx <= r; ++dx)
+            if (std::hypot(dx, dy) * h <= toolRadius) disk.emplace_back(dx, dy);
+    }
+
+  gp_Pnt2d center(int ix, int iy) const { return gp_Pnt2d(x0 + (ix + 0.5) * h, y0 + (iy + 0.5) * h); }
+  int      diskSize() const             { return disk.size(); }
+
+  int index(const gp_Pnt2d& p) const {
+    int ix = std::floor((p.X() - x0) / h);
+    int iy = std::floor((p.Y() - y0) / h);
+
+    if (ix < 0 || iy < 0 || ix >= nx || iy >= ny) return -1;
+    return iy * nx + ix;
+    }
+
+  bool isAllowed(const gp_Pnt2d& p) const {
+    int i = index(p);
+
+    return i >= 0 && allowed[i];
+    }
+
+  // cells of given mask under tool at p
+  int load(const gp_Pnt2d& p, const std::vector<uint8_t>& mask) const {
+    int ix = std::floor((p.X() - x0) / h);
+    int iy = std::floor((p.Y() - y0) / h);
+    int n  = 0;
+
+    for (auto& d : disk) {
+        int cx = ix + d.first;
+        int cy = iy + d.second;
+
+        if (cx < 0 || cy < 0 || cx >= nx || cy >= ny) continue;
+        if (mask[cy * nx + cx]) ++n;
+        }
+    return n;
+    }
+
+  // direction from p to the center of stock under tool
+  gp_Vec2d stockDir(const gp_Pnt2d& p) const {
+    int    ix = std::floor((p.X() - x0) / h);
+    int    iy = std::floor((p.Y() - y0) / h);
+    double sx = 0, sy = 0;
+
+    for (auto& d : disk) {
+        int cx = ix + d.first;
+        int cy = iy + d.second;
+
+        if (cx < 0 || cy < 0 || cx >= nx || cy >= ny) continue;
+        if (stock[cy * nx + cx]) {
+           sx += d.first;
+           sy += d.second;
+           }
+        }
+    return gp_Vec2d(sx, sy);
+    }
+
+  void cut(const gp_Pnt2d& p) {
+    int ix = std::floor((p.X() - x0) / h);
+    int iy = std::floor((p.Y() - y0) / h);
+
+    for (auto& d : disk) {
+        int cx = ix + d.first;
+        int cy = iy + d.second;
+
+        if (cx < 0 || cy < 0 || cx >= nx || cy >= ny) continue;
+        stock[cy * nx + cx]  = 0;
+        target[cy * nx + cx] = 0;
+        }
+    }
+
+  // set cells closer than dist to polyline
+  void markBand(const Polyline2d& pl, bool closed, double dist, std::vector<uint8_t>& mask, uint8_t value) {
+    int mx = pl.size();
+
+    for (int i=0; i < mx; ++i) {
+        if (i + 1 == mx && !closed) break;
+        const gp_Pnt2d& a   = pl[i];
+        const gp_Pnt2d& b   = pl[(i + 1) % mx];
+        int             ix0 = std::max(0,      (int)std::floor((std::min(a.X(), b.X()) - dist - x0) / h));
+        int             ix1 = std::min(nx - 1, (int)std::floor((std::max(a.X(), b.X()) + dist - x0) / h));
+        int             iy0 = std::max(0,      (int)std::floor((std::min(a.Y(), b.Y()) - dist - y0) / h));
+        int             iy1 = std::min(ny - 1, (int)std::floor((std::max(a.Y(), b.Y()) + dist - y0) / h));
+
+        for (int iy=iy0; iy <= iy1; ++iy)
+            for (int ix=ix0; ix <= ix1; ++ix)
+                if (distToSegment(center(ix, iy), a, b) <= dist) mask[iy * nx + ix] = value;
+        }
+    }
+
+  // set cells inside (even-odd) of closed polyline
+  void markInside(const Polyline2d& pl, std::vector<uint8_t>& mask, uint8_t value) {
+    int               mx = pl.size();
+    std::vector<double> xs;
+
+    for (int iy=0; iy < ny; ++iy) {
+        double y = y0 + (iy + 0.5) * h;
+
+        xs.clear();
+        for (int i=0; i < mx; ++i) {
+            const gp_Pnt2d& a = pl[i];
+            const gp_Pnt2d& b = pl[(i + 1) % mx];
+
+            if ((a.Y() > y) == (b.Y() > y)) continue;
+            xs.push_back(a.X() + (y - a.Y()) / (b.Y() - a.Y()) * (b.X() - a.X()));
+            }
+        std::sort(xs.begin(), xs.end());
+        for (size_t i=0; i + 1 < xs.size(); i += 2) {
+            int ix0 = std::max(0,      (int)std::ceil((xs[i] - x0) / h - 0.5));
+            int ix1 = std::min(nx - 1, (int)std::floor((xs[i + 1] - x0) / h - 0.5));
+
+            for (int ix=ix0; ix <= ix1; ++ix) mask[iy * nx + ix] = value;
+            }
+        }
+    }
+
+  double                           x0;
+  double                           y0;
+  double                           h;
+  int                              nx;
+  int                              ny;
+  std::vector<uint8_t>             stock;
+  std::vector<uint8_t>             target;
+  std::vector<uint8_t>             allowed;
+  std::vector<std::pair<int, int>> disk;
+  };
+
+
+// everything one region needs - filled on main thread,
+// processed in parallel.
+struct RegionJob {
+  std::vector<Polyline2d>               contours;
+  double                                toolRadius;
+  double                                cutWidth;
+  double                                minLoad;
+  double                                firstOffset;
+  bool                                  climb;
+  bool                                  outside;
+  const Polyline2d*                     part;
+  bool                                  partClosed;
+  double                                sx0, sy0, sx1, sy1;      // stock
+  GOPocket*                             pocket;
+  double                                z;                       // level
+  std::vector<AdaptivePathBuilder::Pass> passes;
+  int                                   overloads = 0;
+  };
+
+
+void clearRegion(RegionJob& job) {
+  TraceSpan span("AdaptivePathBuilder::clearRegion");
+  double r    = job.toolRadius;
+  double h    = std::max(r / 8, 0.05);
+  double x0   = 1e99, y0 = 1e99, x1 = -1e99, y1 = -1e99;
+  double band = job.cutWidth / 2 + h;
+
+  for (auto& c : job.contours)
+      for (auto& p : c) {
+          x0 = std::min(x0, p.X()); y0 = std::min(y0, p.Y());
+          x1 = std::max(x1, p.X()); y1 = std::max(y1, p.Y());
+          }
+  if (x0 > x1) return;
+  x0 -= r + band; y0 -= r + band;
+  x1 += r + band; y1 += r + band;
+  // limit raster size to ~1M cells
+  while ((x1 - x0) / h * (y1 - y0) / h > 1e6) h *= 1.5;
+  EngagementGrid g(x0, y0, x1, y1, h, r);
+  int            nCells = g.nx * g.ny;
+  std::vector<uint8_t> partZone(nCells, 0);   // tool center not allowed
+  std::vector<uint8_t> keepZone(nCells, 0);   // allowance for finishing
+
+  // stock: inside stock box, but not part or finishing allowance
+  for (int iy=0; iy < g.ny; ++iy)
+      for (int ix=0; ix < g.nx; ++ix) {
+          gp_Pnt2d c = g.center(ix, iy);
+
+          if (c.X() >= job.sx0 && c.X() <= job.sx1 && c.Y() >= job.sy0 && c.Y() <= job.sy1)
+             g.stock[iy * g.nx + ix] = 1;
+          }
+  if (job.part && job.part->size() > 1) {
+     g.markBand(*job.part, job.partClosed, job.firstOffset + h, partZone, 1);
+     g.markBand(*job.part, job.partClosed, std::max(0.0, job.firstOffset - r), keepZone, 1);
+     if (job.partClosed) {
+        if (job.outside) {
+           g.markInside(*job.part, partZone, 1);
+           g.markInside(*job.part, keepZone, 1);
+           }
+        else {                            // part is outside of contour
+           std::vector<uint8_t> in(nCells, 0);
+
+           g.markInside(*job.part, in, 1);
+           for (int i=0; i < nCells; ++i)
+               if (!in[i]) partZone[i] = keepZone[i] = 1;
+           }
+        }
+     }
+  for (auto& c : job.contours) {
+      g.markBand(c, false, r,    g.target,  1);
+      g.markBand(c, false, band, g.allowed, 1);
+      }
+  for (int i=0; i < nCells; ++i) {
+      if (keepZone[i]) g.stock[i] = 0;
+      if (!g.stock[i]) g.target[i] = 0;
+      if (partZone[i]) g.allowed[i] = 0;
+      }
+
+  const double step     = 2 * h;
+  const double aeMax    = job.cutWidth;
+  const double aeMin    = job.cutWidth * job.minLoad;
+  const double side     = job.climb ? 1 : -1;    // 1: stock right of tool
+  const int    nDir     = 36;
+  const int    stride   = std::max(1, (int)(r / (2 * h)));
+  const int    maxIdle  = std::max(4, (int)(2 * r / step));
+  int          maxSteps = 4 * nCells;
+  gp_Pnt2d     last     = g.center(0, 0);
+  bool         first    = true;
+
+  for (;;) {
+      // start of next pass: near last position, preferably at edge of stock
+      double   bestScore = 1e99;
+      gp_Pnt2d start;
+
+      for (int iy=0; iy < g.ny; iy += stride) {
+          for (int ix=0; ix < g.nx; ix += stride) {
+              if (!g.allowed[iy * g.nx + ix]) continue;
+              gp_Pnt2d p = g.center(ix, iy);
+
+              if (!g.load(p, g.target)) continue;
+              double frac  = (double)g.load(p, g.stock) / g.diskSize();
+              double score = p.Distance(last) / r + (frac > 0.5 ? 1000 : 0) + 10 * frac;
+
+              if (score < bestScore) {
+                 bestScore = score;
+                 start     = p;
+                 }
+              }
+          }
+      if (bestScore > 1e98) break;              // nothing reachable left
+      AdaptivePathBuilder::Pass pass;
+
+      // keep down, if the way to start runs through cleared area only
+      if (!first) {
+         double len = last.Distance(start);
+         int    n   = std::max(1, (int)(len / h));
+
+         pass.keepDown = len < 4 * r;
+         for (int i=1; pass.keepDown && i < n; ++i) {
+             gp_Pnt2d p(last.X() + (start.X() - last.X()) * i / n
+                      , last.Y() + (start.Y() - last.Y()) * i / n);
+
+             if (!g.isAllowed(p) || g.load(p, g.stock)) pass.keepDown = false;
+             }
+         }
+      first = false;
+      gp_Vec2d sd  = g.stockDir(start);
+      gp_Vec2d dir = sd.Magnitude() > 0 ? sd.Rotated(side * M_PI / 2).Normalized() : gp_Vec2d(1, 0);
+      gp_Pnt2d pos = start;
+      int      idle = 0;
+
+      g.cut(pos);
+      pass.points.push_back(pos);
+      while (--maxSteps > 0) {
+            double   minW = 1e99;
+            gp_Pnt2d minQ;
+            gp_Vec2d minD;
+            bool     found = false;
+
+            // sweep from turning into stock to turning away from it
+            for (int k=0; k <= nDir; ++k) {
+                gp_Vec2d d = dir.Rotated(-side * (M_PI / 2 - k * M_PI / nDir));
+                gp_Pnt2d q = pos.Translated(d * step);
+
+                if (!g.isAllowed(q)) continue;
+                double w = g.load(q, g.stock) * h * h / step;
+
+                if (w <= aeMax) {
+                   minW  = w;
+                   minQ  = q;
+                   minD  = d;
+                   found = true;
+                   break;
+                   }
+                if (w < minW) {
+                   minW = w;
+                   minQ = q;
+                   minD = d;
+                   }
+                }
+            if (minW > 1e98) break;             // no allowed direction
+            if (!found) ++job.overloads;
+            if (minW < aeMin) {                  // underloaded - cutting air
+               if (++idle > maxIdle || !g.load(pos, g.target)) break;
+               }
+            else idle = 0;
+            pos = minQ;
+            dir = minD;
+            g.cut(pos);
+            pass.points.push_back(pos);
+            }
+      // strip idle moves at end of pass
+      while (idle-- > 0 && pass.points.size() > 1) pass.points.pop_back();
+      last = pass.points.back();
+      if (pass.points.size() > 1) job.passes.push_back(pass);
+      if (maxSteps <= 0) {
+         qCWarning(lcPath) << "adaptive clearing: step limit reached";
+         break;
+         }
+      }
+
+  // drop points that deviate less than half a cell from a line
+  for (auto& pass : job.passes) {
+      Polyline2d res;
+      int        mx = pass.points.size();
+
+      res.push_back(pass.points.front());
+      for (int i=1; i < mx - 1; ++i) {
+          if (distToSegment(pass.points[i], res.back(), pass.points[i + 1]) < h / 2) continue;
+          res.push_back(pass.points[i]);
+          }
+      res.push_back(pass.points.back());
+      pass.points.swap(res);
+      }
+  }
+}
+
+
+AdaptivePathBuilder::AdaptivePathBuilder(PathBuilderUtil* pbu)
+ : pbu(pbu) {
+  }
+
+
+std::vector<Workstep*> AdaptivePathBuilder::genPath(Operation* op, const Bnd_Box& bb, GOContour* partContour, double firstOffset, const std::vector<std::vector<GOPocket*>>& pool, const std::vector<double>& levelZ) {
+  TraceSpan              span("AdaptivePathBuilder::genPath");
+  std::vector<Workstep*> toolPath;
+  std::vector<RegionJob> jobs;
+  ToolEntry*             tool   = op->toolEntry();
+  double                 safeZ  = bb.CornerMax().Z() + op->safeZ1();
+  double                 defl   = std::max(0.01, tool->fluteDiameter() / 100);
+  double                 topZ   = levelZ.size() ? levelZ.front() : bb.CornerMax().Z();
+  Polyline2d             part   = partContour ? toPolyline(partContour, topZ, defl) : Polyline2d();
+  bool                   closed = partContour && partContour->isClosed();
+
+  for (size_t l=0; l < pool.size() && l < levelZ.size(); ++l) {
+      double z = levelZ[l];
+
+      for (GOPocket* p : pool[l]) {
+          RegionJob job;
+
+          for (GOContour* c : p->contours()) {
+              Polyline2d pl = toPolyline(c, z, defl);
+
+              if (pl.size() > 1) job.contours.push_back(pl);
+              }
+          if (job.contours.empty()) continue;
+          job.toolRadius  = tool->fluteDiameter() / 2;
+          job.cutWidth    = op->cutWidth();
+          job.minLoad     = Core().adaptiveMinLoad();
+          job.firstOffset = firstOffset;
+          job.climb       = op->direction() != 1;     // 1 is against feed
+          job.outside     = op->isOutside();
+          job.part        = &part;
+          job.partClosed  = closed;
+          job.sx0         = bb.CornerMin().X();
+          job.sy0         = bb.CornerMin().Y();
+          job.sx1         = bb.CornerMax().X();
+          job.sy1         = bb.CornerMax().Y();
+          job.pocket      = p;
+          job.z           = z;
+          jobs.push_back(job);
+          }
+      }
+  OSD_Parallel::For(0, jobs.size(), [&jobs](int i) { clearRegion(jobs[i]); });
+
+  // assemble toolpath in order of levels and pockets
+  gp_Pnt e(0, 0, safeZ);
+  int    overloads = 0;
+
+  for (RegionJob& job : jobs) {
+      GOPocket* p    = job.pocket;
+      double    lz   = job.z;
+      double    rz   = std::min(safeZ, lz + op->cutDepth());   // level above is cleared
+      double    leg  = tool->fluteDiameter();
+
+      overloads += job.overloads;
+      for (auto& pass : job.passes) {
+          gp_Pnt s(pass.points.front().X(), pass.points.front().Y(), lz);
+
+          if (pass.keepDown) toolPath.push_back(new WSStraightMove(e, s));
+          else {
+             gp_Pnt up(e.X(), e.Y(), safeZ);
+             gp_Pnt over(s.X(), s.Y(), safeZ);
+             gp_Pnt ramp(s.X(), s.Y(), rz);
+
+             if (!kute::isEqual(e, up))      toolPath.push_back(new WSTraverse(e, up));
+             if (!kute::isEqual(up, over))   toolPath.push_back(new WSTraverse(up, over));
+             if (!kute::isEqual(over, ramp)) toolPath.push_back(new WSTraverse(over, ramp));
+             rampDown(toolPath, pass.points, rz, lz, leg);
+             }
+          e = s;
+          for (size_t i=1; i < pass.points.size(); ++i) {
+              gp_Pnt nxt(pass.points[i].X(), pass.points[i].Y(), lz);
+
+              toolPath.push_back(new WSStraightMove(e, nxt));
+              e = nxt;
+              }
+          }
+      // finish the wall like the pocket builder does. Contours of
+      // the pocket are shared with the caller, so work on a copy
+      GOContour* src  = wallContour(p, op->isOutside());
+      GOContour* wall = src ? GOContour::fromBinary(src->toBinary()) : nullptr;
+
+      if (wall) {
+         if (wall->isClosed()) wall->changeStart2Close(e);
+         wall->simplify(lz);
+         gp_Pnt     s  = wall->startPoint();
+         Polyline2d wp = toPolyline(wall, rz, defl);
+         gp_Pnt     up(e.X(), e.Y(), safeZ);
+         gp_Pnt     over(s.X(), s.Y(), safeZ);
+         gp_Pnt     ramp(s.X(), s.Y(), rz);
+
+         if (!kute::isEqual(e, up))      toolPath.push_back(new WSTraverse(e, up));
+         if (!kute::isEqual(up, over))   toolPath.push_back(new WSTraverse(up, over));
+         if (!kute::isEqual(over, ramp)) toolPath.push_back(new WSTraverse(over, ramp));
+         if (wp.size() > 1) rampDown(toolPath, wp, rz, lz, leg);
+         else               toolPath.push_back(new WSStraightMove(ramp, s));
+         e = pbu->processContour(toolPath, wall);
+         for (GraphicObject* go : wall->segments()) delete go;
+         delete wall;
+         }
+      gp_Pnt up(e.X(), e.Y(), safeZ);
+
+      if (!kute::isEqual(e, up)) toolPath.push_back(new WSTraverse(e, up));
+      e = up;
+      }
+  pbu->cleanup(toolPath);
+  qCDebug(lcPath) << "adaptive clearing:" << jobs.size() << "regions,"
+                  << toolPath.size() << "moves," << overloads << "overloaded steps";
+
+  return toolPath;
+  }
+
+
+// innermost contour (next to part) of a pocket
+GOContour* AdaptivePathBuilder::wallContour(GOPocket* p, bool outside) const {
+  GOContour* rv   = nullptr;
+  double     best = 0;
+  gp_Pnt     c    = p->midPoint();
+
+  for (GOContour* gc : p->contours()) {
+      double d = gc->midPoint().Distance(c);
+
+      if (!rv || (outside ? d < best : d > best)) {
+         rv   = gc;
+         best = d;
+         }
+      }
+  return rv;
+  }
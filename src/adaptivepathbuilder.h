@@ -0,0 +1,64 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       adaptivepathbuilder.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef ADAPTIVEPATHBUILDER_H
+#define ADAPTIVEPATHBUILDER_H
+#include <gp_Pnt2d.hxx>
+#include <vector>
+class Bnd_Box;
+class GOContour;
+class GOPocket;
+class Operation;
+class PathBuilderUtil;
+class Workstep;
+
+
+// clears pocket regions with constant radial engagement. Each region
+// (pocket of one level) gets rasterized and the tool follows the
+// boundary of remaining stock, so that the material removed per step
+// stays between minimum load and cut width of the operation. Regions
+// are independent and processed in parallel. At last the wall of each
+// region gets cut along the innermost pocket contour. Levels are
+// entered by a ramp, levelZ holds the Z of each level of the pool.
+class AdaptivePathBuilder
+{
+public:
+  AdaptivePathBuilder(PathBuilderUtil* pbu);
+
+  std::vector<Workstep*> genPath(Operation* op, const Bnd_Box& bb, GOContour* partContour, double firstOffset, const std::vector<std::vector<GOPocket*>>& pool, const std::vector<double>& levelZ);
+
+  struct Pass {
+    std::vector<gp_Pnt2d> points;
+    bool                  keepDown = false;   // feed from end of previous pass
+    };
+
+protected:
+  GOContour* wallContour(GOPocket* p, bool outside) const;
+
+private:
+  PathBuilderUtil* pbu;
+  };
+#endif // ADAPTIVEPATHBUILDER_H
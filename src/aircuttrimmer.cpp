@@ -0,0 +1,136 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       aircuttrimmer.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "aircuttrimmer.h"
+#include "kuteCAM.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include "workstep.h"
+#include "wsstraightmove.h"
+#include "wstraverse.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+
+AirCutTrimmer::AirCutTrimmer(const StockModel& stock, const ToolEntry* tool, double feed, double safeDist, double rapidFeed)
+ : stock(stock)
+ , lift(0)
+ , feed(feed)
+ , safeDist(safeDist)
+ , rapidFeed(rapidFeed)
+ , valid(false) {
+  valid = feed > 0 && rapidFeed > 0 && StockModel::cutterOf(tool, cutter, lift);
+  }
+
+
+// rapid moves from - to, that don't touch the stock. The cutter stays
+// down, if the direct way at the higher of both ends is free, otherwise
+// it lifts above the highest stock between. Vertical moves are free,
+// as both ends belong to moves without contact and the stock model has
+// no overhangs. Returns the time of the link in seconds.
+double AirCutTrimmer::genLink(std::vector<Workstep*>& link, const gp_Pnt& from, const gp_Pnt& to) const {
+  if (kute::isEqual(from, to)) return 0;
+  double zLink = std::max(from.Z(), to.Z());
+  gp_Pnt a(from.X(), from.Y(), zLink + lift);
+  gp_Pnt b(to.X(),   to.Y(),   zLink + lift);
+
+  if (stock.removesMaterial(a, b, cutter))
+     zLink = std::max(zLink, stock.maxTop(from, to, cutter.radius) - lift + safeDist);
+  gp_Pnt p0(from.X(), from.Y(), zLink);
+  gp_Pnt p1(to.X(),   to.Y(),   zLink);
+  double len = 0;
+
+  for (const gp_Pnt& p : {p0, p1, to}) {
+      const gp_Pnt& last = link.size() ? link.back()->endPos() : from;
+
+      if (kute::isEqual(last, p)) continue;
+      len += last.Distance(p);
+      link.push_back(new WSTraverse(last, p));
+      }
+  return len / rapidFeed * 60;
+  }
+
+
+bool AirCutTrimmer::isFeedMove(const Workstep* ws) const {
+  return ws->type() == WTStraightMove || ws->type() == WTArc;
+  }
+
+
+double AirCutTrimmer::length(const Workstep* ws) const {
+  std::vector<gp_Pnt> pl = stock.polylineOf(ws, 0);
+  double              rv = 0;
+
+  for (int i=1; i < (int)pl.size(); ++i) rv += pl[i - 1].Distance(pl[i]);
+
+  return rv;
+  }
+
+
+AirCutTrimmer::Result AirCutTrimmer::trim(std::vector<Workstep*>& path) {
+  TraceSpan              span("AirCutTrimmer::trim");
+  Result                 rv;
+  std::vector<Workstep*> out;
+  int                    mx = path.size();
+
+  if (!valid) return rv;
+  out.reserve(mx);
+  for (int i=0; i < mx; ) {
+      Workstep* ws = path[i];
+
+      if (!isFeedMove(ws) || stock.removesMaterial(ws, cutter, lift)) {
+         stock.apply(ws, cutter, lift);
+         out.push_back(ws);
+         ++i;
+         continue;
+         }
+      int    j   = i;
+      double len = 0;
+
+      while (j < mx && isFeedMove(path[j]) && !stock.removesMaterial(path[j], cutter, lift))
+            len += length(path[j++]);
+      std::vector<Workstep*> link;
+      double                 feedTime = len / feed * 60;
+      double                 linkTime = genLink(link, path[i]->startPos(), path[j - 1]->endPos());
+
+      if (linkTime < feedTime) {
+         for (int k=i; k < j; ++k) delete path[k];
+         out.insert(out.end(), link.begin(), link.end());
+         ++rv.runs;
+         rv.moves     += j - i;
+         rv.airLength += len;
+         rv.savedTime += feedTime - linkTime;
+         }
+      else {
+         for (Workstep* l : link) delete l;
+         out.insert(out.end(), path.begin() + i, path.begin() + j);
+         }
+      i = j;
+      }
+  path.swap(out);
+
+  return rv;
+  }
@@ -0,0 +1,67 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       aircuttrimmer.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef AIRCUTTRIMMER_H
+#define AIRCUTTRIMMER_H
+#include "stockmodel.h"
+#include <vector>
+class ToolEntry;
+class Workstep;
+
+
+// replaces runs of feed moves, that don't touch the stock, by rapid
+// links. The stock gets updated by every move that is kept, so moves
+// that follow already machined area are recognized too. Runs are only
+// replaced, if the link is faster than feeding through air.
+class AirCutTrimmer
+{
+public:
+  struct Result {
+    int    runs      = 0;   // replaced runs of feed moves
+    int    moves     = 0;   // feed moves removed
+    double airLength = 0;   // mm
+    double savedTime = 0;   // seconds
+    };
+  AirCutTrimmer(const StockModel& stock, const ToolEntry* tool, double feed, double safeDist, double rapidFeed);
+
+  bool   isValid() const { return valid; }
+  Result trim(std::vector<Workstep*>& path);
+
+protected:
+  double genLink(std::vector<Workstep*>& link, const gp_Pnt& from, const gp_Pnt& to) const;
+  bool   isFeedMove(const Workstep* ws) const;
+  double length(const Workstep* ws) const;
+
+private:
+  StockModel  stock;
+  CutterShape cutter;
+  double      lift;
+  double      feed;
+  double      safeDist;
+  double      rapidFeed;
+  bool        valid;
+  };
+#endif // AIRCUTTRIMMER_H
@@ -0,0 +1,79 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       benchmain.cpp
+ *  project:    kuteCAM
+ *  subproject: benchmark
+ *  purpose:    time the expensive parts of toolpath creation without
+ *              a display, so regressions between releases show up
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "core.h"
+#include "testrunner.h"
+#include <QApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QFile>
+#include <QDebug>
+
+
+// runs without display: Qt uses the offscreen platform, unless
+// the caller asked for something else.
+int main(int argc, char *argv[]) {
+  int rv = -1;
+
+  if (qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM")) qputenv("QT_QPA_PLATFORM", "offscreen");
+  try {
+      QApplication       a(argc, argv); a.setApplicationName("kutecam_bench");
+      Core               core(a);
+      QCommandLineParser parser;
+      QCommandLineOption optRepeat(QStringList() << "r" << "repeat", "number of runs per stage", "count", "3");
+      QCommandLineOption optOutput(QStringList() << "o" << "output", "write results to file (default: stdout)", "file");
+      QCommandLineOption optBaseline(QStringList() << "b" << "baseline", "compare toolpath metrics against baseline (default: sampleDir/bench-baseline.json)", "file");
+      QCommandLineOption optUpdate(QStringList() << "u" << "update-baseline", "write toolpath metrics as new baseline", "file");
+
+      parser.setApplicationDescription("times toolpath creation on the sample models and writes the results as json");
+      parser.addHelpOption();
+      parser.addOption(optRepeat);
+      parser.addOption(optOutput);
+      parser.addOption(optBaseline);
+      parser.addOption(optUpdate);
+      parser.addPositionalArgument("sampleDir", "directory with sample models and Tools.xml");
+      parser.process(a);
+      QString    sampleDir = parser.positionalArguments().size() ? parser.positionalArguments().at(0) : "sample";
+      QString    baseline  = parser.isSet(optBaseline) ? parser.value(optBaseline)
+                                                       : QDir(sampleDir).filePath("bench-baseline.json");
+      TestRunner tr(sampleDir, parser.value(optRepeat).toInt());
+      bool       ok        = tr.run();
+      bool       check     = parser.isSet(optBaseline) || (!parser.isSet(optUpdate) && QFile::exists(baseline));
+      bool       regressed = check && !tr.checkBaseline(baseline);
+
+      if (parser.isSet(optUpdate) && !tr.writeBaseline(parser.value(optUpdate)))
+         qDebug() << "failed to write baseline!";
+      if (!tr.write(parser.value(optOutput))) qDebug() << "failed to write results!";
+      else rv = regressed ? 2 : ok ? 0 : 1;
+      }
+  catch (const QString& s) {
+      qDebug() << s;
+      }
+  catch (const std::exception& e) {
+      qDebug() << e.what();
+      }
+  return rv;
+  }
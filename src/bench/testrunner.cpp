@@ -0,0 +1,644 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       testrunner.cpp
+ *  project:    kuteCAM
+ *  subproject: benchmark
+ *  purpose:    time the expensive parts of toolpath creation without
+ *              a display, so regressions between releases show up
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "testrunner.h"
+#include "booleanengine.h"
+#include "contourtargetdefinition.h"
+#include "core.h"
+#include "dinpostprocessor.h"
+#include "drilltargetdefinition.h"
+#include "gcodewriter.h"
+#include "gocircle.h"
+#include "gocontour.h"
+#include "kuteCAM.h"
+#include "notchtargetdefinition.h"
+#include "operation.h"
+#include "pathbuilder.h"
+#include "pathbuilderutil.h"
+#include "projectfile.h"
+#include "selectionhandler.h"
+#include "specpostprocessor.h"
+#include "toolentry.h"
+#include "toollistmodel.h"
+#include "toolpathmetrics.h"
+#include "util3d.h"
+#include "work.h"
+#include "workstep.h"
+#include "wscycle.h"
+#include "xmltoolreader.h"
+#include <BRepAdaptor_Surface.hxx>
+#include <BRepBndLib.hxx>
+#include <BRepPrimAPI_MakeBox.hxx>
+#include <BRepPrimAPI_MakeCylinder.hxx>
+#include <Geom_Circle.hxx>
+#include <Standard_Failure.hxx>
+#include <Standard_Version.hxx>
+#include <QDateTime>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+#include <QDebug>
+#include <algorithm>
+#include <stdexcept>
+
+
+const int TestRunner::MillTool  = 4;   // 12mm HPC endmill from sample/Tools.xml
+const int TestRunner::DrillTool = 5;   // 6,8mm drill
+
+
+TestRunner::TestRunner(const QString& sampleDir, int repeats)
+ : sampleDir(sampleDir)
+ , repeats(std::max(1, repeats))
+ , pbu(new PathBuilderUtil())
+ , pb(new PathBuilder(pbu))
+ , pf(nullptr)
+ , contourOP(new Operation(1, ContourOperation))
+ , drillOP(new Operation(2, DrillOperation))
+ , notchOP(new Operation(3, NotchOperation))
+ , sweepOP(new Operation(4, SweepOperation))
+ , radius(0)
+ , holeRadius(0) {
+  contourOP->setName("bench contour");
+  drillOP->setName("bench drill");
+  notchOP->setName("bench notch");
+  sweepOP->setName("bench sweep");
+  }
+
+
+TestRunner::~TestRunner() {
+  clearPath(pocketPath);
+  clearPath(roundPath);
+  for (Operation* op : { contourOP, drillOP, notchOP, sweepOP }) {
+      clearWorkSteps(op);
+      delete op;
+      }
+  delete pb;
+  delete pbu;
+  if (pf) Core().setProjectFile(nullptr);
+  delete pf;
+  }
+
+
+// each stage of the bench run is allowed to fail, so the baseline
+// check has to be robust against missing operations and metrics.
+// A baseline without metrics is no reference - that fails the check,
+// the baseline gets written by update (-u) only.
+bool TestRunner::checkBaseline(const QString& fileName) {
+  QFile file(fileName);
+
+  failed.clear();
+  if (!file.open(QIODevice::ReadOnly)) {
+     failed << QString("can not read baseline %1").arg(fileName);
+     return false;
+     }
+  QJsonObject base       = QJsonDocument::fromJson(file.readAll()).object();
+  QJsonObject tolerances = base.value("tolerances").toObject();
+  QJsonObject baseOPs    = base.value("metrics").toObject();
+
+  file.close();
+  if (baseOPs.isEmpty()) {
+     failed << QString("baseline %1 has no metrics - create it with --update-baseline").arg(fileName);
+     qDebug() << "bench:" << failed.last();
+     return false;
+     }
+  for (auto it = baseOPs.constBegin(); it != baseOPs.constEnd(); ++it) {
+      if (!metrics.contains(it.key())) {
+         failed << QString("%1: no toolpath generated").arg(it.key());
+         continue;
+         }
+      ToolpathMetrics cur  = ToolpathMetrics::fromJson(metrics.value(it.key()).toObject());
+      ToolpathMetrics prev = ToolpathMetrics::fromJson(it.value().toObject());
+
+      for (const QString& msg : cur.compare(prev, tolerances))
+          failed << QString("%1 - %2").arg(it.key(), msg);
+      }
+  for (const QString& msg : failed) qDebug() << "bench: REGRESSION" << msg;
+
+  return failed.isEmpty();
+  }
+
+
+void TestRunner::clearPath(std::vector<Workstep*>& path) {
+  for (Workstep* ws : path) delete ws;
+  path.clear();
+  }
+
+
+void TestRunner::clearWorkSteps(Operation* op) {
+  clearPath(op->workSteps());
+  }
+
+
+// feed moves above the stock top count as air cuts
+void TestRunner::collectMetrics() {
+  double stockTop = wpBounds.CornerMax().Z();
+
+  metrics = QJsonObject();
+  if (contourOP->workSteps().size()) metrics["contour"] = ToolpathMetrics::measure(contourOP, stockTop).toJson();
+  if (sweepOP->workSteps().size())   metrics["sweep"]   = ToolpathMetrics::measure(sweepOP, stockTop).toJson();
+  if (notchOP->workSteps().size())   metrics["notch"]   = ToolpathMetrics::measure(notchOP, stockTop).toJson();
+  if (drillOP->workSteps().size())   metrics["drill"]   = ToolpathMetrics::measure(drillOP, stockTop).toJson();
+  // pocket and round paths belong to the contour operation
+  double feed = ToolpathMetrics::feedOf(contourOP);
+
+  if (pocketPath.size()) metrics["pocket"] = ToolpathMetrics::measure(pocketPath, feed, stockTop).toJson();
+  if (roundPath.size())  metrics["round"]  = ToolpathMetrics::measure(roundPath, feed, stockTop).toJson();
+  }
+
+
+int TestRunner::createContourCutPart() {
+  gp_Pnt       pos = center;
+  TopoDS_Shape cf;
+
+  pos.SetZ(-500);
+  cf = BRepPrimAPI_MakeCylinder(gp_Ax2(pos, {0, 0, 1}), radius, 1000);
+  contourOP->cutPart = Core().selectionHandler()->createCutPart(workPiece, cf, contourOP, contourOP->isOutside());
+  if (contourOP->cutPart.IsNull()) throw std::domain_error("failed to create cut part for contour");
+
+  return Core().helper3D()->allFacesWithin(contourOP->cutPart->Shape()).size();
+  }
+
+
+int TestRunner::createGCode() {
+  DINPostProcessor    pp;
+  GCodeWriter         gcw(&pp);
+  QTemporaryDir       dir;
+  QString             fileName = dir.filePath(QString("bench.%1").arg(pp.getFileExtension()));
+  QVector<Operation*> ops { sweepOP, contourOP, notchOP, drillOP };
+
+  if (gcw.processAllInOne(fileName, wpBounds, ops) < 0)
+     throw std::domain_error("failed to write gcode file");
+  QFile file(fileName);
+  int   lines = 0;
+
+  if (!file.open(QIODevice::ReadOnly | QIODevice::Text))
+     throw std::domain_error("gcode file not written");
+  while (!file.atEnd()) {
+        file.readLine();
+        ++lines;
+        }
+  return lines;
+  }
+
+
+int TestRunner::createNotchCutPart() {
+  NotchTargetDefinition* ntd = dynamic_cast<NotchTargetDefinition*>(notchOP->targets.at(0));
+  gp_Pnt                 p0(wpBounds.CornerMin().X(), ntd->borderPoint(0).Y(), notchOP->lowerZ());
+  gp_Pnt                 p1(wpBounds.CornerMax().X(), ntd->borderPoint(2).Y(), wpBounds.CornerMax().Z());
+  TopoDS_Shape           box = BRepPrimAPI_MakeBox(p0, p1);
+  TopoDS_Shape           cp  = Core().booleanEngine()->common(workPiece->Shape(), box);
+
+  if (cp.IsNull()) throw std::domain_error("failed to create cut part for notch");
+  notchOP->cutPart = new AIS_Shape(cp);
+
+  return Core().helper3D()->allFacesWithin(cp).size();
+  }
+
+
+// levels from top (exclusive) down to bottom (inclusive)
+std::vector<Handle(AIS_Shape)> TestRunner::cutPlanes(const TopoDS_Shape& shape, double top, double bottom, double step) {
+  std::vector<Handle(AIS_Shape)> rv;
+  std::vector<double>            levels;
+
+  for (double z = top - step; z > bottom + kute::MinDelta; z -= step)
+      levels.push_back(z);
+  levels.push_back(bottom);
+  for (auto& s : Core().helper3D()->sections(shape, levels))
+      rv.push_back(new AIS_Shape(s));
+
+  return rv;
+  }
+
+
+int TestRunner::genDrillSequence() {
+  clearWorkSteps(drillOP);
+  for (TargetDefinition* td : drillOP->targets) delete td;
+  drillOP->targets.clear();
+
+  for (const gp_Pnt& h : holes)
+      drillOP->targets.push_back(new DrillTargetDefinition(gp_Pnt(h.X(), h.Y(), drillOP->upperZ())
+                                                         , gp_Dir(0, 0, 1)
+                                                         , holeRadius));
+  std::sort(drillOP->targets.begin(), drillOP->targets.end(), TargetDefinition::compareASC);
+  for (TargetDefinition* td : drillOP->targets) {
+      gp_Pnt from(td->pos().X(), td->pos().Y(), drillOP->upperZ());
+      gp_Pnt to(td->pos().X(), td->pos().Y(), drillOP->drillDepth());
+
+      drillOP->workSteps().push_back(new WSCycle(drillOP->drillCycle(), from, to));
+      }
+  return drillOP->workSteps().size();
+  }
+
+
+int TestRunner::genNotchPath() {
+  if (notchOP->cutPart.IsNull()) throw std::logic_error("notch operation has no cut part");
+  clearWorkSteps(notchOP);
+  std::vector<Handle(AIS_Shape)> planes = cutPlanes(notchOP->cutPart->Shape()
+                                                  , notchOP->topZ()
+                                                  , notchOP->lowerZ()
+                                                  , notchOP->cutDepth());
+
+  notchOP->workSteps() = pb->genNotchPath(notchOP, notchOP->cutPart, planes);
+
+  return notchOP->workSteps().size();
+  }
+
+
+int TestRunner::genPocketPath() {
+  if (contourOP->cutPart.IsNull()) throw std::logic_error("contour operation has no cut part");
+  clearPath(pocketPath);
+  pocketPath = pb->genToolPath(contourOP, contourOP->cutPart, true);
+
+  return pocketPath.size();
+  }
+
+
+int TestRunner::genRoundPath() {
+  if (contourOP->cutPart.IsNull()) throw std::logic_error("contour operation has no cut part");
+  std::vector<Handle(AIS_Shape)> planes = cutPlanes(contourOP->cutPart->Shape()
+                                                  , contourOP->topZ()
+                                                  , contourOP->finalDepth()
+                                                  , contourOP->cutDepth());
+
+  clearPath(roundPath);
+  roundPath = pb->genRoundToolpaths(contourOP, planes);
+
+  return roundPath.size();
+  }
+
+
+int TestRunner::genSweepPath() {
+  clearWorkSteps(sweepOP);
+  std::vector<Handle(AIS_Shape)> planes = cutPlanes(workPiece->Shape()
+                                                  , sweepOP->topZ()
+                                                  , sweepOP->finalDepth()
+                                                  , sweepOP->cutDepth());
+
+  pb->createHorizontalToolpaths(sweepOP, planes);
+
+  return sweepOP->workSteps().size();
+  }
+
+
+int TestRunner::genToolPath() {
+  if (contourOP->cutPart.IsNull()) throw std::logic_error("contour operation has no cut part");
+  clearWorkSteps(contourOP);
+  contourOP->workSteps() = pb->genToolPath(contourOP, contourOP->cutPart, false);
+
+  return contourOP->workSteps().size();
+  }
+
+
+int TestRunner::loadModels() {
+  const QStringList names { "Niederzug-80-Body01.brep", "Niederzug-80-Body02.brep" };
+  QDir              dir(sampleDir);
+  int               faces = 0;
+
+  bodies.clear();
+  for (const QString& name : names) {
+      QString fileName = dir.filePath(name);
+
+      if (!QFile::exists(fileName))
+         throw std::domain_error(QString("missing sample file %1").arg(fileName).toStdString());
+      TopoDS_Shape s = Core().helper3D()->loadBRep(fileName);
+
+      if (s.IsNull())
+         throw std::domain_error(QString("failed to load %1").arg(fileName).toStdString());
+      faces += Core().helper3D()->allFacesWithin(s).size();
+      bodies.push_back(s);
+      }
+  return faces;
+  }
+
+
+int TestRunner::loadTools() {
+  QFile         file(QDir(sampleDir).filePath("Tools.xml"));
+  XmlToolReader xtr;
+
+  if (!file.exists()) throw std::domain_error("missing sample file Tools.xml");
+  QVector<ToolEntry*> tools = xtr.read(&file);
+
+  file.close();
+  Core().toolListModel()->setData(tools);
+
+  return tools.size();
+  }
+
+
+// writer passes feed 0 for moves, that keep the feed of the previous
+// move. Shipped spec must not turn that into "F0" - neither on moves
+// nor on drill cycles.
+int TestRunner::postSpecMoves() {
+  SpecPostProcessor pp;
+  QStringList       lines;
+
+  if (!pp.load(BENCH_PP_SPEC)) throw std::domain_error("failed to load postprocessor spec " BENCH_PP_SPEC);
+  pp.genJobIntro("bench");
+  pp.setLastPos(gp_Pnt(0, 0, 10));
+  lines << pp.genStraightMove(gp_Pnt(10, 0, 10), 1200)
+        << pp.genStraightMove(gp_Pnt(20, 0, 10), 0)
+        << pp.genStraightMove(gp_Pnt(20, 10, 10), 0)
+        << pp.genStraightMove(gp_Pnt(20, 10, 5), 800)
+        << pp.genDefineCycle(SpotDrillCycle, 5, 2, 2, -10, 0, 0, 0, 0, 0);
+  for (const QString& line : lines) {
+      if (line.split(' ', Qt::SkipEmptyParts).contains("F0"))
+         throw std::domain_error(QString("zero feed written: %1").arg(line).toStdString());
+      }
+  if (!lines.at(0).contains("F1200") || lines.at(1).contains('F') || !lines.at(3).contains("F800"))
+     throw std::domain_error(QString("unexpected feed output: %1").arg(lines.join(" | ")).toStdString());
+
+  return lines.size();
+  }
+
+
+bool TestRunner::measure(const QString& name, std::function<int()> stage) {
+  QElapsedTimer timer;
+  Result        r;
+  double        total = 0;
+
+  r.name   = name;
+  r.status = "ok";
+  for (int i=0; i < repeats; ++i) {
+      try {
+          timer.start();
+          r.count = stage();
+          double ms = timer.nsecsElapsed() / 1e6;
+
+          r.minMS = r.runs ? std::min(r.minMS, ms) : ms;
+          r.maxMS = std::max(r.maxMS, ms);
+          total  += ms;
+          ++r.runs;
+          }
+      catch (const Standard_Failure& e) {
+          r.status  = "failed";
+          r.message = e.GetMessageString();
+          break;
+          }
+      catch (const std::exception& e) {
+          r.status  = "failed";
+          r.message = e.what();
+          break;
+          }
+      }
+  if (r.runs) r.avgMS = total / r.runs;
+  qDebug() << "bench:" << name << r.status << "runs:" << r.runs << "count:" << r.count
+           << "min:" << r.minMS << "avg:" << r.avgMS << "max:" << r.maxMS << r.message;
+  res.push_back(r);
+
+  return r.status == "ok";
+  }
+
+
+// stages depend on each other. Failed stages are reported, but
+// only missing models or tools stop the run.
+bool TestRunner::run() {
+  bool ok = true;
+
+  res.clear();
+  Core().booleanEngine()->resetStats();
+  if (!measure("loadModel", [this]() { return loadModels(); })
+   || !measure("loadTools", [this]() { return loadTools(); })) return false;
+  setupWork();
+  ok &= measure("createCutPart",     [this]() { return createContourCutPart(); });
+  ok &= measure("genToolPath",       [this]() { return genToolPath(); });
+  ok &= measure("genPocketPath",     [this]() { return genPocketPath(); });
+  ok &= measure("genRoundToolpaths", [this]() { return genRoundPath(); });
+  ok &= measure("sweepPath",         [this]() { return genSweepPath(); });
+  ok &= measure("notchCutPart",      [this]() { return createNotchCutPart(); });
+  ok &= measure("notchPath",         [this]() { return genNotchPath(); });
+  ok &= measure("drillSequence",     [this]() { return genDrillSequence(); });
+  ok &= measure("gcodeWriter",       [this]() { return createGCode(); });
+  ok &= measure("specPostProcessor", [this]() { return postSpecMoves(); });
+  collectMetrics();
+
+  return ok;
+  }
+
+
+void TestRunner::setupOperation(Operation* op, int toolNum) {
+  ToolEntry* tool = Core().toolListModel()->tool(Core().toolListModel()->findToolNum(toolNum));
+
+  op->setToolNum(toolNum);
+  op->workPiece = workPiece;
+  op->wpBounds  = wpBounds;
+  op->mBounds   = mBounds;
+  op->setAbsolute(true);
+  op->setOutside(true);
+  op->setTopZ(wpBounds.CornerMax().Z());
+  op->setUpperZ(mBounds.CornerMax().Z());
+  op->setLowerZ(mBounds.CornerMin().Z());
+  op->setFinalDepth(std::max(mBounds.CornerMin().Z(), mBounds.CornerMax().Z() - 20));
+  op->setSafeZ0(2);
+  op->setSafeZ1(10);
+  op->setCutDepth(2);
+  op->setCutWidth(tool->fluteDiameter() * 0.4);
+  op->setOffset(0.2);
+  op->setSpeed(3000);
+  op->setFeedPerTooth(0.05);
+  }
+
+
+// workpiece is a box around the first body. The largest vertical
+// cylinder of that body becomes the round contour, small vertical
+// cylinders become drill targets.
+void TestRunner::setupWork() {
+  Work*  work = Core().workData();
+  double maxR = 0;
+
+  mBounds.SetVoid();
+  BRepBndLib::Add(bodies.front(), mBounds);
+  mBounds.SetGap(0);
+  workPiece = Core().helper3D()->createBox(gp_Pnt(mBounds.CornerMin().X() - 5
+                                                , mBounds.CornerMin().Y() - 5
+                                                , mBounds.CornerMin().Z())
+                                         , gp_Pnt(mBounds.CornerMax().X() + 5
+                                                , mBounds.CornerMax().Y() + 5
+                                                , mBounds.CornerMax().Z() + 3));
+  wpBounds = workPiece->BoundingBox(); wpBounds.SetGap(0);
+  work->model          = new AIS_Shape(bodies.front());
+  work->workPiece      = workPiece;
+  work->roundWorkPiece = false;
+
+  delete pf;
+  pf = new ProjectFile();
+  pf->beginGroup("Setup");
+  pf->setValue("Model-File", QDir(sampleDir).filePath("Niederzug-80-Body01.brep"));
+  pf->setValue("model-comment", "kutecam_bench");
+  pf->endGroup();
+  Core().setProjectFile(pf);
+
+  holes.clear();
+  for (const TopoDS_Face& f : Core().helper3D()->allFacesWithin(bodies.front())) {
+      BRepAdaptor_Surface s(f);
+
+      if (s.GetType() != GeomAbs_Cylinder) continue;
+      gp_Cylinder c   = s.Cylinder();
+      gp_Pnt      pos = c.Location();
+
+      if (!kute::isVertical(c.Axis().Direction())) continue;
+      pos.SetZ(mBounds.CornerMax().Z());
+      if (c.Radius() > maxR) {
+         maxR   = c.Radius();
+         center = pos;
+         }
+      if (c.Radius() < 8) {
+         bool known = false;
+
+         for (const gp_Pnt& h : holes)
+             if (h.Distance(pos) < 0.1) known = true;
+         if (!known) {
+            holes.push_back(pos);
+            holeRadius = c.Radius();
+            }
+         }
+      }
+  if (kute::isEqual(maxR, 0)) {
+     center = Core().helper3D()->centerOf(mBounds);
+     center.SetZ(mBounds.CornerMax().Z());
+     radius = 0.5 * mBounds.CornerMin().Distance(mBounds.CornerMax());
+     }
+  else radius = maxR;
+  qDebug() << "bench: contour radius" << radius << "holes:" << holes.size();
+
+  setupOperation(contourOP, MillTool);
+  ContourTargetDefinition* ctd     = new ContourTargetDefinition(center, radius);
+  GOContour*               contour = new GOContour(center);
+
+  contour->add(new GOCircle(new Geom_Circle(gp_Ax2(center, {0, 0, 1}), radius), 0, 2 * M_PI));
+  contour->simplify(center.Z());
+  ctd->setContour(contour);
+  contourOP->targets.push_back(ctd);
+
+  setupOperation(sweepOP, MillTool);
+  sweepOP->setFinalDepth(mBounds.CornerMax().Z());
+  sweepOP->setCutWidth(sweepOP->toolEntry()->fluteDiameter() * 0.8);
+
+  setupOperation(notchOP, MillTool);
+  double notchWidth = notchOP->toolEntry()->fluteDiameter() * 2.5;
+  double yc         = center.Y();
+  double zTop       = mBounds.CornerMax().Z();
+  double xMin       = mBounds.CornerMin().X();
+  double xMax       = mBounds.CornerMax().X();
+
+  notchOP->setLowerZ(zTop - 6);
+  notchOP->setFinalDepth(zTop - 6);
+  notchOP->targets.push_back(new NotchTargetDefinition(gp_Pln(gp_Pnt(0, 0, zTop), gp_Dir(0, 0, 1))
+                                                     , gp_Pnt(xMin, yc - notchWidth / 2, zTop)
+                                                     , gp_Pnt(xMax, yc - notchWidth / 2, zTop)
+                                                     , gp_Pnt(xMin, yc + notchWidth / 2, zTop)
+                                                     , gp_Pnt(xMax, yc + notchWidth / 2, zTop)));
+
+  setupOperation(drillOP, DrillTool);
+  drillOP->setDrillDepth(mBounds.CornerMin().Z());
+  }
+
+
+QJsonDocument TestRunner::toJson() const {
+  QJsonObject root;
+  QJsonArray  stages;
+  QJsonObject boolStats;
+
+  root["application"] = Core().appName();
+  root["timestamp"]   = QDateTime::currentDateTime().toString(Qt::ISODate);
+  root["qt"]          = qVersion();
+  root["occt"]        = OCC_VERSION_COMPLETE;
+  root["repeats"]     = repeats;
+  for (const Result& r : res) {
+      QJsonObject s;
+
+      s["name"]   = r.name;
+      s["status"] = r.status;
+      s["runs"]   = r.runs;
+      s["count"]  = r.count;
+      s["minMS"]  = r.minMS;
+      s["avgMS"]  = r.avgMS;
+      s["maxMS"]  = r.maxMS;
+      if (!r.message.isEmpty()) s["message"] = r.message;
+      stages.append(s);
+      }
+  root["stages"]  = stages;
+  root["metrics"] = metrics;
+  if (!failed.isEmpty()) root["regressions"] = QJsonArray::fromStringList(failed);
+  for (int i=0; i < BOKindCount; ++i) {
+      BooleanEngine::Stats bs = Core().booleanEngine()->stats(static_cast<BooleanOpKind>(i));
+      QJsonObject          s;
+
+      s["calls"]    = bs.calls;
+      s["failures"] = bs.failures;
+      s["totalMS"]  = bs.totalMS;
+      s["maxMS"]    = bs.maxMS;
+      boolStats[BooleanEngine::kindName(static_cast<BooleanOpKind>(i))] = s;
+      }
+  root["boolean"] = boolStats;
+
+  return QJsonDocument(root);
+  }
+
+
+// empty filename or "-" writes to stdout
+bool TestRunner::write(const QString& fileName) const {
+  QFile out;
+
+  if (fileName.isEmpty() || fileName == "-") {
+     if (!out.open(stdout, QIODevice::WriteOnly)) return false;
+     }
+  else {
+     out.setFileName(fileName);
+     if (!out.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+     }
+  out.write(toJson().toJson(QJsonDocument::Indented));
+  out.close();
+
+  return true;
+  }
+
+
+// tolerances of an existing baseline are kept, so they can be
+// adjusted by hand without getting lost on next update.
+bool TestRunner::writeBaseline(const QString& fileName) const {
+  QFile       file(fileName);
+  QJsonObject base;
+  QJsonObject tolerances = ToolpathMetrics::defaultTolerances();
+
+  if (file.open(QIODevice::ReadOnly)) {
+     QJsonObject old = QJsonDocument::fromJson(file.readAll()).object();
+
+     if (old.contains("tolerances")) tolerances = old.value("tolerances").toObject();
+     file.close();
+     }
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) return false;
+  base["created"]    = QDateTime::currentDateTime().toString(Qt::ISODate);
+  base["tolerances"] = tolerances;
+  base["metrics"]    = metrics;
+  file.write(QJsonDocument(base).toJson(QJsonDocument::Indented));
+  file.close();
+
+  return true;
+  }
@@ -0,0 +1,125 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       testrunner.h
+ *  project:    kuteCAM
+ *  subproject: benchmark
+ *  purpose:    time the expensive parts of toolpath creation without
+ *              a display, so regressions between releases show up
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef TESTRUNNER_H
+#define TESTRUNNER_H
+#include <AIS_Shape.hxx>
+#include <Bnd_Box.hxx>
+#include <TopoDS_Shape.hxx>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <functional>
+#include <vector>
+class Operation;
+class PathBuilder;
+class PathBuilderUtil;
+class ProjectFile;
+class QJsonDocument;
+class Workstep;
+
+
+// runs the toolpath workflow of the application on the sample models
+// and measures each stage. Every stage is repeated and the timings
+// (min/avg/max in ms) are kept together with the number of items the
+// stage produced, so changed results are noticed as well.
+// Quality of the generated toolpaths is measured per operation and
+// may be checked against a baseline written by a previous run.
+class TestRunner
+{
+public:
+  struct Result {
+    QString name;
+    QString status;           // ok or failed
+    QString message;
+    int     runs  = 0;
+    int     count = 0;        // items produced by last run
+    double  minMS = 0;
+    double  avgMS = 0;
+    double  maxMS = 0;
+    };
+  explicit TestRunner(const QString& sampleDir, int repeats = 3);
+  virtual ~TestRunner();
+
+  bool                       checkBaseline(const QString& fileName);
+  const QStringList&         regressions() const { return failed; }
+  bool                       run();
+  const std::vector<Result>& results() const { return res; }
+  QJsonDocument              toJson() const;
+  bool                       write(const QString& fileName) const;
+  bool                       writeBaseline(const QString& fileName) const;
+
+protected:
+  void clearPath(std::vector<Workstep*>& path);
+  void clearWorkSteps(Operation* op);
+  void collectMetrics();
+  std::vector<Handle(AIS_Shape)> cutPlanes(const TopoDS_Shape& shape, double top, double bottom, double step);
+  bool measure(const QString& name, std::function<int()> stage);
+  void setupOperation(Operation* op, int toolNum);
+  void setupWork();
+
+  int  createContourCutPart();
+  int  createGCode();
+  int  createNotchCutPart();
+  int  genDrillSequence();
+  int  genNotchPath();
+  int  genPocketPath();
+  int  genRoundPath();
+  int  genSweepPath();
+  int  genToolPath();
+  int  loadModels();
+  int  loadTools();
+  int  postSpecMoves();
+
+  static const int MillTool;
+  static const int DrillTool;
+
+private:
+  QString                   sampleDir;
+  int                       repeats;
+  std::vector<Result>       res;
+  std::vector<TopoDS_Shape> bodies;
+  std::vector<gp_Pnt>       holes;
+  std::vector<Workstep*>    pocketPath;
+  std::vector<Workstep*>    roundPath;
+  QJsonObject               metrics;
+  QStringList               failed;
+  Bnd_Box                   mBounds;
+  Bnd_Box                   wpBounds;
+  Handle(AIS_Shape)         workPiece;
+  PathBuilderUtil*          pbu;
+  PathBuilder*              pb;
+  ProjectFile*              pf;
+  Operation*                contourOP;
+  Operation*                drillOP;
+  Operation*                notchOP;
+  Operation*                sweepOP;
+  gp_Pnt                    center;
+  double                    radius;
+  double                    holeRadius;
+  };
+#endif // TESTRUNNER_H
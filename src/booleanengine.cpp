@@ -0,0 +1,229 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       booleanengine.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "booleanengine.h"
+#include "tracer.h"
+#include <BRepAlgoAPI_Common.hxx>
+#include <BRepAlgoAPI_Fuse.hxx>
+#include <BRepAlgoAPI_Section.hxx>
+#include <BRepAlgoAPI_Splitter.hxx>
+#include <BOPAlgo_GlueEnum.hxx>
+#include <TopTools_ListOfShape.hxx>
+#include <QElapsedTimer>
+#include <QMutexLocker>
+#include <QSettings>
+#include <QDebug>
+#include <algorithm>
+
+
+// arguments and tools have the same setter names on boolean operations
+// and on the splitter, but no common base class provides them.
+template<class T>
+static void setOperands(T& op, const TopoDS_Shape& src, const TopoDS_Shape& tool) {
+  TopTools_ListOfShape args;
+  TopTools_ListOfShape tools;
+
+  args.Append(src);
+  tools.Append(tool);
+  op.SetArguments(args);
+  op.SetTools(tools);
+  }
+
+
+BooleanEngine::BooleanEngine() {
+  }
+
+
+void BooleanEngine::applyProfile(BRepAlgoAPI_BuilderAlgo& algo) const {
+  algo.SetRunParallel(cfg.parallel);
+  algo.SetFuzzyValue(cfg.fuzzyValue);
+  algo.SetUseOBB(cfg.useOBB);
+  algo.SetNonDestructive(cfg.nonDestructive);
+  algo.SetCheckInverted(cfg.checkInverted);
+  algo.SetGlue(static_cast<BOPAlgo_GlueEnum>(cfg.glue));
+  }
+
+
+TopoDS_Shape BooleanEngine::common(const TopoDS_Shape& src, const TopoDS_Shape& tool) {
+  TraceSpan span("BooleanEngine::common");
+  QElapsedTimer      timer;
+  BRepAlgoAPI_Common op;
+
+  timer.start();
+  setOperands(op, src, tool);
+  applyProfile(op);
+  op.Build();
+  bool failed = !op.IsDone() || op.HasErrors();
+
+  record(BOCommon, timer.nsecsElapsed() / 1e6, failed);
+  if (failed) return TopoDS_Shape();
+
+  return op.Shape();
+  }
+
+
+void BooleanEngine::dumpStats() const {
+  QMutexLocker lock(&mutex);
+
+  qDebug() << "boolean engine statistics:";
+  for (int i=0; i < BOKindCount; ++i) {
+      const Stats& s = opStats[i];
+
+      if (!s.calls) continue;
+      qDebug() << "\t" << kindName(static_cast<BooleanOpKind>(i))
+               << "calls:"    << s.calls
+               << "failed:"   << s.failures
+               << "total ms:" << s.totalMS
+               << "avg ms:"   << s.totalMS / s.calls
+               << "max ms:"   << s.maxMS;
+      }
+  }
+
+
+TopoDS_Shape BooleanEngine::fuse(const TopoDS_Shape& src, const TopoDS_Shape& tool) {
+  TraceSpan span("BooleanEngine::fuse");
+  QElapsedTimer    timer;
+  BRepAlgoAPI_Fuse op;
+
+  timer.start();
+  setOperands(op, src, tool);
+  applyProfile(op);
+  op.Build();
+  bool failed = !op.IsDone() || op.HasErrors();
+
+  record(BOFuse, timer.nsecsElapsed() / 1e6, failed);
+  if (failed) return TopoDS_Shape();
+
+  return op.Shape();
+  }
+
+
+QString BooleanEngine::kindName(BooleanOpKind kind) {
+  switch (kind) {
+    case BOSection: return "section";
+    case BOCommon:  return "common";
+    case BOFuse:    return "fuse";
+    case BOSplit:   return "split";
+    default:        break;
+    }
+  return "unknown";
+  }
+
+
+void BooleanEngine::loadProfile(QSettings& settings) {
+  Profile p;
+
+  settings.beginGroup("Boolean");
+  p.parallel       = settings.value("parallel",       p.parallel).toBool();
+  p.useOBB         = settings.value("useOBB",         p.useOBB).toBool();
+  p.nonDestructive = settings.value("nonDestructive", p.nonDestructive).toBool();
+  p.checkInverted  = settings.value("checkInverted",  p.checkInverted).toBool();
+  p.glue           = settings.value("glue",           p.glue).toInt();
+  p.fuzzyValue     = settings.value("fuzzyValue",     p.fuzzyValue).toDouble();
+  settings.endGroup();
+  setProfile(p);
+  }
+
+
+void BooleanEngine::record(BooleanOpKind kind, double ms, bool failed) {
+  QMutexLocker lock(&mutex);
+  Stats&       s = opStats[kind];
+
+  ++s.calls;
+  if (failed) ++s.failures;
+  s.totalMS += ms;
+  s.maxMS    = std::max(s.maxMS, ms);
+  }
+
+
+void BooleanEngine::resetStats() {
+  QMutexLocker lock(&mutex);
+
+  for (auto& s : opStats) s = Stats();
+  }
+
+
+TopoDS_Shape BooleanEngine::section(const TopoDS_Shape& src, const TopoDS_Shape& tool) {
+  TraceSpan span("BooleanEngine::section");
+  QElapsedTimer       timer;
+  BRepAlgoAPI_Section op;
+
+  timer.start();
+  setOperands(op, src, tool);
+  applyProfile(op);
+  op.Build();
+  bool failed = !op.IsDone() || op.HasErrors();
+
+  record(BOSection, timer.nsecsElapsed() / 1e6, failed);
+  if (failed) return TopoDS_Shape();
+
+  return op.Shape();
+  }
+
+
+void BooleanEngine::setProfile(const Profile& p) {
+  cfg = p;
+  if (cfg.glue < BOPAlgo_GlueOff || cfg.glue > BOPAlgo_GlueFull) cfg.glue = BOPAlgo_GlueOff;
+  if (cfg.fuzzyValue < 0) cfg.fuzzyValue = 0;
+  }
+
+
+TopoDS_Shape BooleanEngine::split(const TopoDS_Shape& src, const TopoDS_Shape& tool, bool simplify) {
+  TraceSpan span("BooleanEngine::split");
+  QElapsedTimer        timer;
+  BRepAlgoAPI_Splitter op;
+
+  timer.start();
+  setOperands(op, src, tool);
+  applyProfile(op);
+  op.Build();
+  bool failed = !op.IsDone() || op.HasErrors();
+
+  if (!failed && simplify) op.SimplifyResult();
+  record(BOSplit, timer.nsecsElapsed() / 1e6, failed);
+  if (failed) return TopoDS_Shape();
+
+  return op.Shape();
+  }
+
+
+BooleanEngine::Stats BooleanEngine::stats(BooleanOpKind kind) const {
+  QMutexLocker lock(&mutex);
+
+  return opStats[kind];
+  }
+
+
+void BooleanEngine::storeProfile(QSettings& settings) const {
+  settings.beginGroup("Boolean");
+  settings.setValue("parallel",       cfg.parallel);
+  settings.setValue("useOBB",         cfg.useOBB);
+  settings.setValue("nonDestructive", cfg.nonDestructive);
+  settings.setValue("checkInverted",  cfg.checkInverted);
+  settings.setValue("glue",           cfg.glue);
+  settings.setValue("fuzzyValue",     cfg.fuzzyValue);
+  settings.endGroup();
+  }
@@ -0,0 +1,91 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       booleanengine.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef BOOLEANENGINE_H
+#define BOOLEANENGINE_H
+#include <TopoDS_Shape.hxx>
+#include <QMutex>
+#include <QString>
+class BRepAlgoAPI_BuilderAlgo;
+class QSettings;
+
+
+enum BooleanOpKind
+{
+  BOSection
+, BOCommon
+, BOFuse
+, BOSplit
+, BOKindCount
+  };
+
+
+// all boolean operations of the application go through this class,
+// so they share the same settings and can be measured in one place.
+class BooleanEngine
+{
+public:
+  struct Profile {
+    bool   parallel       = true;
+    bool   useOBB         = true;
+    bool   nonDestructive = true;
+    bool   checkInverted  = true;
+    int    glue           = 0;     // BOPAlgo_GlueEnum (off, shift, full)
+    double fuzzyValue     = 0.001;
+    };
+  struct Stats {
+    int    calls    = 0;
+    int    failures = 0;
+    double totalMS  = 0;
+    double maxMS    = 0;
+    };
+  BooleanEngine();
+
+  TopoDS_Shape   common(const TopoDS_Shape& src, const TopoDS_Shape& tool);
+  TopoDS_Shape   fuse(const TopoDS_Shape& src, const TopoDS_Shape& tool);
+  TopoDS_Shape   section(const TopoDS_Shape& src, const TopoDS_Shape& tool);
+  TopoDS_Shape   split(const TopoDS_Shape& src, const TopoDS_Shape& tool, bool simplify = false);
+
+  void           dumpStats() const;
+  void           loadProfile(QSettings& settings);
+  const Profile& profile() const        { return cfg; }
+  void           resetStats();
+  void           setProfile(const Profile& p);
+  Stats          stats(BooleanOpKind kind) const;
+  void           storeProfile(QSettings& settings) const;
+
+  static QString kindName(BooleanOpKind kind);
+
+protected:
+  void           applyProfile(BRepAlgoAPI_BuilderAlgo& algo) const;
+  void           record(BooleanOpKind kind, double ms, bool failed);
+
+private:
+  Profile        cfg;
+  Stats          opStats[BOKindCount];
+  mutable QMutex mutex;
+  };
+#endif // BOOLEANENGINE_H
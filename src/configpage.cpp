@@ -27,16 +27,19 @@
 #include "configpage.h"
 #include "ui_misc.h"
 #include "ui_mainwindow.h"
+#include "booleanengine.h"
 #include "cfggeneral.h"
 #include "cfgmaterial.h"
 #include "cfgvise.h"
 #include "core.h"
 #include "kuteCAM.h"
 #include "mainwindow.h"
+#include "pathpipeline.h"
 #include "stringlistmodel.h"
 #include "occtviewer.h"
 #include "preview3d.h"
 #include "projectfile.h"
+#include "tooldatabase.h"
 #include "tooleditor.h"
 #include "toollistmodel.h"
 #include "viseentry.h"
@@ -95,6 +98,19 @@ void ConfigPage::closeEvent(QCloseEvent *e) {
   cfg.setValue("autoRotateSelected", Core().autoRotateSelection());
   cfg.setValue("machineType", Core().machineType());
   cfg.setValue("genSepToolChange", Core().isSepWithToolChange());
+  cfg.setValue("exactSections", Core().isExactSections());
+  cfg.setValue("meshDeflection", Core().meshDeflection());
+  cfg.setValue("adaptiveClearing", Core().isAdaptiveClearing());
+  cfg.setValue("adaptiveMinLoad", Core().adaptiveMinLoad());
+  cfg.setValue("chordTolerance", Core().chordTolerance());
+  cfg.setValue("scallopHeight", Core().scallopHeight());
+  cfg.setValue("trimAirCuts", Core().isTrimAirCuts());
+  cfg.setValue("keepDownLinks", Core().isKeepDownLinks());
+  cfg.setValue("featureInstancing", Core().isFeatureInstancing());
+  cfg.setValue("feedOptimization", Core().isFeedOptimization());
+  cfg.setValue("feedMinFactor", Core().feedMinFactor());
+  cfg.setValue("feedMaxFactor", Core().feedMaxFactor());
+  cfg.setValue("maxFeed", Core().maxFeed());
   cfg.beginWriteArray("Vises");
   mx = vises->rowCount();
   ViseEntry* ve;
@@ -111,6 +127,8 @@ void ConfigPage::closeEvent(QCloseEvent *e) {
       }
   cfg.endArray();
   cfg.endGroup();
+  Core().booleanEngine()->storeProfile(cfg);
+  Core().pathPipeline()->storeProfile(cfg);
   cfg.sync();
   }
 
@@ -133,7 +151,7 @@ void ConfigPage::loadTools() {
   QFileDialog dialog(this
                    , tr("QFileDialog::getOpenFileName()")
                    , kute::BasePath
-                   , tr("XML-Documents (*.xml)"));
+                   , tr("Tool Libraries (*.xml *.db)"));
 
   dialog.setSupportedSchemes(QStringList(QStringLiteral("file")));
   dialog.setFileMode(QFileDialog::ExistingFile);
@@ -159,17 +177,25 @@ void ConfigPage::saveTools() {
   QFileDialog dialog(this
                    , tr("QFileDialog::getSaveFileName()")
                    , kute::BasePath
-                   , tr("XML-Documents (*.xml)"));
+                   , tr("XML-Documents (*.xml);;Tool Database (*.db)"));
 
   dialog.setSupportedSchemes(QStringList(QStringLiteral("file")));
   dialog.setOption(QFileDialog::DontUseNativeDialog);
   dialog.setAcceptMode(QFileDialog::AcceptSave);
   if (dialog.exec() != QDialog::Accepted) return;
   fileName = dialog.selectedUrls().value(0).toLocalFile();
-  if (!fileName.endsWith(".xml")) fileName += ".xml";
-
+  if (!fileName.endsWith(".xml") && !fileName.endsWith(".db")) {
+     fileName += dialog.selectedNameFilter().contains("*.db") ? ".db" : ".xml";
+     }
   qDebug() << "save tools to:" << fileName;
 
+  // xml libraries get imported to database, database exported to xml
+  if (fileName.endsWith(".db")) {
+     ToolDatabase db(fileName);
+
+     db.store(Core().toolListModel()->tools());
+     return;
+     }
   XmlToolWriter xtw;
 
   xtw.write(fileName, Core().toolListModel()->tools());
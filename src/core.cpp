@@ -30,6 +30,7 @@
 #include "geomnodemodel.h"
 #include "kuteCAM.h"
 #include "shapelistmodel.h"
+#include "specpostprocessor.h"
 #include "postprocessor.h"
 #include "pluginlistmodel.h"
 #include "projectfile.h"
@@ -44,24 +45,38 @@
 #include <QPluginLoader>
 #include <QDir>
 #include <QDebug>
+#include <algorithm>
 
 
 Core::Core(QApplication& app, MainWindow& win)
  : QObject(nullptr)  {
   if (k) throw std::logic_error("invalid call sequence! Already initialized");
-  k = new Kernel(app, win);
+  k = new Kernel(app, &win);
   k->initialize();
   }
 
 
+Core::Core(QApplication& app)
+ : QObject(nullptr)  {
+  if (k) throw std::logic_error("invalid call sequence! Already initialized");
+  k = new Kernel(app);
+  k->initHeadless();
+  }
+
+
 Core::Core() {
   if (!k) throw std::logic_error("invalid call sequence! Need to initialize before use!");
   }
 
 
+double Core::adaptiveMinLoad() const {
+  return k->adaptiveMinLoad;
+  }
+
+
 void Core::addCurve(Handle(AIS_Shape) s) {
   k->shapeListModel->append(s);
-  k->win.update();
+  if (k->win) k->win->update();
   }
 
 
@@ -80,6 +95,11 @@ bool Core::autoRotateSelection() const {
   }
 
 
+BooleanEngine* Core::booleanEngine() {
+  return k->boolEngine;
+  }
+
+
 QSettings& Core::cfg() {
   return k->configData;
   }
@@ -135,11 +155,31 @@ QString Core::chooseProjectFile(QWidget* parent) {
   }
 
 
+double Core::chordTolerance() const {
+  return k->chordTolerance;
+  }
+
+
 void Core::clearCurves() {
   k->shapeListModel->clear();
   }
 
 
+double Core::feedMaxFactor() const {
+  return k->feedMaxFactor;
+  }
+
+
+double Core::feedMinFactor() const {
+  return k->feedMinFactor;
+  }
+
+
+bool Core::isAdaptiveClearing() const {
+  return k->adaptiveClearing;
+  }
+
+
 bool Core::isAllInOneOperation() const {
   return k->opAllInOne;
   }
@@ -160,10 +200,35 @@ bool Core::isCAxisTable() const {
   }
 
 
+bool Core::isExactSections() const {
+  return k->exactSections;
+  }
+
+
+bool Core::isFeatureInstancing() const {
+  return k->featureInstancing;
+  }
+
+
+bool Core::isFeedOptimization() const {
+  return k->feedOptimization;
+  }
+
+
 bool Core::isSepWithToolChange() const {
   return k->genSepWithToolChange;
   }
 
+
+bool Core::isKeepDownLinks() const {
+  return k->keepDownLinks;
+  }
+
+
+bool Core::isTrimAirCuts() const {
+  return k->trimAirCuts;
+  }
+
 bool Core::hasModelLoaded() const {
   return k->pf != nullptr;
   }
@@ -183,8 +248,24 @@ std::vector<Operation*> Core::loadOperations(ProjectFile *pf) {
   }
 
 
+// postprocessors are owned by the application - plugin instances by
+// the plugin loader, compiled specs by the kernel (one per spec file)
 PostProcessor* Core::loadPostProcessor(const QString& ppName) {
   QString ppPath = k->ppModel->value(ppName);
+
+  if (ppPath.endsWith(".pps")) {
+     SpecPostProcessor* spp = k->specPPs.value(ppPath);
+
+     if (spp) return spp;
+     spp = new SpecPostProcessor(k);
+     if (!spp->load(ppPath)) {
+        delete spp;
+        return nullptr;
+        }
+     k->specPPs.insert(ppPath, spp);
+
+     return spp;
+     }
   QPluginLoader loader(ppPath);
   QObject*      plugin = loader.instance();
 
@@ -217,8 +298,18 @@ int Core::machineType() const {
   }
 
 
+double Core::maxFeed() const {
+  return k->maxFeed;
+  }
+
+
+double Core::meshDeflection() const {
+  return k->meshDeflection;
+  }
+
+
 MainWindow* Core::mainWin() {
-  return &k->win;
+  return k->win;
   }
 
 
@@ -254,6 +345,11 @@ void Core::onShutdown(QCloseEvent* ce) {
   }
 
 
+PathPipeline* Core::pathPipeline() {
+  return k->pathPipeline;
+  }
+
+
 QString Core::postProcessor() const {
   return k->selectedPP;
   }
@@ -279,11 +375,26 @@ void Core::saveOperations() {
   }
 
 
+double Core::scallopHeight() const {
+  return k->scallopHeight;
+  }
+
+
 SelectionHandler* Core::selectionHandler() {
   return k->selHdr;
   }
 
 
+void Core::setAdaptiveClearing(bool value) {
+  k->adaptiveClearing = value;
+  }
+
+
+void Core::setAdaptiveMinLoad(double value) {
+  k->adaptiveMinLoad = std::max(0.0, std::min(1.0, value));
+  }
+
+
 void Core::setAllInOneOperation(bool value) {
   k->opAllInOne = value;
   }
@@ -309,11 +420,48 @@ void Core::setCAxisIsTable(bool value) {
   }
 
 
+void Core::setChordTolerance(double value) {
+  if (value > 0) k->chordTolerance = value;
+  }
+
+
+void Core::setExactSections(bool value) {
+  k->exactSections = value;
+  }
+
+
+void Core::setFeatureInstancing(bool value) {
+  k->featureInstancing = value;
+  }
+
+
+void Core::setFeedLimits(double minFactor, double maxFactor, double maxFeed) {
+  k->feedMinFactor = std::max(0.1, minFactor);
+  k->feedMaxFactor = std::max(k->feedMinFactor, maxFactor);
+  k->maxFeed       = std::max(0.0, maxFeed);
+  }
+
+
+void Core::setFeedOptimization(bool value) {
+  k->feedOptimization = value;
+  }
+
+
+void Core::setKeepDownLinks(bool value) {
+  k->keepDownLinks = value;
+  }
+
+
 void Core::setMachineType(int mt) {
   k->machineType = mt;
   }
 
 
+void Core::setMeshDeflection(double value) {
+  k->meshDeflection = value;
+  }
+
+
 void Core::setPostProcessor(const QString& ppName) {
   k->selectedPP = ppName;
   }
@@ -324,11 +472,21 @@ void Core::setProjectFile(ProjectFile *pf) {
   }
 
 
+void Core::setScallopHeight(double value) {
+  if (value > 0) k->scallopHeight = value;
+  }
+
+
 void Core::setSepWithToolChange(bool value) {
   k->genSepWithToolChange = value;
   }
 
 
+void Core::setTrimAirCuts(bool value) {
+  k->trimAirCuts = value;
+  }
+
+
 void Core::setWorkData(Work *data) {
   k->work = data;
   }
@@ -343,7 +501,7 @@ void Core::switchPage(const QString &page) {
   qDebug() << "requested page:" << page;
   if (k->pages.contains(page)) {
      qDebug() << "OK, switch to" << page;
-     k->win.setPage(k->pages[page]);
+     k->win->setPage(k->pages[page]);
      }
   }
 
@@ -359,7 +517,7 @@ ToolListModel* Core::toolListModel() {
 
 
 Ui::MainWindow* Core::uiMainWin() {
-  return k->win.ui;
+  return k->win->ui;
   }
 
 
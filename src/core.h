@@ -35,10 +35,12 @@ namespace Ui {
 class MainWindow;
 }
 QT_END_NAMESPACE
+class BooleanEngine;
 class Kernel;
 class MainWindow;
 class OcctQtViewer;
 class Operation;
+class PathPipeline;
 class PostProcessor;
 class ProjectFile;
 class SelectionHandler;
@@ -64,26 +66,38 @@ public:
 
   explicit Core();
   explicit Core(QApplication& app, MainWindow& win);
+  explicit Core(QApplication& app);
   virtual ~Core() = default;
 
+  double                   adaptiveMinLoad() const;
   void                     addCurve(Handle(AIS_Shape) s);
   QString                  appName() const;
   QApplication&            application() const;
   bool                     autoRotateSelection() const;
+  BooleanEngine*           booleanEngine();
   Ui::MainWindow*          uiMainWin();
   MainWindow*              mainWin();
   QSettings&               cfg();
   const QSettings&         cfg() const;
   QString                  chooseCADFile(QWidget* parent = nullptr);
+  double                   chordTolerance() const;
   QString                  chooseProjectFile(QWidget* parent = nullptr);
   void                     clearCurves();
+  double                   feedMaxFactor() const;
+  double                   feedMinFactor() const;
   Util3D*                  helper3D();
   bool                     hasModelLoaded() const;
+  bool                     isAdaptiveClearing() const;
   bool                     isAllInOneOperation() const;
   bool                     isAAxisTable() const;
   bool                     isBAxisTable() const;
   bool                     isCAxisTable() const;
+  bool                     isExactSections() const;
+  bool                     isFeatureInstancing() const;
+  bool                     isFeedOptimization() const;
+  bool                     isKeepDownLinks() const;
   bool                     isSepWithToolChange() const;
+  bool                     isTrimAirCuts() const;
   bool                     loadFile(const QString& fileName);
   std::vector<Operation*>  loadOperations(ProjectFile* pf);
   PostProcessor*           loadPostProcessor(const QString& ppName);
@@ -91,24 +105,39 @@ public:
   bool                     loadTools(const QString& fileName);
   void                     loadVise(ViseEntry* vise, Handle(AIS_Shape)& left, Handle(AIS_Shape)& middle, Handle(AIS_Shape)& right);
   int                      machineType() const;
+  double                   maxFeed() const;
+  double                   meshDeflection() const;
   bool                     move2Backup(const QString& fileName);
   void                     onShutdown(QCloseEvent* ce);
+  PathPipeline*            pathPipeline();
   QString                  postProcessor() const;
   QAbstractItemModel*      ppModel() const;
+  double                   scallopHeight() const;
   ProjectFile*             projectFile();
   void                     riseError(const QString& msg);
   void                     saveOperations();
   ShapeFix_ShapeTolerance& shapeFix();
   SelectionHandler*        selectionHandler();
+  void                     setAdaptiveClearing(bool value);
+  void                     setAdaptiveMinLoad(double value);
   void                     setAllInOneOperation(bool value);
   void                     setAutoRotateSelection(bool value);
   void                     setAAxisIsTable(bool value);
   void                     setBAxisIsTable(bool value);
   void                     setCAxisIsTable(bool value);
+  void                     setChordTolerance(double value);
+  void                     setExactSections(bool value);
+  void                     setFeatureInstancing(bool value);
+  void                     setFeedLimits(double minFactor, double maxFactor, double maxFeed);
+  void                     setFeedOptimization(bool value);
+  void                     setKeepDownLinks(bool value);
   void                     setMachineType(int mt);
+  void                     setMeshDeflection(double value);
   void                     setPostProcessor(const QString& ppName);
   void                     setProjectFile(ProjectFile* pf);
+  void                     setScallopHeight(double value);
   void                     setSepWithToolChange(bool value);
+  void                     setTrimAirCuts(bool value);
   void                     setWorkData(Work* data);
   void                     switchPage(const QString& page);
   TDFactory*               tdFactory();
@@ -0,0 +1,295 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       dropcutter.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "dropcutter.h"
+#include "kuteCAM.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Face.hxx>
+#include <gp_Vec.hxx>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+
+static const double NoContact = -1e99;
+static const int    LeafSize  = 8;
+
+
+// profile of cutter at distance d from its axis, measured from tip
+double CutterShape::height(double d) const {
+  double ring = radius - cornerRadius;
+
+  if (d <= ring || cornerRadius <= 0) return 0;
+  double e = d - ring;
+
+  return cornerRadius - std::sqrt(std::max(0.0, cornerRadius * cornerRadius - e * e));
+  }
+
+
+// tool table knows no cutter types. Mills have no cutting angle,
+// a tip diameter less than flute diameter leaves a corner radius.
+// Ball nose mills are flagged by cutting angle of 180°.
+bool CutterShape::fromTool(const ToolEntry* tool, CutterShape& cutter) {
+  if (!tool || tool->fluteDiameter() <= 0) return false;
+  double fd = tool->fluteDiameter();
+  double td = tool->tipDiameter();
+
+  cutter.radius = fd / 2;
+  if (kute::isEqual(tool->cuttingAngle(), 180)) {
+     cutter.cornerRadius = cutter.radius;
+     return true;
+     }
+  if (!kute::isEqual(tool->cuttingAngle(), 0)) return false;   // cone
+  cutter.cornerRadius = td > 0 && td < fd ? (fd - td) / 2 : 0;
+
+  return true;
+  }
+
+
+DropCutter::DropCutter(const TopoDS_Shape& shape, const CutterShape& cutter, double deflection)
+ : cutter(cutter)
+ , deflection(deflection) {
+  triangulate(shape);
+  order.resize(tris.size());
+  for (int i=0; i < (int)tris.size(); ++i) order[i] = i;
+  if (tris.size()) build(0, tris.size());
+
+  qCDebug(lcPath) << "DC: mesh has" << nodes.size() << "nodes," << tris.size()
+                  << "triangles and" << bvh.size() << "bvh nodes";
+  }
+
+
+// split triangles at median of centroids along the longer axis
+int DropCutter::build(int first, int count) {
+  Node n;
+  int  id = bvh.size();
+
+  n.xMin = n.yMin = 1e99;
+  n.xMax = n.yMax = n.zMax = -1e99;
+  for (int i=first; i < first + count; ++i) {
+      const Triangle& t = tris[order[i]];
+
+      for (int k : t.n) {
+          n.xMin = std::min(n.xMin, nodes[k].X());
+          n.yMin = std::min(n.yMin, nodes[k].Y());
+          n.xMax = std::max(n.xMax, nodes[k].X());
+          n.yMax = std::max(n.yMax, nodes[k].Y());
+          }
+      n.zMax = std::max(n.zMax, t.zMax);
+      }
+  n.left  = n.right = -1;
+  n.first = first;
+  n.count = count;
+  bvh.push_back(n);
+  if (count <= LeafSize) return id;
+  bool byX  = n.xMax - n.xMin > n.yMax - n.yMin;
+  int  half = count / 2;
+  auto center = [&](int ti) {
+    const Triangle& t = tris[ti];
+
+    return byX ? nodes[t.n[0]].X() + nodes[t.n[1]].X() + nodes[t.n[2]].X()
+               : nodes[t.n[0]].Y() + nodes[t.n[1]].Y() + nodes[t.n[2]].Y();
+    };
+  std::nth_element(order.begin() + first, order.begin() + first + half, order.begin() + first + count
+                 , [&](int l, int r) { return center(l) < center(r); });
+  int left  = build(first, half);
+  int right = build(first + half, count - half);
+
+  bvh[id].left  = left;
+  bvh[id].right = right;
+
+  return id;
+  }
+
+
+// highest tip position, where the cutter at x/y touches any triangle
+bool DropCutter::drop(double x, double y, double& z) const {
+  double best = NoContact;
+  double r    = cutter.radius;
+  int    stack[64];
+  int    sp   = 0;
+
+  if (bvh.empty()) return false;
+  stack[sp++] = 0;
+  while (sp) {
+        const Node& n = bvh[stack[--sp]];
+
+        if (n.zMax <= best
+         || n.xMin > x + r || n.xMax < x - r
+         || n.yMin > y + r || n.yMax < y - r) continue;
+        if (n.left >= 0) {
+           stack[sp++] = n.left;
+           stack[sp++] = n.right;
+           continue;
+           }
+        for (int i=n.first; i < n.first + n.count; ++i) {
+            const Triangle& t = tris[order[i]];
+
+            if (t.zMax <= best) continue;
+            best = std::max(best, facetContact(t, x, y));
+            for (int k=0; k < 3; ++k)
+                best = std::max(best, edgeContact(nodes[t.n[k]], nodes[t.n[(k + 1) % 3]], x, y));
+            }
+        }
+  if (best <= NoContact) return false;
+  z = best;
+
+  return true;
+  }
+
+
+// contact of cutter with edge a-b. In the vertical plane of the edge
+// the tip height is linear edge height minus cutter profile, which is
+// concave along the edge, so there is one maximum only.
+double DropCutter::edgeContact(const gp_Pnt& a, const gp_Pnt& b, double x, double y) const {
+  double r  = cutter.radius;
+  double dx = b.X() - a.X();
+  double dy = b.Y() - a.Y();
+  double l  = std::sqrt(dx * dx + dy * dy);
+
+  if (l < kute::MinDelta) {                 // vertical edge - upper end counts
+     gp_Pnt p = a.Z() > b.Z() ? a : b;
+     double d = std::hypot(p.X() - x, p.Y() - y);
+
+     return d > r ? NoContact : p.Z() - cutter.height(d);
+     }
+  double ux = dx / l;
+  double uy = dy / l;
+  double tp = (x - a.X()) * ux + (y - a.Y()) * uy;
+  double d  = std::abs((x - a.X()) * uy - (y - a.Y()) * ux);
+
+  if (d > r) return NoContact;
+  double s  = std::sqrt(r * r - d * d);
+  double lo = std::max(0.0, tp - s);
+  double hi = std::min(l, tp + s);
+
+  if (lo > hi) return NoContact;
+  double m = (b.Z() - a.Z()) / l;
+  auto   f = [&](double t) { return a.Z() + m * t - cutter.height(std::hypot(d, t - tp)); };
+
+  if (cutter.cornerRadius <= 0)             // flat - linear
+     return std::max(f(lo), f(hi));
+  if (kute::isEqual(cutter.cornerRadius, r)) {
+     double t = tp + m * s / std::sqrt(1 + m * m);
+
+     return f(std::max(lo, std::min(hi, t)));
+     }
+  // bull nose - golden section search
+  const double g  = (std::sqrt(5.0) - 1) / 2;
+  double       t1 = hi - g * (hi - lo);
+  double       t2 = lo + g * (hi - lo);
+  double       f1 = f(t1);
+  double       f2 = f(t2);
+
+  while (hi - lo > deflection / 10) {
+        if (f1 < f2) {
+           lo = t1; t1 = t2; f1 = f2;
+           t2 = lo + g * (hi - lo);
+           f2 = f(t2);
+           }
+        else {
+           hi = t2; t2 = t1; f2 = f1;
+           t1 = hi - g * (hi - lo);
+           f1 = f(t1);
+           }
+        }
+  return std::max(f1, f2);
+  }
+
+
+// contact of cutter with inner of triangle. The corner sphere touches
+// the plane at its lowest point in direction of the plane normal.
+double DropCutter::facetContact(const Triangle& t, double x, double y) const {
+  const gp_Pnt& a = nodes[t.n[0]];
+  const gp_Pnt& b = nodes[t.n[1]];
+  const gp_Pnt& c = nodes[t.n[2]];
+  gp_Vec        n = gp_Vec(a, b).Crossed(gp_Vec(a, c));
+
+  if (n.Magnitude() < kute::MinDelta) return NoContact;
+  n.Normalize();
+  if (n.Z() < 0) n.Reverse();
+  if (n.Z() < 1e-9) return NoContact;       // vertical facet - edges only
+  double rc   = cutter.cornerRadius;
+  double ring = cutter.radius - rc;
+  double nxy  = std::hypot(n.X(), n.Y());
+  double qx   = x;
+  double qy   = y;
+
+  if (nxy > 1e-12) {
+     qx -= ring * n.X() / nxy;
+     qy -= ring * n.Y() / nxy;
+     }
+  double px = qx - rc * n.X();
+  double py = qy - rc * n.Y();
+
+  // contact point must be inside of triangle (XY)
+  double det = (b.X() - a.X()) * (c.Y() - a.Y()) - (c.X() - a.X()) * (b.Y() - a.Y());
+  double u   = ((px - a.X()) * (c.Y() - a.Y()) - (c.X() - a.X()) * (py - a.Y())) / det;
+  double v   = ((b.X() - a.X()) * (py - a.Y()) - (px - a.X()) * (b.Y() - a.Y())) / det;
+
+  if (u < 0 || v < 0 || u + v > 1) return NoContact;
+  double qz = a.Z() + (rc - n.X() * (qx - a.X()) - n.Y() * (qy - a.Y())) / n.Z();
+
+  return qz - rc;
+  }
+
+
+void DropCutter::triangulate(const TopoDS_Shape& shape) {
+  TraceSpan span("DropCutter::triangulate");
+  BRepMesh_IncrementalMesh mesher(shape, deflection, false, 0.5, true);
+
+  for (TopExp_Explorer faceExplorer(shape, TopAbs_FACE)
+     ; faceExplorer.More()
+     ; faceExplorer.Next()) {
+      const TopoDS_Face&         face = TopoDS::Face(faceExplorer.Current());
+      TopLoc_Location            loc;
+      Handle(Poly_Triangulation) pt   = BRep_Tool::Triangulation(face, loc);
+
+      if (pt.IsNull()) continue;
+      const gp_Trsf& trsf = loc.Transformation();
+      int            base = nodes.size();
+
+      for (int i=1; i <= pt->NbNodes(); ++i) {
+          nodes.push_back(pt->Node(i).Transformed(trsf));
+          bb.Add(nodes.back());
+          }
+      for (int i=1; i <= pt->NbTriangles(); ++i) {
+          Triangle t;
+
+          pt->Triangle(i).Get(t.n[0], t.n[1], t.n[2]);
+          for (int& n : t.n) n += base - 1;
+          t.zMax = std::max({nodes[t.n[0]].Z(), nodes[t.n[1]].Z(), nodes[t.n[2]].Z()});
+          tris.push_back(t);
+          }
+      }
+  }
@@ -0,0 +1,90 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       dropcutter.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef DROPCUTTER_H
+#define DROPCUTTER_H
+#include <Bnd_Box.hxx>
+#include <gp_Pnt.hxx>
+#include <TopoDS_Shape.hxx>
+#include <vector>
+class ToolEntry;
+
+
+// rotational cutter as seen by drop cutter. Flat end mills have
+// cornerRadius 0, ball nose mills cornerRadius == radius. Everything
+// between is a bull nose.
+struct CutterShape
+{
+  double radius       = 0;
+  double cornerRadius = 0;
+
+  double height(double d) const;                  // profile above tip at distance d
+  static bool fromTool(const ToolEntry* tool, CutterShape& cutter);
+  };
+
+
+// triangulates a shape and lowers a cutter along Z onto the mesh
+// until it touches. Triangles get looked up by a bounding volume
+// hierarchy of their XY bounds, so each drop visits only triangles
+// below the cutter. Instances are read-only after construction and
+// may be used from several threads.
+class DropCutter
+{
+public:
+  DropCutter(const TopoDS_Shape& shape, const CutterShape& cutter, double deflection = 0.01);
+
+  const Bnd_Box&     bounds() const        { return bb; }
+  const CutterShape& cutterShape() const   { return cutter; }
+  bool               drop(double x, double y, double& z) const;
+  int                triangleCount() const { return tris.size(); }
+
+protected:
+  struct Triangle {
+    int    n[3];
+    double zMax;
+    };
+  struct Node {
+    double xMin, yMin, xMax, yMax, zMax;
+    int    left;      // child nodes, or -1 for leaves
+    int    right;
+    int    first;     // triangles of leaves
+    int    count;
+    };
+  int    build(int first, int count);
+  double edgeContact(const gp_Pnt& a, const gp_Pnt& b, double x, double y) const;
+  double facetContact(const Triangle& t, double x, double y) const;
+  void   triangulate(const TopoDS_Shape& shape);
+
+private:
+  CutterShape           cutter;
+  double                deflection;
+  Bnd_Box               bb;
+  std::vector<gp_Pnt>   nodes;
+  std::vector<Triangle> tris;
+  std::vector<int>      order;      // triangle indices grouped by leaves
+  std::vector<Node>     bvh;
+  };
+#endif // DROPCUTTER_H
@@ -0,0 +1,210 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       edgechainer.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "edgechainer.h"
+#include "tracer.h"
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Vertex.hxx>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+
+static long long cellKey(long long ix, long long iy, long long iz) {
+  const long long mask = 0x1fffff;      // 21 bits per axis
+
+  return ((ix & mask) << 42) | ((iy & mask) << 21) | (iz & mask);
+  }
+
+
+EdgeChainer::EdgeChainer(double tolerance)
+ : tolerance(std::max(tolerance, 1e-7)) {
+  }
+
+
+// each edge gets walked exactly once. Walks start at dangling ends
+// (odd number of edges), so open chains come out in one piece, then
+// all remaining edges form loops.
+std::vector<EdgeChain> EdgeChainer::chain(const std::vector<TopoDS_Edge>& edges) {
+  TraceSpan                     span("EdgeChainer::chain");
+  std::vector<EdgeChain>        rv;
+  std::vector<int>              ends(edges.size() * 2, -1);
+  std::vector<std::vector<int>> adj;
+  std::vector<int>              firstEdge;      // lowest edge index of each chain
+
+  grid.clear();
+  points.clear();
+  gapList.clear();
+  for (int i=0; i < (int)edges.size(); ++i) {
+      const TopoDS_Edge& e = edges[i];
+
+      if (e.IsNull()) continue;
+      TopoDS_Vertex v0 = TopExp::FirstVertex(e, true);
+      TopoDS_Vertex v1 = TopExp::LastVertex(e, true);
+
+      if (v0.IsNull() || v1.IsNull()) continue;
+      int a = pointID(BRep_Tool::Pnt(v0));
+      int b = pointID(BRep_Tool::Pnt(v1));
+
+      adj.resize(points.size());
+      ends[2 * i]     = a;
+      ends[2 * i + 1] = b;
+      adj[a].push_back(i);
+      if (a != b) adj[b].push_back(i);         // full circles are loops by themselves
+      }
+  std::vector<bool> used(edges.size(), false);
+  auto walk = [&](int start) {
+    EdgeChain c;
+    int       cur   = start;
+    int       first = edges.size();
+
+    c.start = points[start];
+    for (;;) {
+        int next = -1;
+
+        for (int e : adj[cur]) {
+            if (!used[e]) {
+               next = e;
+               break;
+               }
+            }
+        if (next < 0) break;
+        used[next] = true;
+        first      = std::min(first, next);
+        if (ends[2 * next] == cur) {
+           c.edges.push_back(edges[next]);
+           cur = ends[2 * next + 1];
+           }
+        else {
+           c.edges.push_back(TopoDS::Edge(edges[next].Reversed()));
+           cur = ends[2 * next];
+           }
+        if (cur == start) {
+           c.closed = true;
+           break;
+           }
+        }
+    c.end = points[cur];
+    if (c.edges.size()) {
+       rv.push_back(c);
+       firstEdge.push_back(first);
+       }
+    };
+
+  for (int i=0; i < (int)points.size(); ++i)
+      if (adj[i].size() % 2) walk(i);
+  for (int i=0; i < (int)edges.size(); ++i)
+      if (!used[i] && ends[2 * i] >= 0) walk(ends[2 * i]);
+
+  // keep order of input, so first chain holds the first edge
+  std::vector<int> order(rv.size());
+
+  for (int i=0; i < (int)order.size(); ++i) order[i] = i;
+  std::sort(order.begin(), order.end(), [&](int l, int r) { return firstEdge[l] < firstEdge[r]; });
+  std::vector<EdgeChain> sorted;
+
+  sorted.reserve(rv.size());
+  for (int i : order) sorted.push_back(rv[i]);
+  findGaps(sorted);
+
+  return sorted;
+  }
+
+
+// open ends are few, so a plain search for the nearest one is fine
+void EdgeChainer::findGaps(const std::vector<EdgeChain>& chains) {
+  std::vector<gp_Pnt> open;
+
+  for (const auto& c : chains) {
+      if (c.closed) continue;
+      open.push_back(c.start);
+      open.push_back(c.end);
+      }
+  std::vector<bool> done(open.size(), false);
+
+  for (int i=0; i < (int)open.size(); ++i) {
+      if (done[i]) continue;
+      int    best = -1;
+      double d    = 0;
+
+      for (int j=0; j < (int)open.size(); ++j) {
+          if (j == i || done[j]) continue;
+          double dj = open[i].Distance(open[j]);
+
+          if (best < 0 || dj < d) {
+             best = j;
+             d    = dj;
+             }
+          }
+      if (best < 0) break;
+      done[i]    = true;
+      done[best] = true;
+      gapList.push_back({open[i], open[best], d});
+      qCWarning(lcContour) << "gap of" << d << "between"
+                           << open[i].X()    << "/" << open[i].Y()    << "/" << open[i].Z() << "and"
+                           << open[best].X() << "/" << open[best].Y() << "/" << open[best].Z();
+      }
+  }
+
+
+int EdgeChainer::pointID(const gp_Pnt& p) {
+  long long ix = std::floor(p.X() / tolerance);
+  long long iy = std::floor(p.Y() / tolerance);
+  long long iz = std::floor(p.Z() / tolerance);
+
+  for (long long dx=-1; dx <= 1; ++dx) {
+      for (long long dy=-1; dy <= 1; ++dy) {
+          for (long long dz=-1; dz <= 1; ++dz) {
+              auto it = grid.find(cellKey(ix + dx, iy + dy, iz + dz));
+
+              if (it == grid.end()) continue;
+              for (int id : it->second)
+                  if (points[id].Distance(p) < tolerance) return id;
+              }
+          }
+      }
+  int id = points.size();
+
+  points.push_back(p);
+  grid[cellKey(ix, iy, iz)].push_back(id);
+
+  return id;
+  }
+
+
+TopoDS_Wire EdgeChainer::toWire(const EdgeChain& c) {
+  BRep_Builder builder;
+  TopoDS_Wire  wire;
+
+  builder.MakeWire(wire);
+  for (const auto& e : c.edges) builder.Add(wire, e);
+  wire.Closed(c.closed);
+
+  return wire;
+  }
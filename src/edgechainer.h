@@ -0,0 +1,80 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       edgechainer.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef EDGECHAINER_H
+#define EDGECHAINER_H
+#include "kuteCAM.h"
+#include <gp_Pnt.hxx>
+#include <TopoDS_Edge.hxx>
+#include <TopoDS_Wire.hxx>
+#include <unordered_map>
+#include <vector>
+
+
+// edges in order of the chain, each one oriented from start to end
+struct EdgeChain
+{
+  std::vector<TopoDS_Edge> edges;
+  gp_Pnt                   start;
+  gp_Pnt                   end;
+  bool                     closed = false;
+  };
+
+
+// open end of a chain and the nearest open end of any chain
+struct ChainGap
+{
+  gp_Pnt from;
+  gp_Pnt to;
+  double size;
+  };
+
+
+// assembles edges into chains. Endpoints closer than tolerance get
+// merged by a spatial hash with cell size of tolerance, so chaining
+// takes linear time. Open ends are reported as gaps, as they most
+// likely come from edges that don't quite meet.
+class EdgeChainer
+{
+public:
+  explicit EdgeChainer(double tolerance = kute::MinDelta);
+
+  std::vector<EdgeChain>       chain(const std::vector<TopoDS_Edge>& edges);
+  const std::vector<ChainGap>& gaps() const { return gapList; }
+
+  static TopoDS_Wire           toWire(const EdgeChain& c);
+
+protected:
+  void                         findGaps(const std::vector<EdgeChain>& chains);
+  int                          pointID(const gp_Pnt& p);
+
+private:
+  double                                          tolerance;
+  std::unordered_map<long long, std::vector<int>> grid;
+  std::vector<gp_Pnt>                             points;
+  std::vector<ChainGap>                           gapList;
+  };
+#endif // EDGECHAINER_H
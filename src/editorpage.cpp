@@ -28,21 +28,29 @@
 #include "ui_GCodeEditor.h"
 #include "gcodeeditor.h"
 #include "gcodehighlighter.h"
+#include "gcodeviewer.h"
 #include "kuteCAM.h"
 #include <QDebug>
 #include <QFileDialog>
+#include <QFileInfo>
+#include <QStackedWidget>
 
 
 EditorPage::EditorPage(QWidget *parent)
  : QWidget(parent)
  , ui(new Ui::GCodeEditorPage)
  , ed(new GCodeEditor)
- , gh(new GCodeHighlighter(ed->document())) {
+ , gh(new GCodeHighlighter(ed->document()))
+ , viewer(new GCodeViewer)
+ , stack(new QStackedWidget) {
   ui->setupUi(this);
   connect(ui->pbOpen, &QPushButton::clicked, this, &EditorPage::openFile);
   connect(ui->pbSave, &QPushButton::clicked, this, &EditorPage::saveFile);
   connect(ed->document(), &QTextDocument::modificationChanged, this, &EditorPage::dirtyChanged);
-  ui->gridLayout->replaceWidget(ui->widget, ed);
+  viewer->setHighlighter(gh);
+  stack->addWidget(ed);
+  stack->addWidget(viewer);
+  ui->gridLayout->replaceWidget(ui->widget, stack);
   }
 
 
@@ -74,8 +82,19 @@ void EditorPage::dirtyChanged(bool dirty) {
   }
 
 
+// huge files are shown read only, without building a text document
 void EditorPage::loadFile(const QString &fileName) {
-  if (ed->loadFile(fileName)) {
+  if (QFileInfo(fileName).size() > LargeFileSize) {
+     if (viewer->loadFile(fileName)) {
+        ed->clear();
+        stack->setCurrentWidget(viewer);
+        ui->pbSave->setEnabled(false);
+        ui->fileName->setText(tr("%1 [read only]").arg(fileName));
+        }
+     }
+  else if (ed->loadFile(fileName)) {
+     viewer->close();
+     stack->setCurrentWidget(ed);
      ui->fileName->setText(fileName);
      }
   }
@@ -115,5 +134,5 @@ void EditorPage::saveFile() {
 
 
 void EditorPage::showEvent(QShowEvent *event) {
-  ed->setFocus();
+  stack->currentWidget()->setFocus();
   }
@@ -32,6 +32,8 @@ class GCodeEditorPage;
 }
 class GCodeEditor;
 class GCodeHighlighter;
+class GCodeViewer;
+class QStackedWidget;
 
 
 class EditorPage : public QWidget
@@ -42,6 +44,8 @@ public:
 
   void loadFile(const QString& fileName);
 
+  static const qint64 LargeFileSize = 20 * 1024 * 1024;
+
 protected:
   QString chooseGCodeFile(QWidget* parent = nullptr);
   void    showEvent(QShowEvent *event);
@@ -55,6 +59,8 @@ private:
   Ui::GCodeEditorPage* ui;
   GCodeEditor*         ed;
   GCodeHighlighter*    gh;
+  GCodeViewer*         viewer;
+  QStackedWidget*      stack;
   QString              fileName;
   };
 #endif // EDITORPAGE_H
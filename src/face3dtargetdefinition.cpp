@@ -0,0 +1,87 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       face3dtargetdefinition.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "face3dtargetdefinition.h"
+#include <BRepBndLib.hxx>
+#include <BRepTools.hxx>
+#include <BRep_Builder.hxx>
+#include <Bnd_Box.hxx>
+#include <TopExp_Explorer.hxx>
+#include <QSettings>
+#include <sstream>
+
+
+static gp_Pnt centerOf(const TopoDS_Shape& s) {
+  Bnd_Box bb;
+
+  if (s.IsNull()) return gp_Pnt();
+  BRepBndLib::Add(s, bb);
+  if (bb.IsVoid()) return gp_Pnt();
+
+  return gp_Pnt((bb.CornerMin().XYZ() + bb.CornerMax().XYZ()) / 2);
+  }
+
+
+Face3DTargetDefinition::Face3DTargetDefinition(const TopoDS_Shape& faces, QObject* parent)
+ : TargetDefinition(centerOf(faces), 0, parent)
+ , shape(faces) {
+  }
+
+
+Face3DTargetDefinition::Face3DTargetDefinition(QSettings& s, QObject* parent)
+ : TargetDefinition(s, parent) {
+  std::istringstream is(s.value("f3d-faces").toString().toStdString());
+  BRep_Builder       builder;
+
+  BRepTools::Read(shape, is, builder);
+  }
+
+
+int Face3DTargetDefinition::faceCount() const {
+  int n = 0;
+
+  for (TopExp_Explorer e(shape, TopAbs_FACE); e.More(); e.Next()) ++n;
+  return n;
+  }
+
+
+void Face3DTargetDefinition::store(QSettings& s) {
+  std::ostringstream os;
+
+  s.setValue("tdType", "Face3DTarget");
+  TargetDefinition::store(s);
+  BRepTools::Write(shape, os);
+  s.setValue("f3d-faces", QString::fromStdString(os.str()));
+  }
+
+
+QString Face3DTargetDefinition::toString() const {
+  QString rv = QString("%1 faces around\t%2\t/\t%3\t/\t%4").arg(faceCount())
+                                                          .arg(pos().X(), 0, 'f', 3)
+                                                          .arg(pos().Y(), 0, 'f', 3)
+                                                          .arg(pos().Z(), 0, 'f', 3);
+  return rv;
+  }
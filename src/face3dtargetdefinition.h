@@ -0,0 +1,51 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       face3dtargetdefinition.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef FACE3DTARGETDEFINITION_H
+#define FACE3DTARGETDEFINITION_H
+#include "targetdefinition.h"
+#include <TopoDS_Shape.hxx>
+
+
+// selected freeform faces of a 3D-surface operation. The faces get
+// stored as BRep text with the project.
+class Face3DTargetDefinition : public TargetDefinition
+{
+  Q_OBJECT
+public:
+  explicit Face3DTargetDefinition(const TopoDS_Shape& faces, QObject* parent = nullptr);
+  explicit Face3DTargetDefinition(QSettings& settings, QObject* parent = nullptr);
+  virtual ~Face3DTargetDefinition() = default;
+
+  TopoDS_Shape faces() const { return shape; }
+  int          faceCount() const;
+  void         store(QSettings& s) override;
+  QString      toString() const override;
+
+private:
+  TopoDS_Shape shape;
+  };
+#endif // FACE3DTARGETDEFINITION_H
@@ -0,0 +1,283 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       featurehasher.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "featurehasher.h"
+#include "gocontour.h"
+#include "graphicobject.h"
+#include "targetdefinition.h"
+#include "workstep.h"
+#include "wsarc.h"
+#include "wsstraightmove.h"
+#include "wstraverse.h"
+#include "kuteCAM.h"
+#include "tracer.h"
+#include <BRepGProp.hxx>
+#include <BRep_Tool.hxx>
+#include <GProp_GProps.hxx>
+#include <TopExp.hxx>
+#include <TopoDS.hxx>
+#include <TopTools_IndexedMapOfShape.hxx>
+#include <gp_Ax1.hxx>
+#include <gp_Vec.hxx>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+
+FeatureHasher::FeatureHasher(double tolerance)
+ : tolerance(tolerance) {
+  }
+
+
+// cut parts of both targets have to match vertex by vertex after
+// placement, which covers islands and floor heights. Volume catches
+// differences between the vertices (i.e. curved floors).
+bool FeatureHasher::congruent(const TopoDS_Shape& rep, const TopoDS_Shape& cand, const gp_Trsf& placement) const {
+  TopTools_IndexedMapOfShape rVertices;
+  TopTools_IndexedMapOfShape cVertices;
+  GProp_GProps               rProps;
+  GProp_GProps               cProps;
+  std::vector<gp_Pnt>        cPoints;
+
+  if (rep.IsNull() || cand.IsNull()) return false;
+  TopExp::MapShapes(rep,  TopAbs_VERTEX, rVertices);
+  TopExp::MapShapes(cand, TopAbs_VERTEX, cVertices);
+  if (rVertices.Extent() != cVertices.Extent()) return false;
+  BRepGProp::VolumeProperties(rep,  rProps);
+  BRepGProp::VolumeProperties(cand, cProps);
+  if (std::abs(rProps.Mass() - cProps.Mass()) > 1e-4 * std::max(1.0, std::abs(rProps.Mass()))) return false;
+  cPoints.reserve(cVertices.Extent());
+  for (int i=1; i <= cVertices.Extent(); ++i)
+      cPoints.push_back(BRep_Tool::Pnt(TopoDS::Vertex(cVertices(i))));
+  std::sort(cPoints.begin(), cPoints.end(), [](const gp_Pnt& a, const gp_Pnt& b) { return a.X() < b.X(); });
+
+  for (int i=1; i <= rVertices.Extent(); ++i) {
+      gp_Pnt p     = BRep_Tool::Pnt(TopoDS::Vertex(rVertices(i))).Transformed(placement);
+      auto   it    = std::lower_bound(cPoints.begin(), cPoints.end(), p.X() - tolerance
+                                    , [](const gp_Pnt& a, double x) { return a.X() < x; });
+      bool   found = false;
+
+      for (; it != cPoints.end() && it->X() <= p.X() + tolerance; ++it) {
+          if (it->Distance(p) <= tolerance) {
+             found = true;
+             break;
+             }
+          }
+      if (!found) return false;
+      }
+  return true;
+  }
+
+
+// least squares rotation of the centered outlines (2D kabsch).
+// Outline of the candidate gets walked starting at shift, in
+// reverse direction if requested.
+bool FeatureHasher::fit(const Signature& rep, const Signature& cand, int shift, bool reverse, gp_Trsf& placement) const {
+  int    n   = rep.outline.size();
+  double dot = 0;
+  double crs = 0;
+  auto   at  = [&](int i) -> const gp_Pnt& {
+    int k = reverse ? shift - i : shift + i;
+
+    return cand.outline[((k % n) + n) % n];
+    };
+
+  for (int i=0; i < n; ++i) {
+      double px = rep.outline[i].X() - rep.centroid.X();
+      double py = rep.outline[i].Y() - rep.centroid.Y();
+      double qx = at(i).X() - cand.centroid.X();
+      double qy = at(i).Y() - cand.centroid.Y();
+
+      dot += px * qx + py * qy;
+      crs += px * qy - py * qx;
+      }
+  gp_Trsf rot;
+  gp_Trsf move;
+
+  rot.SetRotation(gp_Ax1(rep.centroid, gp_Dir(0, 0, 1)), std::atan2(crs, dot));
+  move.SetTranslation(gp_Vec(rep.centroid, cand.centroid));
+  placement = move.Multiplied(rot);
+
+  for (int i=0; i < n; ++i) {
+      if (rep.outline[i].Transformed(placement).Distance(at(i)) > tolerance) return false;
+      }
+  return true;
+  }
+
+
+// targets, that are not congruent to any other, end up in
+// a group without copies. Congruent targets right at the border
+// of a bucket just don't get instanced.
+std::vector<FeatureGroup> FeatureHasher::group(const std::vector<TargetDefinition*>& targets, const Bnd_Box& bounds) const {
+  TraceSpan                                         span("FeatureHasher::group");
+  std::vector<FeatureGroup>                         rv;
+  std::vector<Signature>                            sigs;
+  std::unordered_map<std::string, std::vector<int>> buckets;     // key -> index of group
+
+  sigs.reserve(targets.size());
+  for (const TargetDefinition* td : targets) sigs.push_back(signature(td, bounds));
+
+  for (int i=0; i < (int)targets.size(); ++i) {
+      const Signature& s = sigs[i];
+
+      if (s.valid) {
+         std::vector<int>& candidates = buckets[s.key];
+         bool              found      = false;
+
+         for (int g : candidates) {
+             gp_Trsf placement;
+
+             if (!match(sigs[rv[g].representative], s, placement)) continue;
+             rv[g].copies.push_back({i, placement});
+             found = true;
+             break;
+             }
+         if (found) continue;
+         candidates.push_back(rv.size());
+         }
+      rv.push_back({i, {}});
+      }
+  qCDebug(lcPath) << "feature hasher:" << targets.size() << "targets in" << rv.size() << "groups";
+
+  return rv;
+  }
+
+
+bool FeatureHasher::match(const Signature& rep, const Signature& cand, gp_Trsf& placement) const {
+  int n = rep.outline.size();
+
+  if (n != (int)cand.outline.size() || rep.closed != cand.closed) return false;
+  if (std::abs(rep.zMin - cand.zMin) > tolerance
+   || std::abs(rep.zMax - cand.zMax) > tolerance) return false;
+  if (!rep.closed) return fit(rep, cand, 0, false, placement)
+                       || fit(rep, cand, n - 1, true, placement);
+  for (int shift=0; shift < n; ++shift) {
+      if (fit(rep, cand, shift, false, placement)) return true;
+      if (fit(rep, cand, shift, true,  placement)) return true;
+      }
+  return false;
+  }
+
+
+// arcs keep their direction, as a rigid transform
+// without mirroring does not change it
+std::vector<Workstep*> FeatureHasher::placeCopy(const std::vector<Workstep*>& path, const gp_Trsf& placement) {
+  std::vector<Workstep*> rv;
+
+  rv.reserve(path.size());
+  for (const Workstep* ws : path) {
+      gp_Pnt    from = ws->startPos().Transformed(placement);
+      gp_Pnt    to   = ws->endPos().Transformed(placement);
+      Workstep* copy = nullptr;
+
+      switch (ws->type()) {
+        case WTTraverse:
+             copy = new WSTraverse(from, to);
+             break;
+        case WTStraightMove:
+             copy = new WSStraightMove(from, to);
+             break;
+        case WTArc: {
+             const WSArc* wa = static_cast<const WSArc*>(ws);
+
+             copy = new WSArc(from, to, wa->centerPos().Transformed(placement), wa->isCCW());
+             } break;
+        default: break;
+        }
+      if (!copy) continue;
+      copy->setColor(ws->color());
+      rv.push_back(copy);
+      }
+  return rv;
+  }
+
+
+// cylindrical targets are described by their radius, contours by
+// the start points of their segments plus the midpoints of arcs.
+// Targets not completely inside of bounds depend on the border of
+// the workpiece and never get instanced.
+FeatureHasher::Signature FeatureHasher::signature(const TargetDefinition* td, const Bnd_Box& bounds) const {
+  Signature rv;
+  Bnd_Box   bb;
+  double    q      = tolerance * 10;   // bucket size
+  double    length = 0;
+
+  if (!td) return rv;
+  if (td->radius() > 0) {
+     gp_Pnt c(td->pos().X(), td->pos().Y(), 0);
+
+     rv.outline.push_back(c);
+     bb.Add(gp_Pnt(c.X() - td->radius(), c.Y() - td->radius(), 0));
+     bb.Add(gp_Pnt(c.X() + td->radius(), c.Y() + td->radius(), 0));
+     rv.key = "C";
+     length = 2 * M_PI * td->radius();
+     }
+  else {
+     GOContour* contour = td->contour();
+
+     if (!contour || !contour->size()) return rv;
+     auto flat = [](const gp_Pnt& p) { return gp_Pnt(p.X(), p.Y(), 0); };
+
+     for (GraphicObject* go : contour->segments()) {
+         rv.outline.push_back(flat(go->startPoint()));
+         if (go->type() == GTCircle) rv.outline.push_back(flat(go->midPoint()));
+         }
+     rv.closed = contour->isClosed();
+     if (!rv.closed) rv.outline.push_back(flat(contour->endPoint()));
+     for (int i=1; i < (int)rv.outline.size(); ++i)
+         length += rv.outline[i - 1].Distance(rv.outline[i]);
+     for (auto& p : rv.outline) bb.Add(p);
+     rv.key = rv.closed ? "P" : "O";
+     }
+  if (!bounds.IsVoid()) {
+     gp_Pnt bMin = bounds.CornerMin();
+     gp_Pnt bMax = bounds.CornerMax();
+     gp_Pnt cMin = bb.CornerMin();
+     gp_Pnt cMax = bb.CornerMax();
+
+     if (cMin.X() <= bMin.X() + tolerance || cMax.X() >= bMax.X() - tolerance
+      || cMin.Y() <= bMin.Y() + tolerance || cMax.Y() >= bMax.Y() - tolerance) return rv;
+     }
+  double x = 0, y = 0;
+
+  for (auto& p : rv.outline) {
+      x += p.X();
+      y += p.Y();
+      }
+  rv.centroid = gp_Pnt(x / rv.outline.size(), y / rv.outline.size(), 0);
+  rv.zMin     = td->zMin();
+  rv.zMax     = td->zMax();
+  rv.key     += QString(":%1:%2:%3:%4:%5").arg(rv.outline.size())
+                                          .arg(std::lround(length / q))
+                                          .arg(std::lround(td->radius() / q))
+                                          .arg(std::lround(td->zMin() / q))
+                                          .arg(std::lround(td->zMax() / q))
+                                          .toStdString();
+  rv.valid    = true;
+
+  return rv;
+  }
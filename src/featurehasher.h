@@ -0,0 +1,88 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       featurehasher.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef FEATUREHASHER_H
+#define FEATUREHASHER_H
+#include <Bnd_Box.hxx>
+#include <gp_Pnt.hxx>
+#include <gp_Trsf.hxx>
+#include <TopoDS_Shape.hxx>
+#include <string>
+#include <vector>
+class TargetDefinition;
+class Workstep;
+
+
+struct FeatureInstance
+{
+  int     target;         // index into the target list
+  gp_Trsf placement;      // maps the representative onto this target
+  };
+
+
+struct FeatureGroup
+{
+  int                          representative;
+  std::vector<FeatureInstance> copies;
+  };
+
+
+// finds targets of an operation, that are congruent up to a rotation
+// around Z and a translation. Targets get bucketed by a hash of their
+// invariants first, so only candidates with same size and depth get
+// compared point by point. Depths have to match within tolerance, as
+// placement does not move in Z. Mirrored features never match, as
+// that would turn climb into conventional milling.
+// Outlines say nothing about islands or floor of a pocket, so
+// callers check cut parts of copies with congruent() before placing.
+class FeatureHasher
+{
+public:
+  explicit FeatureHasher(double tolerance = 0.01);
+
+  bool                      congruent(const TopoDS_Shape& rep, const TopoDS_Shape& cand, const gp_Trsf& placement) const;
+  std::vector<FeatureGroup> group(const std::vector<TargetDefinition*>& targets, const Bnd_Box& bounds) const;
+
+  static std::vector<Workstep*> placeCopy(const std::vector<Workstep*>& path, const gp_Trsf& placement);
+
+protected:
+  struct Signature {
+    std::string         key;
+    std::vector<gp_Pnt> outline;    // projected to Z = 0
+    gp_Pnt              centroid;
+    double              zMin   = 0;
+    double              zMax   = 0;
+    bool                closed = true;
+    bool                valid  = false;
+    };
+  bool      fit(const Signature& rep, const Signature& cand, int shift, bool reverse, gp_Trsf& placement) const;
+  bool      match(const Signature& rep, const Signature& cand, gp_Trsf& placement) const;
+  Signature signature(const TargetDefinition* td, const Bnd_Box& bounds) const;
+
+private:
+  double tolerance;
+  };
+#endif // FEATUREHASHER_H
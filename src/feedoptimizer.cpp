@@ -0,0 +1,104 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       feedoptimizer.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "feedoptimizer.h"
+#include "kuteCAM.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include "workstep.h"
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+
+FeedOptimizer::FeedOptimizer(const StockModel& stock, const ToolEntry* tool, double feed, double ae, double ap)
+ : stock(stock)
+ , lift(0)
+ , feed(feed)
+ , section(ae * ap)
+ , minFactor(0.5)
+ , maxFactor(1.5)
+ , maxFeed(0)
+ , valid(false) {
+  valid = feed > 0 && section > 0 && StockModel::cutterOf(tool, cutter, lift);
+  }
+
+
+double FeedOptimizer::length(const Workstep* ws) const {
+  std::vector<gp_Pnt> pl = stock.polylineOf(ws, 0);
+  double              rv = 0;
+
+  for (int i=1; i < (int)pl.size(); ++i) rv += pl[i - 1].Distance(pl[i]);
+
+  return rv;
+  }
+
+
+// feed for each move of path. Rapids and cycles get 0. Moves too
+// short to measure engagement keep the feed of the move before, and
+// plunges never run faster than nominal.
+std::vector<double> FeedOptimizer::optimize(const std::vector<Workstep*>& path) {
+  TraceSpan           span("FeedOptimizer::optimize");
+  std::vector<double> rv(path.size(), 0);
+
+  if (!valid) return rv;
+  std::vector<double> volume = stock.removal(path, cutter, lift);
+  double              last   = 1;
+
+  for (int i=0; i < (int)path.size(); ++i) {
+      const Workstep* ws = path[i];
+
+      if (ws->type() != WTStraightMove && ws->type() != WTArc) continue;
+      double len    = length(ws);
+      double factor = last;
+
+      if (len > stock.cellSize()) {
+         double area = volume[i] / len;
+
+         factor = area > kute::MinDelta ? section / area : maxFactor;
+         }
+      double dz = ws->endPos().Z() - ws->startPos().Z();
+      double dl = std::hypot(ws->endPos().X() - ws->startPos().X(), ws->endPos().Y() - ws->startPos().Y());
+
+      factor = std::max(minFactor, std::min(maxFactor, factor));
+      factor = std::round(factor / Quantum) * Quantum;
+      last   = factor;
+      if (dz < 0 && -dz > dl) factor = std::min(factor, 1.0);
+      rv[i] = feed * factor;
+      if (maxFeed > 0) rv[i] = std::min(rv[i], maxFeed);
+      }
+  return rv;
+  }
+
+
+void FeedOptimizer::setLimits(double minFactor, double maxFactor, double maxFeed) {
+  this->minFactor = std::max(0.1, minFactor);
+  this->maxFactor = std::max(this->minFactor, maxFactor);
+  this->maxFeed   = maxFeed;
+  }
+
+
+const double FeedOptimizer::Quantum = 0.05;
@@ -0,0 +1,65 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       feedoptimizer.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef FEEDOPTIMIZER_H
+#define FEEDOPTIMIZER_H
+#include "stockmodel.h"
+#include <vector>
+class ToolEntry;
+class Workstep;
+
+
+// scales the feed of each move by its engagement. Removed volume per
+// length of a move gets compared to the cross section of the nominal
+// cut (ae * ap), so light cuts run faster and heavy engagement (i.e.
+// full slots) slower, keeping the removal rate near nominal. Factors
+// are limited by tool (min/max factor) and machine (max feed).
+class FeedOptimizer
+{
+public:
+  FeedOptimizer(const StockModel& stock, const ToolEntry* tool, double feed, double ae, double ap);
+
+  bool                isValid() const { return valid; }
+  std::vector<double> optimize(const std::vector<Workstep*>& path);
+  void                setLimits(double minFactor, double maxFactor, double maxFeed = 0);
+
+protected:
+  double              length(const Workstep* ws) const;
+
+  static const double Quantum;   // factors get rounded to multiples
+
+private:
+  StockModel  stock;
+  CutterShape cutter;
+  double      lift;
+  double      feed;
+  double      section;           // mm², nominal cross section of the cut
+  double      minFactor;
+  double      maxFactor;
+  double      maxFeed;
+  bool        valid;
+  };
+#endif // FEEDOPTIMIZER_H
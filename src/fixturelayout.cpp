@@ -0,0 +1,128 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       fixturelayout.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "fixturelayout.h"
+#include "operation.h"
+#include "projectfile.h"
+#include <QVector3D>
+#include <algorithm>
+
+
+FixtureLayout::FixtureLayout()
+ : cfgMode(WorkOffsets) {
+  }
+
+
+void FixtureLayout::add(int fixture, const gp_Vec& offset) {
+  fixtures.push_back({fixture, offset});
+  }
+
+
+void FixtureLayout::clear() {
+  fixtures.clear();
+  }
+
+
+// every operation gets written at least once
+int FixtureLayout::count() const {
+  return std::max(1, static_cast<int>(fixtures.size()));
+  }
+
+
+int FixtureLayout::fixture(int i, const Operation* op) const {
+  if (fixtures.empty() || isShifted(op)) return op->fixture();
+  return fixtures.at(i).fixture;
+  }
+
+
+QStringList FixtureLayout::fixtureNames() {
+  return QStringList() << "G53"
+                       << "G54"
+                       << "G55"
+                       << "G56"
+                       << "G57"
+                       << "G58"
+                       << "G59"
+                       << "G59.1"
+                       << "G59.2"
+                       << "G59.3";
+  }
+
+
+// a translated copy is only valid for operations without rotation.
+// Rotated operations switch the work offset in either mode.
+bool FixtureLayout::isShifted(const Operation* op) const {
+  return cfgMode == TransformedCopies
+      && !op->operationA()
+      && !op->operationB()
+      && !op->operationC();
+  }
+
+
+void FixtureLayout::load(ProjectFile* pf) {
+  fixtures.clear();
+  cfgMode = WorkOffsets;
+  if (!pf) return;
+  pf->beginGroup("Setup");
+  int mx = pf->beginReadArray("Fixtures");
+
+  for (int i=0; i < mx; ++i) {
+      pf->setArrayIndex(i);
+      QVector3D off = pf->value("offset").value<QVector3D>();
+
+      add(pf->value("fixture", 1).toInt(), gp_Vec(off.x(), off.y(), off.z()));
+      }
+  pf->endArray();
+  if (pf->value("fixture-copies").toBool()) cfgMode = TransformedCopies;
+  pf->endGroup();
+  }
+
+
+gp_Trsf FixtureLayout::shift(int i, const Operation* op) const {
+  gp_Trsf rv;
+
+  if (!fixtures.empty() && isShifted(op)) rv.SetTranslation(fixtures.at(i).offset);
+
+  return rv;
+  }
+
+
+void FixtureLayout::store(ProjectFile* pf) const {
+  if (!pf) return;
+  pf->beginGroup("Setup");
+  pf->remove("Fixtures");
+  pf->beginWriteArray("Fixtures", fixtures.size());
+  for (int i=0; i < (int)fixtures.size(); ++i) {
+      const FixtureInstance& fi = fixtures.at(i);
+
+      pf->setArrayIndex(i);
+      pf->setValue("fixture", fi.fixture);
+      pf->setValue("offset", QVector3D(fi.offset.X(), fi.offset.Y(), fi.offset.Z()));
+      }
+  pf->endArray();
+  pf->setValue("fixture-copies", cfgMode == TransformedCopies);
+  pf->endGroup();
+  }
@@ -0,0 +1,79 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       fixturelayout.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef FIXTURELAYOUT_H
+#define FIXTURELAYOUT_H
+#include <gp_Trsf.hxx>
+#include <gp_Vec.hxx>
+#include <QStringList>
+#include <vector>
+class Operation;
+class ProjectFile;
+
+
+struct FixtureInstance
+{
+  int    fixture = 1;     // work offset, same index as Operation::fixture()
+  gp_Vec offset;          // position relative to the programmed part
+  };
+
+
+// the same part clamped in several vises. Toolpaths get generated
+// once and written per instance - either by switching the work
+// offset, or as translated copy for controllers, that need absolute
+// coordinates. Without instances every operation uses its own fixture.
+class FixtureLayout
+{
+public:
+  enum Mode
+  {
+    WorkOffsets
+  , TransformedCopies
+    };
+  FixtureLayout();
+
+  void                                add(int fixture, const gp_Vec& offset = gp_Vec());
+  void                                clear();
+  int                                 count() const;
+  int                                 fixture(int i, const Operation* op) const;
+  const std::vector<FixtureInstance>& instances() const { return fixtures; }
+  bool                                isEmpty() const   { return fixtures.empty(); }
+  void                                load(ProjectFile* pf);
+  Mode                                mode() const      { return cfgMode; }
+  void                                setMode(Mode m)   { cfgMode = m; }
+  gp_Trsf                             shift(int i, const Operation* op) const;
+  void                                store(ProjectFile* pf) const;
+
+  static QStringList                  fixtureNames();
+
+protected:
+  bool                                isShifted(const Operation* op) const;
+
+private:
+  std::vector<FixtureInstance> fixtures;
+  Mode                         cfgMode;
+  };
+#endif // FIXTURELAYOUT_H
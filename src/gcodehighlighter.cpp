@@ -24,6 +24,22 @@
  * **************************************************************************
  */
 #include "gcodehighlighter.h"
+#include <cstring>
+
+
+static inline bool isAlpha(ushort c) {
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+  }
+
+
+static inline bool isDigit(ushort c) {
+  return c >= '0' && c <= '9';
+  }
+
+
+static inline bool isBlank(ushort c) {
+  return c == ' ' || c == '\t';
+  }
 
 
 GCodeHighlighter::GCodeHighlighter(QTextDocument* parent)
@@ -39,200 +55,241 @@ GCodeHighlighter::GCodeHighlighter(QObject* parent)
 
 
 GCodeHighlighter::GCodeHighlighter(const GCodeHighlighter& other)
- : QSyntaxHighlighter(other.parent())
- , highlightingRules(other.highlightingRules) {
+ : QSyntaxHighlighter(other.parent()) {
+  for (int i=0; i < TkCount; ++i) tokenFormats[i] = other.tokenFormats[i];
   }
 
 
-void GCodeHighlighter::highlightBlock(const QString& text) {
-  for (const HighlightingRule& rule : qAsConst(highlightingRules)) {
-      QRegularExpressionMatchIterator matchIterator = rule.pattern.globalMatch(text);
+// single scan over the line. Words are letter + number, multi letter
+// words are looked up as a whole. Heidenhain keywords count at line
+// start only (after an optional block number).
+QVector<QTextLayout::FormatRange> GCodeHighlighter::formats(const QString& text) const {
+  QVector<QTextLayout::FormatRange> rv;
+  const QChar* s         = text.constData();
+  int          n         = text.size();
+  int          i         = 0;
+  bool         lineStart = true;
+  auto at = [&](int k) -> ushort {
+    return k < n ? s[k].unicode() : 0;
+    };
+  auto skipBlank = [&](int k) {
+    while (k < n && isBlank(s[k].unicode())) ++k;
+    return k;
+    };
+  auto skipAlpha = [&](int k) {
+    while (k < n && isAlpha(s[k].unicode())) ++k;
+    return k;
+    };
+  auto skipDigits = [&](int k) {
+    while (k < n && isDigit(s[k].unicode())) ++k;
+    return k;
+    };
+  auto is = [&](int k, int e, const char* word) {
+    int l = strlen(word);
+
+    if (e - k != l) return false;
+    for (int j=0; j < l; ++j)
+        if (s[k + j].unicode() != static_cast<ushort>(word[j])) return false;
+    return true;
+    };
+  auto add = [&](int start, int end, Token t) {
+    rv.append({ start, end - start, tokenFormats[t] });
+    return end;
+    };
+
+  while (i < n) {
+        ushort c = s[i].unicode();
+
+        if (isBlank(c)) {
+           ++i;
+           continue;
+           }
+        if (c == ';') {
+           add(i, n, TkComment);
+           break;
+           }
+        if (c == '(') {
+           int e = text.indexOf(')', i + 1);
+
+           i         = add(i, e < 0 ? n : e + 1, TkComment);
+           lineStart = false;
+           continue;
+           }
+        if (c == '#' && at(i + 1) == '<') {
+           int e = text.indexOf('>', i + 2);
+
+           if (e > 0) {
+              i = add(i, e + 1, TkVariable);
+              continue;
+              }
+           }
+        if (c == '=') {
+           i = add(i, i + 1, TkAssign);
+           continue;
+           }
+        if (isDigit(c) && lineStart) {      // heidenhain block number
+           i = skipDigits(i);
+           continue;
+           }
+        if (!isAlpha(c)) {
+           ++i;
+           lineStart = false;
+           continue;
+           }
+        int  w     = skipAlpha(i);
+        bool start = lineStart;
+
+        lineStart = false;
+        if (w - i > 1) {
+           int k = skipBlank(w);
+           int e = 0;
+
+           if (start && is(i, w, "CC")) {
+              i = add(i, w, TkGCode);
+              }
+           else if (is(i, w, "CYCLE")) {
+              if (isDigit(at(w))) {
+                 i = add(i, skipDigits(w), TkCycleCall);
+                 }
+              else if (start && is(k, e = skipAlpha(k), "DEF") && isDigit(at(skipBlank(e)))) {
+                 i = add(i, skipDigits(skipBlank(e)), TkGCode);
+                 }
+              else i = w;
+              }
+           else if (start && is(i, w, "TOOL") && is(k, e = skipAlpha(k), "DEF")) {
+              i = add(i, skipBlank(e), TkToolDef);
+              }
+           else if (start && is(i, w, "TOOL") && is(k, e = skipAlpha(k), "CALL")) {
+              int d = skipDigits(skipBlank(e));
+              int a = skipBlank(d);
+
+              if (d > skipBlank(e) && (at(a) == 'X' || at(a) == 'Y' || at(a) == 'Z')) i = add(i, a + 1, TkToolCall);
+              else                                                                    i = w;
+              }
+           else if (start && is(i, w, "BLK") && is(k, e = skipAlpha(k), "FORM")) {
+              int d = skipBlank(e);
+
+              if (at(d) == '0' && at(d + 1) == '.' && (at(d + 2) == '1' || at(d + 2) == '2')) {
+                 int z = skipBlank(d + 3);
+
+                 if (at(z) == 'Z' && isBlank(at(z + 1))) z = skipBlank(z + 1);
+                 i = add(i, z, TkBlkForm);
+                 }
+              else i = w;
+              }
+           else if ((is(i, w, "BEGIN") || is(i, w, "END")) && is(k, e = skipAlpha(k), "PGM")) {
+              int name = skipBlank(e);
+              int mm   = name;
+
+              while (mm < n && !isBlank(s[mm].unicode())) ++mm;
+              mm = skipBlank(mm);
+              if (mm > name && is(mm, skipAlpha(mm), "MM")) i = add(i, mm + 2, TkPgm);
+              else                                          i = w;
+              }
+           else if (is(i, w, "MCALL"))                   i = add(i, w, TkCycleCall);
+           else if (is(i, w, "FMAX"))                    i = add(i, w, TkFMax);
+           else if (is(i, w, "RR") || is(i, w, "RL"))    i = add(i, w, TkRadiusComp);
+           else if (is(i, w, "DR") && (at(w) == '+' || at(w) == '-'))
+                                                         i = add(i, w + 1, TkRadiusComp);
+           else                                          i = w;
+           continue;
+           }
+        // single letter: optional sign, digits, decimal point or comma
+        int j  = at(w) == '+' || at(w) == '-' ? w + 1 : w;
+        int ds = j;
+
+        j = skipDigits(j);
+        int intDigits = j - ds;
+
+        if (intDigits && (at(j) == '.' || at(j) == ',')) j = skipDigits(j + 1);
+        if (start && (c == 'L' || c == 'C') && isBlank(at(w))) {
+           i = add(i, w, TkRapid);
+           continue;
+           }
+        if (!intDigits) {
+           switch (c) {
+             case 'T': case 'H': case 'D': add(i, w, TkTool);  break;
+             case 'F':                     add(i, w, TkFeed);  break;
+             case 'S':                     add(i, w, TkSpeed); break;
+             default: break;
+             }
+           i = w;
+           continue;
+           }
+        switch (c) {
+          case 'N':
+               if (ds == w) add(i, j, TkLineNum);
+               break;
+          case 'G':
+               if (intDigits == 1 && j == ds + 1) add(i, j, at(ds) == '0' ? TkRapid
+                                                          : at(ds) <= '3' ? TkFeedMove
+                                                          : TkGCode);
+               else add(i, j, TkGCode);
+               break;
+          case 'M':
+               add(i, j, TkMCode);
+               break;
+          case 'A': case 'B': case 'C': case 'U': case 'V': case 'X': case 'Y':
+               add(i, j, TkAxis);
+               break;
+          case 'W': case 'Z':
+               add(i, j, TkZAxis);
+               break;
+          case 'R':
+               add(i, j, j == ds + 1 && at(ds) == '0' ? TkRadiusComp : TkParam);
+               break;
+          case 'E': case 'I': case 'J': case 'K': case 'L': case 'Q':
+               add(i, j, TkParam);
+               break;
+          case 'T': case 'H': case 'D':
+               add(i, j, TkTool);
+               break;
+          case 'F':
+               add(i, j, TkFeed);
+               break;
+          case 'S':
+               add(i, j, TkSpeed);
+               break;
+          default: break;
+          }
+        i = j;
+        }
+  return rv;
+  }
 
-      while (matchIterator.hasNext()) {
-            QRegularExpressionMatch match = matchIterator.next();
 
-            setFormat(match.capturedStart(), match.capturedLength(), rule.format);
-            }
-      }
+void GCodeHighlighter::highlightBlock(const QString& text) {
+  for (const QTextLayout::FormatRange& r : formats(text))
+      setFormat(r.start, r.length, r.format);
   }
 
 
 void GCodeHighlighter::setup() {
-  HighlightingRule rule;
-  QTextCharFormat gcFormat;
-
-  gcFormat.setForeground(Qt::lightGray);
-  gcFormat.setFontItalic(true);
-  gcFormat.setFontWeight(QFont::Normal);
-  rule.pattern = QRegularExpression(QStringLiteral("\\bN\\d+\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkRed);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("\\bG\\d\\d+\\.?\\d*\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkYellow);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("="));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkYellow);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("(BEGIN|END)\\s+PGM\\s+\\S+\\s+MM"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkRed);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("^\\s*CC\\s+"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkRed);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("^\\s*CYCLE\\s+DEF\\s+\\d+"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::red);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("(?=G\\d\\D)G0"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(QColor(180, 0, 0));
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("(?=G\\d\\D)(G1|G2|G3)"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::red);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("^\\s*(L|C)\\s+"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkMagenta);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("\\bM\\d+\\.?\\d*\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkMagenta);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("\\bMCALL\\b|CYCLE\\d+"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkBlue);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Normal);
-  rule.pattern = QRegularExpression(QStringLiteral("\\b[ABCUVXY]([+-]?\\d+[,.]?\\d*|\\[.+?\\])\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::black);
-  gcFormat.setFontItalic(true);
-  gcFormat.setFontWeight(QFont::Bold);
-  rule.pattern = QRegularExpression(QStringLiteral("\\b[WZ]([+-]?\\d+[,.]?\\d*|\\[.+?\\])\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkCyan);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Normal);
-  rule.pattern = QRegularExpression(QStringLiteral("\\b[EIJKLQR]([+-]?\\d+[,.]?\\d*|\\[.+?\\])\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkCyan);
-  gcFormat.setFontItalic(false);
-  gcFormat.setFontWeight(QFont::Normal);
-  rule.pattern = QRegularExpression(QStringLiteral("\\bDR[+-]|R0|RR|RL\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkYellow);
-  gcFormat.setFontWeight(QFont::Bold);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral("\\b[THD]\\d*[,.]?\\d*\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::magenta);
-  gcFormat.setFontWeight(QFont::Bold);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral("\\bF\\d*[,.]?\\d*\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::magenta);
-  gcFormat.setFontWeight(QFont::Bold);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral("\\bS\\d*[,.]?\\d*\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::magenta);
-  gcFormat.setFontWeight(QFont::Normal);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral("\\bFMAX\\b"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkCyan);
-  gcFormat.setFontWeight(QFont::Normal);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral("^\\s*TOOL\\s+DEF\\s+"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::cyan);
-  gcFormat.setFontWeight(QFont::Bold);
-  gcFormat.setFontItalic(false);
-  rule.pattern = QRegularExpression(QStringLiteral("^\\s*TOOL\\s+CALL\\s+\\d+\\s+[XYZ]"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkCyan);
-  gcFormat.setFontWeight(QFont::Bold);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral("^\\s*BLK\\s+FORM\\s+(0\\.1|0\\.2)\\s+(Z\\s+)?"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::cyan);
-  gcFormat.setFontWeight(QFont::Bold);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral("#\\<.+?\\>"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkGreen);
-  gcFormat.setFontWeight(QFont::Normal);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral(";.*$"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
-
-  gcFormat.setForeground(Qt::darkGreen);
-  gcFormat.setFontWeight(QFont::Normal);
-  gcFormat.setFontItalic(true);
-  rule.pattern = QRegularExpression(QStringLiteral("\\(.+?\\)"));
-  rule.format = gcFormat;
-  highlightingRules.append(rule);
+  auto define = [this](Token t, const QColor& color, bool bold, bool italic) {
+    tokenFormats[t].setForeground(color);
+    tokenFormats[t].setFontWeight(bold ? QFont::Bold : QFont::Normal);
+    tokenFormats[t].setFontItalic(italic);
+    };
+
+  define(TkLineNum,    Qt::lightGray,      false, true);
+  define(TkGCode,      Qt::darkRed,        true,  false);
+  define(TkRapid,      Qt::red,            true,  false);
+  define(TkFeedMove,   QColor(180, 0, 0),  true,  false);
+  define(TkMCode,      Qt::darkMagenta,    true,  false);
+  define(TkCycleCall,  Qt::darkMagenta,    true,  false);
+  define(TkAxis,       Qt::darkBlue,       false, false);
+  define(TkZAxis,      Qt::black,          true,  true);
+  define(TkParam,      Qt::darkCyan,       false, false);
+  define(TkRadiusComp, Qt::darkCyan,       false, false);
+  define(TkTool,       Qt::darkYellow,     true,  true);
+  define(TkFeed,       Qt::magenta,        true,  true);
+  define(TkSpeed,      Qt::magenta,        true,  true);
+  define(TkFMax,       Qt::magenta,        false, true);
+  define(TkAssign,     Qt::darkYellow,     true,  false);
+  define(TkPgm,        Qt::darkYellow,     true,  false);
+  define(TkToolDef,    Qt::darkCyan,       false, true);
+  define(TkToolCall,   Qt::cyan,           true,  false);
+  define(TkBlkForm,    Qt::darkCyan,       true,  true);
+  define(TkVariable,   Qt::cyan,           true,  true);
+  define(TkComment,    Qt::darkGreen,      false, true);
   }
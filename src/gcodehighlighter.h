@@ -27,11 +27,13 @@
 #define GCODEHIGHLIGHTER_H
 
 #include <QSyntaxHighlighter>
-#include <QRegularExpression>
 #include <QTextCharFormat>
+#include <QTextLayout>
 #include <QVector>
 
 
+// one hand written scan per line recognizes all words of the dialects
+// we post (DIN, siemens, heidenhain conversational)
 class GCodeHighlighter : public QSyntaxHighlighter
 {
   Q_OBJECT
@@ -40,17 +42,38 @@ public:
   GCodeHighlighter(QObject* parent = nullptr);
   GCodeHighlighter(const GCodeHighlighter& other);
 
+  QVector<QTextLayout::FormatRange> formats(const QString& text) const;
   void highlightBlock(const QString &text) override;
 
+  enum Token {
+    TkLineNum
+  , TkGCode             // G-words, CC, CYCLE DEF
+  , TkRapid             // G0, heidenhain L and C
+  , TkFeedMove          // G1 - G3
+  , TkMCode
+  , TkCycleCall         // MCALL, CYCLExx
+  , TkAxis              // A B C U V X Y
+  , TkZAxis             // W Z
+  , TkParam             // E I J K L Q R
+  , TkRadiusComp        // R0 RR RL DR+ DR-
+  , TkTool              // T H D
+  , TkFeed
+  , TkSpeed
+  , TkFMax
+  , TkAssign
+  , TkPgm               // BEGIN PGM / END PGM
+  , TkToolDef
+  , TkToolCall
+  , TkBlkForm
+  , TkVariable          // #<name>
+  , TkComment
+  , TkCount
+    };
+
 protected:
   void setup();
 
 private:
-  struct HighlightingRule
-  {
-    QRegularExpression pattern;
-    QTextCharFormat format;
-    };
-  QVector<HighlightingRule> highlightingRules;
+  QTextCharFormat tokenFormats[TkCount];
   };
 #endif // GCODEHIGHLIGHTER_H
@@ -0,0 +1,356 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       gcodeparser.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "gcodeparser.h"
+#include "tracer.h"
+#include <QByteArray>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+
+static inline bool isAlpha(char c) {
+  return (c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z');
+  }
+
+
+static inline bool isDigit(char c) {
+  return c >= '0' && c <= '9';
+  }
+
+
+static inline char upper(char c) {
+  return c >= 'a' && c <= 'z' ? c - 'a' + 'A' : c;
+  }
+
+
+// skip an identifier like MCALL, CYCLE81, FMAX including an argument list
+static const char* skipWord(const char* p, const char* e) {
+  while (p < e && (isAlpha(*p) || isDigit(*p) || *p == '_')) ++p;
+  if (p < e && *p == '(') {
+     while (p < e && *p != ')') ++p;
+     if (p < e) ++p;
+     }
+  return p;
+  }
+
+
+static bool startsWith(const char* p, const char* e, const char* word) {
+  int n = strlen(word);
+
+  if (e - p < n) return false;
+  for (int i=0; i < n; ++i)
+      if (upper(p[i]) != word[i]) return false;
+  return true;
+  }
+
+
+GCodeParser::GCodeParser(Dialect d)
+ : dia(d)
+ , data(nullptr)
+ , len(0) {
+  }
+
+
+GCodeParser::~GCodeParser() {
+  file.close();
+  }
+
+
+GCodeParser::Dialect GCodeParser::detect() const {
+  QByteArray head = QByteArray::fromRawData(data, std::min(len, qint64(4096)));
+
+  if (head.contains("BEGIN PGM")) return Heidenhain;
+  if (head.contains("MCALL") || head.contains("CYCLE")) return Sinumeric;
+
+  return DIN;
+  }
+
+
+bool GCodeParser::open(const QString& fileName) {
+  file.close();
+  file.setFileName(fileName);
+  data = nullptr;
+  len  = 0;
+  if (!file.open(QIODevice::ReadOnly)) {
+     error = file.errorString();
+     return false;
+     }
+  len = file.size();
+  if (len) {
+     data = reinterpret_cast<const char*>(file.map(0, len));
+     if (!data) {
+        error = file.errorString();
+        len   = 0;
+        return false;
+        }
+     }
+  if (dia == AutoDetect) dia = detect();
+
+  return true;
+  }
+
+
+qint64 GCodeParser::parse(const Visitor& visitor) {
+  TraceSpan   span("GCodeParser::parse");
+  const char* p   = data;
+  const char* end = data + len;
+  bool        hh  = dia == Heidenhain;
+  State       st;
+
+  while (p < end) {
+        const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+        const char* le = nl ? nl : end;
+        const char* ee = le > p && le[-1] == '\r' ? le - 1 : le;
+
+        ++st.line;
+        if (!(hh ? parseHeidenhain(p, ee, st, visitor) : parseDIN(p, ee, st, visitor))) break;
+        p = le + 1;
+        }
+  return st.line;
+  }
+
+
+// words are letter + number. Multi letter words (MCALL, CYCLE81(...))
+// only matter for siemens cycles. Centers of arcs are incremental.
+bool GCodeParser::parseDIN(const char* s, const char* e, State& st, const Visitor& visitor) {
+  const char* p         = s;
+  double      axis[3]   = { 0, 0, 0 };
+  double      ijk[3]    = { 0, 0, 0 };
+  bool        has[3]    = { false, false, false };
+  int         motion    = -1;
+  bool        defCycle  = false;
+  bool        noMove    = false;
+  bool        mcall     = false;
+  bool        cycleCall = false;
+
+  while (p < e) {
+        char c = *p;
+
+        if (c == ';') break;
+        if (c == '(') {
+           while (p < e && *p != ')') ++p;
+           ++p;
+           continue;
+           }
+        if (!isAlpha(c)) {
+           ++p;
+           continue;
+           }
+        const char* q = p + 1;
+
+        if (q < e && isAlpha(*q)) {
+           if (startsWith(p, e, "MCALL"))      mcall     = true;
+           else if (startsWith(p, e, "CYCLE")) cycleCall = true;
+           p = skipWord(p, e);
+           continue;
+           }
+        double v;
+
+        p = readNumber(q, e, v);
+        if (p == q) continue;
+        switch (upper(c)) {
+          case 'G':
+               switch (static_cast<int>(v)) {
+                 case 0:  motion = MKTraverse; break;
+                 case 1:  motion = MKFeed;     break;
+                 case 2:
+                 case 3:  motion = MKArc;
+                          st.ccw = static_cast<int>(v) == 3;
+                          break;
+                 case 28: noMove = true;       break;
+                 case 73:
+                 case 76:
+                 case 81: case 82: case 83: case 84:
+                 case 85: case 86: case 87: case 88: case 89:
+                          st.cycle = true;
+                          defCycle = true;
+                          break;
+                 case 80: st.cycle = false;    break;
+                 case 90: st.inc   = false;    break;
+                 case 91: st.inc   = true;     break;
+                 default: break;
+                 }
+               break;
+          case 'X': axis[0] = v; has[0] = true; break;
+          case 'Y': axis[1] = v; has[1] = true; break;
+          case 'Z': axis[2] = v; has[2] = true; break;
+          case 'I': ijk[0]  = v; break;
+          case 'J': ijk[1]  = v; break;
+          case 'K': ijk[2]  = v; break;
+          case 'F': st.feed = v; break;
+          default: break;
+          }
+        }
+  if (mcall) st.cycle = cycleCall;
+  if (motion >= 0) {
+     st.motion = static_cast<MoveKind>(motion);
+     if (dia != Sinumeric && !defCycle) st.cycle = false;    // group 01 cancels canned cycles
+     }
+  if (defCycle || noMove || !(has[0] || has[1] || has[2])) return true;
+  Move m;
+
+  m.kind = st.cycle ? MKCycle : st.motion;
+  m.from = st.pos;
+  m.to   = st.pos;
+  for (int i=0; i < 3; ++i) {
+      if (has[i]) m.to.SetCoord(i + 1, st.inc ? m.to.Coord(i + 1) + axis[i] : axis[i]);
+      }
+  m.center = gp_Pnt(m.from.X() + ijk[0], m.from.Y() + ijk[1], m.from.Z() + ijk[2]);
+  m.ccw    = st.ccw;
+  m.feed   = st.feed;
+  m.line   = st.line;
+  st.pos   = m.to;
+
+  return visitor(m);
+  }
+
+
+// blocks start with optional block number and a keyword. Only L (line),
+// CC (circle center) and C (arc around last CC) change the position.
+// FMAX is valid for its block only, M99 executes the defined cycle.
+bool GCodeParser::parseHeidenhain(const char* s, const char* e, State& st, const Visitor& visitor) {
+  const char* p = s;
+
+  while (p < e && (*p == ' ' || *p == '\t' || isDigit(*p))) ++p;
+  if (p >= e || !isAlpha(*p)) return true;
+  const char* kw       = p;
+  const char* kwEnd    = skipWord(p, e);
+  bool        isLine   = kwEnd - kw == 1 && upper(kw[0]) == 'L';
+  bool        isArc    = kwEnd - kw == 1 && upper(kw[0]) == 'C';
+  bool        isCenter = kwEnd - kw == 2 && startsWith(kw, e, "CC");
+
+  p = kwEnd;
+
+  if (!isLine && !isArc && !isCenter) return true;
+  double axis[3] = { 0, 0, 0 };
+  bool   has[3]  = { false, false, false };
+  bool   fmax    = false;
+  bool   exec    = false;
+
+  while (p < e) {
+        char c = *p;
+
+        if (c == ';') break;
+        if (c == '(') {
+           while (p < e && *p != ')') ++p;
+           ++p;
+           continue;
+           }
+        if (!isAlpha(c)) {
+           ++p;
+           continue;
+           }
+        if (startsWith(p, e, "FMAX")) {
+           fmax = true;
+           p   += 4;
+           continue;
+           }
+        if (startsWith(p, e, "DR") && p + 2 < e) {
+           st.ccw = p[2] == '+';
+           p     += 3;
+           continue;
+           }
+        const char* q = p + 1;
+
+        if (q < e && isAlpha(*q)) {
+           p = skipWord(p, e);
+           continue;
+           }
+        double v;
+
+        p = readNumber(q, e, v);
+        if (p == q) continue;
+        switch (upper(c)) {
+          case 'X': axis[0] = v; has[0] = true; break;
+          case 'Y': axis[1] = v; has[1] = true; break;
+          case 'Z': axis[2] = v; has[2] = true; break;
+          case 'F': st.feed = v; break;
+          case 'M': if (static_cast<int>(v) == 99) exec = true; break;
+          default: break;
+          }
+        }
+  if (isCenter) {
+     st.center = gp_Pnt(has[0] ? axis[0] : st.pos.X()
+                      , has[1] ? axis[1] : st.pos.Y()
+                      , st.pos.Z());
+     return true;
+     }
+  if (!(has[0] || has[1] || has[2])) return true;
+  Move m;
+
+  m.kind   = isArc ? MKArc : exec ? MKCycle : fmax ? MKTraverse : MKFeed;
+  m.from   = st.pos;
+  m.to     = gp_Pnt(has[0] ? axis[0] : st.pos.X()
+                  , has[1] ? axis[1] : st.pos.Y()
+                  , has[2] ? axis[2] : st.pos.Z());
+  m.center = gp_Pnt(st.center.X(), st.center.Y(), m.from.Z());
+  m.ccw    = st.ccw;
+  m.feed   = st.feed;
+  m.line   = st.line;
+  st.pos   = m.to;
+
+  return visitor(m);
+  }
+
+
+// plain decimal number with optional sign. Mantissa is collected as
+// integer and scaled once, which is exact for the digits we write.
+const char* GCodeParser::readNumber(const char* p, const char* e, double& v) {
+  static const double scale[] = { 1, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9
+                                , 1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18 };
+  const char*        s        = p;
+  bool               neg      = false;
+  unsigned long long mantissa = 0;
+  int                digits   = 0;
+  int                frac     = 0;
+  int                lost     = 0;     // integer digits beyond mantissa precision
+
+  while (p < e && *p == ' ') ++p;
+  if (p < e && (*p == '+' || *p == '-')) neg = *p++ == '-';
+  while (p < e && isDigit(*p)) {
+        if (digits < 18) mantissa = mantissa * 10 + (*p - '0');
+        else             ++lost;
+        ++digits;
+        ++p;
+        }
+  if (p < e && *p == '.') {
+     ++p;
+     while (p < e && isDigit(*p)) {
+           if (digits < 18) {
+              mantissa = mantissa * 10 + (*p - '0');
+              ++frac;
+              }
+           ++digits;
+           ++p;
+           }
+     }
+  if (!digits) return s;
+  v = lost ? mantissa * std::pow(10.0, lost) : mantissa / scale[frac];
+  if (neg) v = -v;
+
+  return p;
+  }
@@ -0,0 +1,99 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       gcodeparser.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef GCODEPARSER_H
+#define GCODEPARSER_H
+#include <gp_Pnt.hxx>
+#include <QFile>
+#include <QString>
+#include <functional>
+
+
+// streaming reader of the gcode dialects we post. The file gets mapped
+// into memory and is scanned once from start to end without creating
+// strings per line. Each move is handed to the visitor in absolute
+// coordinates, so the caller decides what to keep.
+class GCodeParser
+{
+public:
+  enum Dialect {
+    AutoDetect
+  , DIN                 // DIN 66025 / fanuc
+  , Heidenhain          // conversational (klartext)
+  , Sinumeric           // DIN plus MCALL CYCLExx(...)
+    };
+  enum MoveKind {
+    MKTraverse
+  , MKFeed
+  , MKArc
+  , MKCycle             // position of drill cycle execution
+    };
+  struct Move {
+    MoveKind kind;
+    gp_Pnt   from;
+    gp_Pnt   to;
+    gp_Pnt   center;    // arcs only
+    bool     ccw;
+    double   feed;
+    qint64   line;      // 1 based
+    };
+  // return false to stop parsing
+  typedef std::function<bool(const Move&)> Visitor;
+
+  explicit GCodeParser(Dialect d = AutoDetect);
+  virtual ~GCodeParser();
+
+  Dialect dialect() const     { return dia; }
+  QString errorString() const { return error; }
+  bool    open(const QString& fileName);
+  qint64  parse(const Visitor& visitor);
+  qint64  size() const        { return len; }
+
+protected:
+  struct State {
+    gp_Pnt   pos;
+    gp_Pnt   center;        // heidenhain CC
+    MoveKind motion = MKTraverse;
+    bool     ccw    = false;
+    bool     inc    = false;
+    bool     cycle  = false;
+    double   feed   = 0;
+    qint64   line   = 0;
+    };
+  Dialect detect() const;
+  bool    parseDIN(const char* s, const char* e, State& st, const Visitor& visitor);
+  bool    parseHeidenhain(const char* s, const char* e, State& st, const Visitor& visitor);
+
+  static const char* readNumber(const char* p, const char* e, double& v);
+
+private:
+  Dialect      dia;
+  QFile        file;
+  const char*  data;
+  qint64       len;
+  QString      error;
+  };
+#endif // GCODEPARSER_H
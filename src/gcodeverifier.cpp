@@ -0,0 +1,212 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       gcodeverifier.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "gcodeverifier.h"
+#include "gcodeparser.h"
+#include "kuteCAM.h"
+#include "operation.h"
+#include "workstep.h"
+#include "tracer.h"
+#include <BRepBuilderAPI_MakePolygon.hxx>
+#include <BRep_Builder.hxx>
+#include <TopoDS_Compound.hxx>
+#include <QElapsedTimer>
+#include <algorithm>
+#include <cmath>
+
+
+GCodeVerifier::GCodeVerifier(double tolerance, double resolution)
+ : tolerance(tolerance)
+ , resolution(resolution) {
+  }
+
+
+// same selection of worksteps as GCodeWriter uses
+std::vector<GCodeVerifier::Target> GCodeVerifier::expectedMoves(const QVector<Operation*>& operations) const {
+  std::vector<Target> rv;
+
+  for (int o=0; o < operations.size(); ++o) {
+      const Operation* op = operations.at(o);
+      int              mx = op->workSteps().size();
+      int              first = 0;
+
+      for (int f=0; f < fixtures.count(); ++f) {
+          gp_Trsf shift = fixtures.shift(f, op);
+
+          switch (op->kind()) {
+            case ContourOperation:
+            case SweepOperation:
+            case ClampingPlugOP:
+            case Face3DOperation:
+                 while (first < mx && op->workSteps().at(first)->startPos().Z() >= 300) ++first;
+                 for (int i=first; i < mx; ++i) {
+                     Workstep* ws = op->workSteps().at(i);
+
+                     switch (ws->type()) {
+                       case WTTraverse:
+                       case WTStraightMove:
+                       case WTArc:
+                            rv.push_back({ ws->endPos().Transformed(shift), o, i, false });
+                            break;
+                       default: break;
+                       }
+                     }
+                 break;
+            case DrillOperation:
+                 for (int i=1; i < mx; ++i)
+                     rv.push_back({ op->workSteps().at(i)->startPos().Transformed(shift), o, i, true });
+                 break;
+            default: break;
+            }
+          }
+      }
+  return rv;
+  }
+
+
+GCodeVerifier::Result GCodeVerifier::verify(const QString& fileName, const QVector<Operation*>& operations, bool backplot) const {
+  TraceSpan           span("GCodeVerifier::verify");
+  Result              rv;
+  GCodeParser         parser;
+  QElapsedTimer       timer;
+  std::vector<Target> expected = expectedMoves(operations);
+  size_t              cur      = 0;
+  bool                pending  = false;
+  GCodeParser::Move   lastMiss;
+  gp_Pnt              lastPos;
+  BRep_Builder        builder;
+  TopoDS_Compound     rapids;
+  TopoDS_Compound     cuts;
+  std::vector<gp_Pnt> poly;
+  bool                polyRapid = true;
+  gp_Pnt              tail;
+
+  timer.start();
+  if (!parser.open(fileName)) {
+     rv.error = parser.errorString();
+     return rv;
+     }
+  builder.MakeCompound(rapids);
+  builder.MakeCompound(cuts);
+  rv.checked = expected.size();
+
+  auto distance = [](const Target& t, const gp_Pnt& p) {
+    if (t.xyOnly) return std::hypot(t.pos.X() - p.X(), t.pos.Y() - p.Y());
+    return t.pos.Distance(p);
+    };
+  auto miss = [&](const Target& t, const gp_Pnt& found, qint64 line) {
+    ++rv.missing;
+    if (static_cast<int>(rv.mismatches.size()) < MaxMismatches)
+       rv.mismatches.push_back({ t.op, t.step, t.pos, found, line, distance(t, found) });
+    };
+  auto flush = [&]() {
+    if (poly.empty()) return;
+    if (!kute::isEqual(poly.back(), tail)) poly.push_back(tail);
+    if (poly.size() > 1) {
+       BRepBuilderAPI_MakePolygon mp;
+
+       for (auto& p : poly) mp.Add(p);
+       if (mp.IsDone()) builder.Add(polyRapid ? rapids : cuts, mp.Wire());
+       }
+    poly.clear();
+    };
+  // consecutive moves of same kind end up in one polyline
+  auto plot = [&](const gp_Pnt& from, const gp_Pnt& to, bool rapid) {
+    if (rapid != polyRapid
+     || poly.empty()
+     || static_cast<int>(poly.size()) >= MaxPolyPoints
+     || !kute::isEqual(from, tail)) {
+       flush();
+       polyRapid = rapid;
+       poly.push_back(from);
+       }
+    if (to.SquareDistance(poly.back()) >= resolution * resolution) poly.push_back(to);
+    tail = to;
+    };
+  auto plotArc = [&](const GCodeParser::Move& m) {
+    const gp_Pnt& c  = m.center;
+    double        r  = std::hypot(m.from.X() - c.X(), m.from.Y() - c.Y());
+    double        a0 = std::atan2(m.from.Y() - c.Y(), m.from.X() - c.X());
+    double        a1 = std::atan2(m.to.Y() - c.Y(), m.to.X() - c.X());
+    double        sweep = m.ccw ? a1 - a0 : a0 - a1;
+
+    if (sweep <= 1e-9) sweep += 2 * M_PI;
+    double step = r > resolution ? 2 * std::acos(1 - resolution / r) : sweep;
+    int    n    = std::clamp(static_cast<int>(std::ceil(sweep / step)), 1, MaxArcSegments);
+    gp_Pnt prev = m.from;
+
+    for (int i=1; i <= n; ++i) {
+        double t = static_cast<double>(i) / n;
+        double a = a0 + (m.ccw ? sweep : -sweep) * t;
+        gp_Pnt p = i == n ? m.to : gp_Pnt(c.X() + r * std::cos(a)
+                                        , c.Y() + r * std::sin(a)
+                                        , m.from.Z() + (m.to.Z() - m.from.Z()) * t);
+
+        plot(prev, p, false);
+        prev = p;
+        }
+    };
+
+  // a move matches the next expected one, or one a few steps ahead -
+  // then the ones in between are missing. Anything else was added by
+  // the postprocessor.
+  rv.lines = parser.parse([&](const GCodeParser::Move& m) {
+    ++rv.moves;
+    lastPos = m.to;
+    if (backplot) {
+       if (m.kind == GCodeParser::MKArc) plotArc(m);
+       else                              plot(m.from, m.to, m.kind != GCodeParser::MKFeed);
+       }
+    size_t end = std::min(expected.size(), cur + LookAhead);
+
+    for (size_t k=cur; k < end; ++k) {
+        if (distance(expected[k], m.to) > tolerance) continue;
+        for (; cur < k; ++cur) {
+            if (pending) miss(expected[cur], lastMiss.to, lastMiss.line);
+            else         miss(expected[cur], m.to, m.line);
+            }
+        ++rv.matched;
+        ++cur;
+        pending = false;
+
+        return true;
+        }
+    pending  = true;
+    lastMiss = m;
+
+    return true;
+    });
+  for (; cur < expected.size(); ++cur) miss(expected[cur], lastPos, rv.lines);
+  flush();
+  if (backplot) {
+     rv.rapids = rapids;
+     rv.cuts   = cuts;
+     }
+  rv.valid = true;
+  rv.ms    = timer.nsecsElapsed() / 1e6;
+
+  return rv;
+  }
@@ -0,0 +1,92 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       gcodeverifier.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef GCODEVERIFIER_H
+#define GCODEVERIFIER_H
+#include "fixturelayout.h"
+#include <gp_Pnt.hxx>
+#include <TopoDS_Shape.hxx>
+#include <QString>
+#include <QVector>
+#include <vector>
+class Operation;
+
+
+// reads back a written gcode file and checks, that every move of the
+// source worksteps shows up in the program in the same order. Moves the
+// postprocessor adds (intro, exit, tool change) are skipped. The same
+// pass builds a backplot of the program, where tiny moves get merged
+// up to the display resolution. With several fixtures every
+// operation is expected once per fixture instance.
+class GCodeVerifier
+{
+public:
+  struct Mismatch {
+    int    op;                      // index of operation
+    int    step;                    // index of workstep
+    gp_Pnt expected;
+    gp_Pnt found;                   // last move, that did not match
+    qint64 line;
+    double deviation;
+    };
+  struct Result {
+    bool                  valid   = false;
+    qint64                lines   = 0;
+    qint64                moves   = 0;
+    int                   checked = 0;
+    int                   matched = 0;
+    int                   missing = 0;
+    double                ms      = 0;
+    std::vector<Mismatch> mismatches;       // first MaxMismatches only
+    TopoDS_Shape          rapids;
+    TopoDS_Shape          cuts;
+    QString               error;
+    };
+  explicit GCodeVerifier(double tolerance = 0.01, double resolution = 0.05);
+
+  void   setFixtures(const FixtureLayout& layout) { fixtures = layout; }
+  Result verify(const QString& fileName, const QVector<Operation*>& operations, bool backplot = true) const;
+
+  static const int MaxMismatches  = 100;
+  static const int LookAhead      = 16;
+  static const int MaxPolyPoints  = 2000;
+  static const int MaxArcSegments = 128;
+
+protected:
+  struct Target {
+    gp_Pnt pos;
+    int    op;
+    int    step;
+    bool   xyOnly;                  // drill cycles
+    };
+  std::vector<Target> expectedMoves(const QVector<Operation*>& operations) const;
+
+private:
+  FixtureLayout fixtures;
+  double        tolerance;
+  double        resolution;
+  };
+#endif // GCODEVERIFIER_H
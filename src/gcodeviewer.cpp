@@ -0,0 +1,387 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       gcodeviewer.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "gcodeviewer.h"
+#include "gcodehighlighter.h"
+#include <QApplication>
+#include <QInputDialog>
+#include <QKeyEvent>
+#include <QLineEdit>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QScrollBar>
+#include <QTextLayout>
+#include <QThread>
+#include <QDebug>
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+
+// collects the start offsets of all lines. Offsets get published
+// in batches, so the viewer can show the first lines immediately.
+class LineIndexer : public QThread
+{
+public:
+  explicit LineIndexer(GCodeViewer* v)
+   : v(v) {
+    }
+
+protected:
+  void run() override {
+    const size_t        BatchSize = 1 << 16;
+    const char*         p         = v->data;
+    const char*         end       = v->data + v->size;
+    int                 mxLen     = 0;
+    std::vector<qint64> batch;
+    auto publish = [&]() {
+      QMutexLocker lock(&v->mutex);
+
+      v->offsets.insert(v->offsets.end(), batch.begin(), batch.end());
+      v->maxLength = mxLen;
+      batch.clear();
+      };
+
+    batch.reserve(BatchSize);
+    if (p < end) batch.push_back(0);
+    while (p < end && !v->abort) {
+          const char* nl = static_cast<const char*>(memchr(p, '\n', end - p));
+          const char* le = nl ? nl : end;
+
+          mxLen = std::max(mxLen, static_cast<int>(le - p));
+          if (nl && nl + 1 < end) batch.push_back(nl + 1 - v->data);
+          if (batch.size() >= BatchSize) publish();
+          p = le + 1;
+          }
+    publish();
+    }
+
+private:
+  GCodeViewer* v;
+  };
+
+
+GCodeViewer::GCodeViewer(QWidget* parent)
+ : QAbstractScrollArea(parent)
+ , data(nullptr)
+ , size(0)
+ , indexer(nullptr)
+ , abort(false)
+ , maxLength(0)
+ , indexed(true)
+ , hl(nullptr)
+ , curLine(0) {
+  QFont font("Monospace");
+
+  font.setStyleHint(QFont::TypeWriter);
+  setFont(font);
+  setFocusPolicy(Qt::StrongFocus);
+  }
+
+
+GCodeViewer::~GCodeViewer() {
+  close();
+  }
+
+
+void GCodeViewer::close() {
+  timer.stop();
+  if (indexer) {
+     abort = true;
+     indexer->wait();
+     delete indexer;
+     indexer = nullptr;
+     }
+  QMutexLocker lock(&mutex);
+
+  offsets.clear();
+  file.close();
+  data      = nullptr;
+  size      = 0;
+  maxLength = 0;
+  indexed   = true;
+  curLine   = 0;
+  }
+
+
+void GCodeViewer::ensureVisible(int line) {
+  int lh    = fontMetrics().height();
+  int vis   = std::max(1, viewport()->height() / lh);
+  int first = verticalScrollBar()->value();
+
+  if (line < first)             verticalScrollBar()->setValue(line);
+  else if (line >= first + vis) verticalScrollBar()->setValue(line - vis + 1);
+  }
+
+
+// plain byte search in the mapped file. Lines past the index are
+// not known yet, so searching waits for the indexer.
+int GCodeViewer::find(const QString& text, int from, bool forward) {
+  if (!data || text.isEmpty()) return -1;
+  if (!indexed) {
+     indexer->wait();
+     timerEvent(nullptr);
+     }
+  QByteArray needle = text.toUtf8();
+  QByteArray hay    = QByteArray::fromRawData(data, size);
+  qint64     pos;
+
+  if (forward) {
+     qint64 start = from + 1 < numLines() ? offsets[from + 1] : size;
+
+     pos = hay.indexOf(needle, static_cast<int>(start));
+     }
+  else {
+     qint64 start = from < numLines() ? offsets[from] - 1 : size - 1;
+
+     pos = start < 0 ? -1 : hay.lastIndexOf(needle, static_cast<int>(start));
+     }
+  if (pos < 0) return -1;
+  int line = std::upper_bound(offsets.begin(), offsets.end(), pos) - offsets.begin() - 1;
+
+  gotoLine(line);
+
+  return line;
+  }
+
+
+void GCodeViewer::gotoLine(int line) {
+  int mx = numLines();
+
+  if (!mx) return;
+  curLine = std::clamp(line, 0, mx - 1);
+  ensureVisible(curLine);
+  viewport()->update();
+  }
+
+
+int GCodeViewer::gutterWidth() const {
+  int digits = 1;
+  int max    = std::max(1, numLines());
+
+  while (max >= 10) {
+        max /= 10;
+        ++digits;
+        }
+  return 6 + fontMetrics().horizontalAdvance(QLatin1Char('9')) * digits;
+  }
+
+
+void GCodeViewer::keyPressEvent(QKeyEvent* e) {
+  int  page = std::max(1, viewport()->height() / fontMetrics().height() - 1);
+  bool ctrl = e->modifiers() & Qt::ControlModifier;
+
+  switch (e->key()) {
+    case Qt::Key_Up:       gotoLine(curLine - 1);    break;
+    case Qt::Key_Down:     gotoLine(curLine + 1);    break;
+    case Qt::Key_PageUp:   gotoLine(curLine - page); break;
+    case Qt::Key_PageDown: gotoLine(curLine + page); break;
+    case Qt::Key_Home:     if (ctrl) gotoLine(0);                else QAbstractScrollArea::keyPressEvent(e); break;
+    case Qt::Key_End:      if (ctrl) gotoLine(numLines() - 1);   else QAbstractScrollArea::keyPressEvent(e); break;
+    case Qt::Key_G:        if (ctrl) queryLine();                else QAbstractScrollArea::keyPressEvent(e); break;
+    case Qt::Key_F:        if (ctrl) queryFind(true);            else QAbstractScrollArea::keyPressEvent(e); break;
+    case Qt::Key_F3:
+         if (find(lastSearch, curLine, !(e->modifiers() & Qt::ShiftModifier)) < 0)
+            QApplication::beep();
+         break;
+    default:
+         QAbstractScrollArea::keyPressEvent(e);
+         break;
+    }
+  }
+
+
+QString GCodeViewer::line(int n) const {
+  QMutexLocker lock(&mutex);
+
+  if (n < 0 || n >= static_cast<int>(offsets.size())) return QString();
+  const char* s  = data + offsets[n];
+  const char* nl = static_cast<const char*>(memchr(s, '\n', data + size - s));
+  const char* e  = nl ? nl : data + size;
+
+  if (e > s && e[-1] == '\r') --e;
+
+  return QString::fromUtf8(s, e - s);
+  }
+
+
+bool GCodeViewer::loadFile(const QString& fileName) {
+  close();
+  file.setFileName(fileName);
+  if (!file.open(QIODevice::ReadOnly)) {
+     qDebug() << tr("could not read file %1").arg(fileName);
+     return false;
+     }
+  size = file.size();
+  if (size > std::numeric_limits<int>::max()) {
+     qDebug() << tr("file %1 is too big").arg(fileName);
+     file.close();
+     size = 0;
+     return false;
+     }
+  if (size) {
+     data = reinterpret_cast<const char*>(file.map(0, size));
+     if (!data) {
+        qDebug() << tr("failed to map file %1").arg(fileName);
+        file.close();
+        size = 0;
+        return false;
+        }
+     offsets.reserve(size / 32);
+     abort   = false;
+     indexed = false;
+     indexer = new LineIndexer(this);
+     indexer->start();
+     timer.start(100, this);
+     }
+  verticalScrollBar()->setValue(0);
+  horizontalScrollBar()->setValue(0);
+  updateScrollBars();
+  viewport()->update();
+
+  return true;
+  }
+
+
+void GCodeViewer::mousePressEvent(QMouseEvent* e) {
+  gotoLine(verticalScrollBar()->value() + e->pos().y() / fontMetrics().height());
+  }
+
+
+int GCodeViewer::numLines() const {
+  QMutexLocker lock(&mutex);
+
+  return offsets.size();
+  }
+
+
+// only visible lines get converted and highlighted
+void GCodeViewer::paintEvent(QPaintEvent* e) {
+  QPainter    painter(viewport());
+  QTextOption option;
+  int         lh     = fontMetrics().height();
+  int         gw     = gutterWidth();
+  int         width  = viewport()->width();
+  int         height = viewport()->height();
+  int         first  = verticalScrollBar()->value();
+  int         dx     = horizontalScrollBar()->value();
+  int         mx     = numLines();
+  QColor      bgLineNum = QColor::fromRgb(170, 170, 170);
+  QColor      fgLineNum = QColor::fromRgb(255, 255, 255);
+  QColor      bgHLLine  = QColor::fromRgb(0, 0, 255);
+  QColor      fgHLLine  = QColor::fromRgb(255, 255, 0);
+
+  option.setWrapMode(QTextOption::NoWrap);
+  painter.fillRect(e->rect(), palette().base());
+  painter.fillRect(0, 0, gw, height, bgLineNum);
+  for (int y=0, n=first; n < mx && y < height; y += lh, ++n) {
+      QString     text = line(n);
+      QTextLayout layout(text, font());
+
+      layout.setTextOption(option);
+      if (n == curLine) {
+         painter.fillRect(gw, y, width - gw, lh, bgHLLine);
+         painter.setPen(fgHLLine);
+         }
+      else {
+         if (hl) layout.setFormats(hl->formats(text));
+         painter.setPen(palette().text().color());
+         }
+      layout.beginLayout();
+      layout.createLine().setLineWidth(std::numeric_limits<short>::max());
+      layout.endLayout();
+      painter.setClipRect(gw, 0, width - gw, height);
+      layout.draw(&painter, QPointF(gw + 3 - dx, y));
+      painter.setClipping(false);
+      painter.setPen(fgLineNum);
+      painter.drawText(0, y, gw - 3, lh, Qt::AlignRight, QString::number(n + 1));
+      }
+  }
+
+
+void GCodeViewer::queryFind(bool forward) {
+  bool    ok   = false;
+  QString text = QInputDialog::getText(this
+                                     , tr("Search")
+                                     , tr("find text:")
+                                     , QLineEdit::Normal
+                                     , lastSearch
+                                     , &ok);
+
+  if (!ok || text.isEmpty()) return;
+  lastSearch = text;
+  if (find(lastSearch, curLine, forward) < 0) QApplication::beep();
+  }
+
+
+void GCodeViewer::queryLine() {
+  bool ok   = false;
+  int  line = QInputDialog::getInt(this
+                                 , tr("Goto Line")
+                                 , tr("line number:")
+                                 , curLine + 1
+                                 , 1
+                                 , std::max(1, numLines())
+                                 , 1
+                                 , &ok);
+
+  if (ok) gotoLine(line - 1);
+  }
+
+
+void GCodeViewer::resizeEvent(QResizeEvent* e) {
+  QAbstractScrollArea::resizeEvent(e);
+  updateScrollBars();
+  }
+
+
+// polls the indexer while it runs
+void GCodeViewer::timerEvent(QTimerEvent* e) {
+  if (e && e->timerId() != timer.timerId()) {
+     QAbstractScrollArea::timerEvent(e);
+     return;
+     }
+  if (indexer && indexer->isFinished()) {
+     timer.stop();
+     indexed = true;
+     emit fileIndexed(numLines());
+     }
+  updateScrollBars();
+  viewport()->update();
+  }
+
+
+void GCodeViewer::updateScrollBars() {
+  int lh  = fontMetrics().height();
+  int cw  = fontMetrics().horizontalAdvance(QLatin1Char('9'));
+  int vis = std::max(1, viewport()->height() / lh);
+  int w   = viewport()->width() - gutterWidth();
+
+  verticalScrollBar()->setRange(0, std::max(0, numLines() - vis));
+  verticalScrollBar()->setPageStep(vis);
+  horizontalScrollBar()->setRange(0, std::max(0, maxLength * cw - w));
+  horizontalScrollBar()->setPageStep(std::max(1, w));
+  }
@@ -0,0 +1,93 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       gcodeviewer.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef GCODEVIEWER_H
+#define GCODEVIEWER_H
+#include <QAbstractScrollArea>
+#include <QBasicTimer>
+#include <QFile>
+#include <QMutex>
+#include <atomic>
+#include <vector>
+class GCodeHighlighter;
+class LineIndexer;
+
+
+// read-only view of huge gcode files. The file gets mapped into memory
+// and a background thread collects the offsets of all lines. Only the
+// visible lines are converted to text and highlighted while painting,
+// so opening a file costs nearly nothing, no matter of its size.
+//
+// keys: Ctrl+G goto line, Ctrl+F search, F3 / Shift+F3 find next / previous
+class GCodeViewer : public QAbstractScrollArea
+{
+  Q_OBJECT
+public:
+  explicit GCodeViewer(QWidget* parent = nullptr);
+  virtual ~GCodeViewer();
+
+  void    close();
+  int     currentLine() const { return curLine; }
+  int     find(const QString& text, int from, bool forward = true);
+  void    gotoLine(int line);
+  bool    isIndexed() const   { return indexed; }
+  QString line(int n) const;
+  bool    loadFile(const QString& fileName);
+  int     numLines() const;
+  void    setHighlighter(const GCodeHighlighter* gh) { hl = gh; }
+
+signals:
+  void    fileIndexed(int lines);
+
+protected:
+  void    keyPressEvent(QKeyEvent* e) override;
+  void    mousePressEvent(QMouseEvent* e) override;
+  void    paintEvent(QPaintEvent* e) override;
+  void    resizeEvent(QResizeEvent* e) override;
+  void    timerEvent(QTimerEvent* e) override;
+  void    ensureVisible(int line);
+  int     gutterWidth() const;
+  void    queryFind(bool forward);
+  void    queryLine();
+  void    updateScrollBars();
+
+private:
+  friend class LineIndexer;
+  QFile                   file;
+  const char*             data;
+  qint64                  size;
+  std::vector<qint64>     offsets;       // start of each line, guarded by mutex
+  mutable QMutex          mutex;
+  LineIndexer*            indexer;
+  std::atomic<bool>       abort;
+  std::atomic<int>        maxLength;
+  bool                    indexed;
+  QBasicTimer             timer;
+  const GCodeHighlighter* hl;
+  int                     curLine;
+  QString                 lastSearch;
+  };
+#endif // GCODEVIEWER_H
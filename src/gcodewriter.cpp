@@ -27,6 +27,8 @@
 #include "gcodewriter.h"
 #include "core.h"
 #include "drilltargetdefinition.h"
+#include "feedoptimizer.h"
+#include "kuteCAM.h"
 #include "sweeptargetdefinition.h"
 #include "operation.h"
 #include "postprocessor.h"
@@ -37,10 +39,12 @@
 #include "wsarc.h"
 #include "wsstraightmove.h"
 #include "wstraverse.h"
+#include "tracer.h"
 #include <QDir>
 #include <QFile>
 #include <QFileInfo>
 #include <QTextStream>
+#include <algorithm>
 
 
 GCodeWriter::GCodeWriter(PostProcessor* pp)
@@ -51,7 +55,29 @@ GCodeWriter::GCodeWriter(PostProcessor* pp)
   }
 
 
+// per move feed from engagement against stock of the workpiece (or
+// the rest stock of previous operations)
+std::vector<double> GCodeWriter::optimizeFeed(const Operation* op, double feed) const {
+  TraceSpan  span("GCodeWriter::optimizeFeed");
+  ToolEntry* tool = op->toolEntry();
+
+  if (op->workPiece.IsNull() && !op->restStock) return {};
+  double        cell = std::max(0.1, tool->fluteDiameter() / 8);
+  FeedOptimizer fo(op->restStock ? *op->restStock : StockModel(op->workPiece->Shape(), cell)
+                 , tool
+                 , feed
+                 , op->cutWidth()
+                 , op->cutDepth());
+
+  fo.setLimits(Core().feedMinFactor(), Core().feedMaxFactor(), Core().maxFeed());
+  if (!fo.isValid()) return {};
+
+  return fo.optimize(op->workSteps());
+  }
+
+
 int GCodeWriter::processSingleOPs(const QString& baseName, const Bnd_Box& wpBounds, const QVector<Operation *>& operations, bool genTC) {
+  TraceSpan span("GCodeWriter::processSingleOPs");
   QFileInfo    fi(baseName);
   ProjectFile* pf = Core().projectFile();
   int          mxOP = operations.size();
@@ -60,6 +86,7 @@ int GCodeWriter::processSingleOPs(const QString& baseName, const Bnd_Box& wpBoun
   QString      modelFile = pf->value("Model-File").toString();
   QStringList  modelComment = pf->value("model-comment").toString().split("\n");
   pf->endGroup();
+  fixtures.load(pf);
 
   for (int i=0; i < mxOP; ++i) {
       QString   opName   = QString("%1/%2%3").arg(fi.dir().path(), fi.baseName())
@@ -105,6 +132,7 @@ int GCodeWriter::processSingleOPs(const QString& baseName, const Bnd_Box& wpBoun
 
 
 void GCodeWriter::processOperation(QTextStream &out, int n, const QString& opName, const Bnd_Box& wpBounds, const Operation *op, const Operation *nxtOP, bool genTC) {
+  TraceSpan span("GCodeWriter::processOperation");
   ToolEntry* curTool = op->toolEntry();
 
   if (genTC) {
@@ -135,10 +163,12 @@ void GCodeWriter::processOperation(QTextStream &out, int n, const QString& opNam
                                        .arg(curTool->toolName())
                                        .arg(curTool->fluteDiameter())
                                        .arg(curTool->freeLength())));
-  double  speed = op->speed() * 1000 / M_PI / curTool->fluteDiameter();
-  double  feed  = speed * curTool->numFlutes() * op->feedPerTooth();
-  int     line  = 0;
-  gp_Pnt  pos;
+  double              speed = op->speed() * 1000 / M_PI / curTool->fluteDiameter();
+  double              feed  = speed * curTool->numFlutes() * op->feedPerTooth();
+  int                 line  = 0;
+  int                 mxFix = fixtures.count();
+  std::vector<double> feeds;
+  gp_Pnt              pos;
 
   if (op->workSteps().size()) {
      for (; line < op->workSteps().size(); ++line) {
@@ -147,28 +177,63 @@ void GCodeWriter::processOperation(QTextStream &out, int n, const QString& opNam
          break;
          }
      }
+  if (op->kind() != DrillOperation && Core().isFeedOptimization()) feeds = optimizeFeed(op, feed);
+
+  // toolpath and feeds are shared by all fixtures. Spindle, coolant and
+  // tool correction get set up once, between fixtures the tool moves
+  // over at clearance height of the workpiece.
+  double clearZ = wpBounds.CornerMax().Z() + op->safeZ1();
+
   writeLine(out
           , pp->genOPIntro(n + 1
-                         , op->fixture()
-                         , pos
+                         , fixtures.fixture(0, op)
+                         , pos.Transformed(fixtures.shift(0, op))
                          , speed
                          , feed
                          , op->toolNum()
                          , op->cooling()
                          , nxtOP->toolNum()));
-
-  switch (op->kind()) {
-    case ContourOperation:
-    case SweepOperation:
-    case ClampingPlugOP:
-         processPathTargets(out, op, line, curTool);
-         break;
-    case DrillOperation:
-         processDrillTargets(out, op, line, curTool);
-         writeLine(out
-                 , pp->genEndCycle());
-         break;
-    }
+  for (int f=0; f < mxFix; ++f) {
+      gp_Trsf shift   = fixtures.shift(f, op);
+      int     fixture = fixtures.fixture(f, op);
+
+      if (mxFix > 1) writeLine(out
+                             , pp->genLineComment(QString("Fixture %1 of %2: %3")
+                                                         .arg(f + 1)
+                                                         .arg(mxFix)
+                                                         .arg(pp->fixtureID(fixture))));
+      if (f) {
+         gp_Trsf prevShift = fixtures.shift(f - 1, op);
+         gp_Pnt  start     = pos.Transformed(shift);
+         gp_Pnt  last      = pp->lastPos();
+         double  z         = std::max(last.Z(), clearZ + std::max(prevShift.TranslationPart().Z()
+                                                                , shift.TranslationPart().Z()));
+
+         writeLine(out, pp->genTraverse(gp_Pnt(last.X(), last.Y(), z), WTStraightMove));
+         if (fixture != fixtures.fixture(f - 1, op)) {
+            QString id = pp->fixtureID(fixture);
+
+            if (!id.isEmpty()) writeLine(out, id);
+            // position in new coordinate system is unknown
+            pp->setLastPos(gp_Pnt(1e9, 1e9, 1e9));
+            }
+         writeLine(out, pp->genTraverse(gp_Pnt(start.X(), start.Y(), z), WTStraightMove));
+         writeLine(out, pp->genTraverse(start, WTStraightMove));
+         }
+      switch (op->kind()) {
+        case ContourOperation:
+        case SweepOperation:
+        case ClampingPlugOP:
+        case Face3DOperation:
+             processPathTargets(out, op, line, curTool, shift, feeds);
+             break;
+        case DrillOperation:
+             processDrillTargets(out, op, line, curTool, shift);
+             writeLine(out
+                     , pp->genEndCycle());
+             break;
+        }
+      }
   writeLine(out, pp->genOPExit());
   writeLine(out);
   out.flush();
@@ -176,6 +241,7 @@ void GCodeWriter::processOperation(QTextStream &out, int n, const QString& opNam
 
 
 int GCodeWriter::processAllInOne(const QString& fileName, const Bnd_Box& wpBounds, const QVector<Operation *>& operations) {
+  TraceSpan span("GCodeWriter::processAllInOne");
   QFile file(fileName);
 
   if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
@@ -190,6 +256,7 @@ int GCodeWriter::processAllInOne(const QString& fileName, const Bnd_Box& wpBound
   QString      modelFile = pf->value("Model-File").toString();
   QStringList  modelComment = pf->value("model-comment").toString().split("\n");
   pf->endGroup();
+  fixtures.load(pf);
 
   writeLine(out
           , pp->genProminentComment(QString("Job %1").arg(fi.baseName())));
@@ -228,16 +295,18 @@ int GCodeWriter::processAllInOne(const QString& fileName, const Bnd_Box& wpBound
   }
 
 
-void GCodeWriter::processDrillTargets(QTextStream& out, const Operation* op, int, ToolEntry* curTool) {
+// top and depth of cycle are absolute, safe distances relative to top
+void GCodeWriter::processDrillTargets(QTextStream& out, const Operation* op, int, ToolEntry* curTool, const gp_Trsf& shift) {
   double ss   = op->speed() * 1000 / M_PI / curTool->fluteDiameter();
   double feed = ss * curTool->numFlutes() * op->feedPerTooth();
+  double dz   = shift.TranslationPart().Z();
 
   writeLine(out, pp->genDefineCycle(op->drillCycle()
-                                  , op->upperZ()
+                                  , op->upperZ() + dz
                                   , op->safeZ0()
                                   , op->safeZ1()
                                     //TODO: check it out!
-                                  , op->drillDepth()
+                                  , op->drillDepth() + dz
                                   , op->qMin()
                                   , op->qMax()
                                   , op->retract()
@@ -245,38 +314,44 @@ void GCodeWriter::processDrillTargets(QTextStream& out, const Operation* op, int
                                   , feed
                                     ));
   for (int i=1; i < op->workSteps().size(); ++i) {
-      Workstep* ws = op->workSteps().at(i);
+      gp_Pnt p = op->workSteps().at(i)->startPos().Transformed(shift);
 
       writeLine(out
-              , pp->genExecCycle(op->drillCycle(), ws->startPos().X(), ws->startPos().Y()));
+              , pp->genExecCycle(op->drillCycle(), p.X(), p.Y()));
       }
   }
 
 
-void GCodeWriter::processPathTargets(QTextStream& out, const Operation* op, int first, ToolEntry* curTool) {
+void GCodeWriter::processPathTargets(QTextStream& out, const Operation* op, int first, ToolEntry* curTool, const gp_Trsf& shift, const std::vector<double>& feeds) {
   double ss   = op->speed() * 1000 / M_PI / curTool->fluteDiameter();
   double feed = ss * curTool->numFlutes() * op->feedPerTooth();
   WorkstepType lastMove = WTCycle;
   QString cmd;
+  double lastFeed = 0;
 
   for (int i=first; i < op->workSteps().size(); ++i) {
       Workstep*       ws = op->workSteps().at(i);
       WSArc*          wa = dynamic_cast<WSArc*>(ws);
       WSStraightMove* wm = dynamic_cast<WSStraightMove*>(ws);
       WSTraverse*     wt = dynamic_cast<WSTraverse*>(ws);
+      double          f  = i == first ? feed : 0;
 
+      // optimized feed gets written on changes only
+      if (feeds.size() && feeds[i] > 0) f = kute::isEqual(feeds[i], lastFeed, 0.5) ? 0 : feeds[i];
       switch (ws->type()) {
         case WTTraverse:
-             cmd = pp->genTraverse(wt->endPos(), lastMove);
+             cmd = pp->genTraverse(wt->endPos().Transformed(shift), lastMove);
              lastMove = WTTraverse;
              break;
         case WTStraightMove:
-             cmd = pp->genStraightMove(wm->endPos(), i == first ? feed : 0);
+             cmd = pp->genStraightMove(wm->endPos().Transformed(shift), f);
              lastMove = WTStraightMove;
+             if (f) lastFeed = f;
              break;
         case WTArc:
-             cmd = pp->genArc(wa->endPos(), wa->centerPos(), wa->isCCW(), i == first ? feed : 0);
+             cmd = pp->genArc(wa->endPos().Transformed(shift), wa->centerPos().Transformed(shift), wa->isCCW(), f);
              lastMove = WTArc;
+             if (f) lastFeed = f;
              break;
         default: break;
         }
@@ -26,7 +26,9 @@
  */
 #ifndef GCODEWRITER_H
 #define GCODEWRITER_H
+#include "fixturelayout.h"
 #include <QVector>
+#include <vector>
 class Bnd_Box;
 class QString;
 class Operation;
@@ -44,13 +46,15 @@ public:
   int  processSingleOPs(const QString& fileName, const Bnd_Box& wpBounds, const QVector<Operation*>& operations, bool genTC = false);
 
 protected:
+  std::vector<double> optimizeFeed(const Operation* op, double feed) const;
   void processOperation(QTextStream& out, int n, const QString& opName, const Bnd_Box& wpBounds, const Operation* op, const Operation* nxtOP, bool genTC = false);
-  void processDrillTargets(QTextStream& out, const Operation* op, int first, ToolEntry* curTool);
-  void processPathTargets(QTextStream& out, const Operation* op, int first, ToolEntry* curTool);
+  void processDrillTargets(QTextStream& out, const Operation* op, int first, ToolEntry* curTool, const gp_Trsf& shift);
+  void processPathTargets(QTextStream& out, const Operation* op, int first, ToolEntry* curTool, const gp_Trsf& shift, const std::vector<double>& feeds);
   void writeLine(QTextStream& out, const QString& line = QString());
 
 private:
   PostProcessor*  pp;
+  FixtureLayout   fixtures;
   double          rotA;
   double          rotB;
   double          rotC;
@@ -110,6 +110,17 @@ GOCircle::GOCircle(const QString& s)
   }
 
 
+// used by binary decoding of contours, where all components
+// are already known - no need to parse or to recalculate anything
+GOCircle::GOCircle(const gp_Pnt& from, const gp_Pnt& to, const gp_Pnt& center, const gp_Dir& axis, double radius)
+ : GraphicObject(GraphicType::GTCircle, from, to)
+ , centerPnt(center)
+ , axis(axis)
+ , r(radius) {
+  createCircle();
+  }
+
+
 gp_Pnt GOCircle::center() const {
   return centerPnt;
   }
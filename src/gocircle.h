@@ -57,6 +57,7 @@ public:
 
 protected:
   explicit GOCircle(const QString& source);
+  explicit GOCircle(const gp_Pnt& from, const gp_Pnt& to, const gp_Pnt& center, const gp_Dir& axis, double radius);
   void     createCircle();
 
 private:
@@ -64,6 +65,7 @@ private:
   gp_Dir axis;
   double r;
 
+  friend class GOContour;
   friend class Util3D;
   };
 #endif // GOCIRCLE_H
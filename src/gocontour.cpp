@@ -30,6 +30,7 @@
 #include "core.h"
 #include "kuteCAM.h"
 #include "util3d.h"
+#include "tracer.h"
 #include <BRep_Builder.hxx>
 #include <BRepBuilderAPI_MakeWire.hxx>
 #include <BRep_Tool.hxx>
@@ -39,7 +40,9 @@
 #include <ShapeAnalysis_FreeBounds.hxx>
 #include <ShapeFix_ShapeTolerance.hxx>
 #include <TopoDS.hxx>
+#include <QDataStream>
 #include <QDebug>
+#include <algorithm>
 #include <cmath>
 
 
@@ -275,7 +278,7 @@ GraphicObject* GOContour::extendStart(double length) {
      gp_Pnt ep = c->Value(lp);
 
      if (c.IsNull()) {
-        qDebug() << "OUPS";
+        qCWarning(lcContour) << "OUPS";
         }
      segs.insert(segs.begin(), new GOLine(sp, ep));
      setStartPoint(sp);
@@ -289,6 +292,76 @@ GraphicObject* GOContour::extendStart(double length) {
   }
 
 
+// binary layout (little endian, doubles as 64bit):
+//   magic, version, center, level, segment count
+//   per segment: type, start, end [, center, axis, radius]
+// Segments are stored in chain order, so decoding is a single pass
+// without string handling or endpoint matching.
+// Returns nullptr on unknown versions or truncated data.
+GOContour* GOContour::fromBinary(const QByteArray& data) {
+  QDataStream in(data);
+  quint32     magic   = 0;
+  quint8      version = 0;
+  quint32     count   = 0;
+  qint32      level   = 0;
+  auto readPnt = [&in]() {
+    double x, y, z;
+
+    in >> x >> y >> z;
+
+    return gp_Pnt(x, y, z);
+    };
+
+  in.setByteOrder(QDataStream::LittleEndian);
+  in.setFloatingPointPrecision(QDataStream::DoublePrecision);
+  in >> magic >> version;
+  if (magic != BinaryMagic || version != BinaryVersion) {
+     qCWarning(lcContour) << "unsupported contour encoding" << QString::number(magic, 16) << (int)version;
+     return nullptr;
+     }
+  gp_Pnt center = readPnt();
+
+  in >> level >> count;
+  if (in.status() != QDataStream::Ok) return nullptr;
+  GOContour* rv = new GOContour(center, level);
+
+  // a line segment takes 49 bytes, so corrupt counts can't blow up memory
+  rv->segs.reserve(std::min<quint32>(count, data.size() / 49));
+  for (quint32 i=0; i < count; ++i) {
+      quint8 type = GTInvalid;
+
+      in >> type;
+      gp_Pnt from = readPnt();
+      gp_Pnt to   = readPnt();
+
+      if (type == GTLine && in.status() == QDataStream::Ok) {
+         rv->segs.push_back(new GOLine(from, to));
+         }
+      else if (type == GTCircle) {
+         gp_Pnt c = readPnt();
+         gp_Pnt a = readPnt();
+         double r = 0;
+
+         in >> r;
+         if (in.status() != QDataStream::Ok) break;
+         rv->segs.push_back(new GOCircle(from, to, c, gp_Dir(a.X(), a.Y(), a.Z()), r));
+         }
+      else break;
+      }
+  if (in.status() != QDataStream::Ok || rv->size() != (int)count) {
+     qCWarning(lcContour) << "corrupt contour data - decoded" << rv->size() << "of" << count << "segments";
+     for (auto s : rv->segs) delete s;
+     delete rv;
+     return nullptr;
+     }
+  if (count) {
+     rv->setStartPoint(rv->segs.front()->startPoint());
+     rv->setEndPoint(rv->segs.back()->endPoint());
+     }
+  return rv;
+  }
+
+
 bool GOContour::isClosed() const {
   return kute::isEqual(startPoint(), endPoint());
   }
@@ -324,6 +397,7 @@ gp_Pnt GOContour::midPoint() const {
 
 
 GraphicObject* GOContour::occ2GO(const TopoDS_Edge e, double defZ) {
+  TraceSpan span("GOContour::occ2GO");
   if (e.IsNull()) return nullptr;
   GraphicObject*     rv  = nullptr;
   GraphicObject*     xrv = nullptr;
@@ -334,15 +408,15 @@ GraphicObject* GOContour::occ2GO(const TopoDS_Edge e, double defZ) {
   p0 = c->Value(param0);
   p1 = c->Value(param1);
 
-  qDebug() << "occ2GO - curve parameters: " << param0 << " <> " << param1;
+  qCDebug(lcContour) << "occ2GO - curve parameters: " << param0 << " <> " << param1;
 
   if (c->DynamicType() == STANDARD_TYPE(Geom_Line)) {
-     qDebug() << "segment is LINE from" << p0.X() << " / " << p0.Y() << " / " << p0.Z()
+     qCDebug(lcContour) << "segment is LINE from" << p0.X() << " / " << p0.Y() << " / " << p0.Z()
               << " to "                 << p1.X() << " / " << p1.Y() << " / " << p1.Z();
      rv = new GOLine(p0, p1);
      }
   else if (c->DynamicType() == STANDARD_TYPE(Geom_Circle)) {
-     qDebug() << "segment is CIRCLE from" << p0.X() << " / " << p0.Y() << " / " << p0.Z()
+     qCDebug(lcContour) << "segment is CIRCLE from" << p0.X() << " / " << p0.Y() << " / " << p0.Z()
               << " to "                   << p1.X() << " / " << p1.Y() << " / " << p1.Z();
      Handle(Geom_Circle) hc = Handle(Geom_Circle)::DownCast(c);
 
@@ -353,7 +427,7 @@ GraphicObject* GOContour::occ2GO(const TopoDS_Edge e, double defZ) {
 
 //        if (!kute::isEqual(defZ, 0)) pm.SetZ(defZ);
 
-//        qDebug() << "splitted full circle at " << pm.X() << " / " << pm.Y() << " / " << pm.Z();
+//        qCDebug(lcContour) << "splitted full circle at " << pm.X() << " / " << pm.Y() << " / " << pm.Z();
 
 //        rv  = new GOCircle(hc, param0, p05);
 //        xrv = new GOCircle(hc, p05, param1);
@@ -445,6 +519,39 @@ int GOContour::size() const {
   }
 
 
+// returns empty array if contour holds segments, that have no
+// binary representation, so caller can fall back to text.
+QByteArray GOContour::toBinary() const {
+  QByteArray  rv;
+  QDataStream out(&rv, QIODevice::WriteOnly);
+  auto writePnt = [&out](const gp_Pnt& p) {
+    out << p.X() << p.Y() << p.Z();
+    };
+
+  out.setByteOrder(QDataStream::LittleEndian);
+  out.setFloatingPointPrecision(QDataStream::DoublePrecision);
+  out << BinaryMagic << BinaryVersion;
+  writePnt(center);
+  out << (qint32)level << (quint32)segs.size();
+  for (auto s : segs) {
+      out << (quint8)s->type();
+      writePnt(s->startPoint());
+      writePnt(s->endPoint());
+      if (s->type() == GTCircle) {
+         GOCircle* c = static_cast<GOCircle*>(s);
+
+         writePnt(c->centerPnt);
+         writePnt(gp_Pnt(c->axis.X(), c->axis.Y(), c->axis.Z()));
+         out << c->r;
+         }
+      else if (s->type() != GTLine) {
+         return QByteArray();
+         }
+      }
+  return rv;
+  }
+
+
 TopoDS_Shape GOContour::toWire(double z) {
   BRepBuilderAPI_MakeWire wireBuilder;
 
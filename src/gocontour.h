@@ -30,6 +30,7 @@
 #include "kuteCAM.h"
 #include <TopoDS_Shape.hxx>
 #include <TopoDS_Wire.hxx>
+#include <QByteArray>
 #include <vector>
 
 
@@ -63,9 +64,14 @@ public:
   std::vector<GraphicObject*>& segments();
   void                         setContour(TopoDS_Shape contour);
   std::vector<GraphicObject*>& simplify(double z, bool cw = true);
+  QByteArray                   toBinary() const;
 
+  static GOContour*            fromBinary(const QByteArray& data);
   static GraphicObject*        occ2GO(TopoDS_Edge e, double defZ = 0);
 
+  static const quint32         BinaryMagic   = 0x4b434331;   // "KCC1"
+  static const quint8          BinaryVersion = 1;
+
 protected:
   explicit GOContour(const QString& source);
 
@@ -0,0 +1,90 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       helixarc.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "helixarc.h"
+#include "kuteCAM.h"
+#include <algorithm>
+#include <cmath>
+
+
+HelixArc::HelixArc(const gp_Pnt& from, const gp_Pnt& to, const gp_Pnt& center, bool ccw)
+ : c(center)
+ , end(to)
+ , r(std::hypot(from.X() - center.X(), from.Y() - center.Y()))
+ , a0(std::atan2(from.Y() - center.Y(), from.X() - center.X()))
+ , a1(std::atan2(to.Y() - center.Y(), to.X() - center.X()))
+ , z0(from.Z())
+ , z1(to.Z()) {
+  if (kute::isEqual(gp_Pnt(from.X(), from.Y(), 0), gp_Pnt(to.X(), to.Y(), 0))) {
+     a1 = a0 + (ccw ? 2 : -2) * M_PI;                 // full turn
+     return;
+     }
+  if (ccw) { while (a1 < a0) a1 += 2 * M_PI; }
+  else     { while (a1 > a0) a1 -= 2 * M_PI; }
+  }
+
+
+bool HelixArc::isHelix() const {
+  return !kute::isEqual(z0, z1);
+  }
+
+
+double HelixArc::length() const {
+  return std::hypot(r * std::abs(a1 - a0), z1 - z0);
+  }
+
+
+// z rises linear with the angle, so the chord error of a helix equals
+// the sagitta of its projected circle
+int HelixArc::segments(double chordTolerance) const {
+  if (r < kute::MinDelta) return 1;
+  double tol  = std::max(chordTolerance, kute::MinDelta);
+  double step = tol < r ? 2 * std::acos(1 - tol / r) : M_PI;
+
+  return std::max(1, std::min(MaxSegments, (int)std::ceil(std::abs(a1 - a0) / step)));
+  }
+
+
+// appends points to buffer. Start point gets skipped, if buffer ends
+// with it already, so consecutive moves can share one buffer.
+void HelixArc::tessellate(double chordTolerance, std::vector<gp_Pnt>& buffer) const {
+  int n = segments(chordTolerance);
+
+  buffer.reserve(buffer.size() + n + 1);
+  if (buffer.empty() || !kute::isEqual(buffer.back(), value(0))) buffer.push_back(value(0));
+  for (int i=1; i < n; ++i) buffer.push_back(value((double)i / n));
+  buffer.push_back(end);
+  }
+
+
+gp_Pnt HelixArc::value(double t) const {
+  double a = a0 + (a1 - a0) * t;
+
+  return gp_Pnt(c.X() + r * std::cos(a), c.Y() + r * std::sin(a), z0 + (z1 - z0) * t);
+  }
+
+
+const int HelixArc::MaxSegments = 10000;
@@ -0,0 +1,61 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       helixarc.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef HELIXARC_H
+#define HELIXARC_H
+#include <gp_Pnt.hxx>
+#include <vector>
+
+
+// arc around an axis parallel to Z, rising linear with the angle, so
+// arcs with different Z at start and end are helices. Points get
+// evaluated analytically, which is all display and simulation need.
+// Start equal to end (in XY) means a full turn.
+class HelixArc
+{
+public:
+  HelixArc(const gp_Pnt& from, const gp_Pnt& to, const gp_Pnt& center, bool ccw);
+
+  bool   isHelix() const;
+  double length() const;
+  double radius() const { return r; }
+  int    segments(double chordTolerance) const;
+  double sweep() const  { return a1 - a0; }     // signed, ccw is positive
+  void   tessellate(double chordTolerance, std::vector<gp_Pnt>& buffer) const;
+  gp_Pnt value(double t) const;                 // t from 0 to 1
+
+  static const int MaxSegments;
+
+private:
+  gp_Pnt c;
+  gp_Pnt end;
+  double r;
+  double a0;
+  double a1;
+  double z0;
+  double z1;
+  };
+#endif // HELIXARC_H
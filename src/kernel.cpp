@@ -25,6 +25,7 @@
  * **************************************************************************
  */
 #include "kernel.h"
+#include "booleanengine.h"
 #include "core.h"
 #include "editorpage.h"
 #include "projectfile.h"
@@ -38,16 +39,20 @@
 #include "geomnodemodel.h"
 #include "setuppage.h"
 #include "operationspage.h"
+#include "pathpipeline.h"
 #include "pluginlistmodel.h"
 #include "preview3d.h"
 #include "selectionhandler.h"
 #include "shapelistmodel.h"
+#include "specpostprocessor.h"
 #include "tdfactory.h"
+#include "tooldatabase.h"
 #include "toollistmodel.h"
 #include "viseentry.h"
 #include "viselistmodel.h"
 #include "wsfactory.h"
 #include "xmltoolreader.h"
+#include "tracer.h"
 #include <BRepLib.hxx>
 #include <QApplication>
 #include <QCloseEvent>
@@ -59,18 +64,33 @@
 #include <QTranslator>
 
 
-Kernel::Kernel(QApplication& app, MainWindow& win)
+Kernel::Kernel(QApplication& app, MainWindow* win)
  : QObject(nullptr)
  , app(app)
  , win(win)
  , curLocale(nullptr)
  , configData(QSettings::UserScope, "SRD", app.applicationName())
  , helper(nullptr)
+ , boolEngine(new BooleanEngine)
+ , pathPipeline(new PathPipeline)
  , selHdr(nullptr)
  , pf(nullptr)
  , work(nullptr)
  , operations(nullptr)
  , config(nullptr)
+ , exactSections(false)
+ , adaptiveClearing(false)
+ , adaptiveMinLoad(0.5)
+ , chordTolerance(0.01)
+ , scallopHeight(0.01)
+ , trimAirCuts(false)
+ , keepDownLinks(false)
+ , featureInstancing(false)
+ , feedOptimization(false)
+ , feedMinFactor(0.5)
+ , feedMaxFactor(1.5)
+ , maxFeed(0)
+ , meshDeflection(0.02)
  , setupPage(nullptr)
 
  , tdFactory(new TDFactory)
@@ -78,6 +98,7 @@ Kernel::Kernel(QApplication& app, MainWindow& win)
  , matModel(new StringListModel(QStringList()))
  , shapeListModel(new ShapeListModel(this))
  , viseListModel(new ViseListModel(this))
+ , toolDB(nullptr)
  , toolListModel(new ToolListModel(this))
  , ppModel(new PluginListModel(this)) {
   BRepLib::Precision(1e-4);
@@ -152,6 +173,36 @@ void Kernel::getPostProcessors() {
          qDebug() << "plugin-loader error string: " << loader.errorString();
          }
       }
+  for (auto& fi : res) delete fi;
+
+  // generic postprocessors are described by spec files only. They get
+  // compiled once here for validation and again, when used for a job
+  sl.clear();
+  sl << "*.pps";
+  res = findFile(ppBase, sl, defFilter);
+  for (auto& fi : res) {
+      SpecPostProcessor spp;
+
+      if (spp.load(fi->absoluteFilePath())) {
+         QString name = spp.name().isEmpty() ? fi->baseName() : spp.name();
+
+         qDebug() << "spec " << name << "seems to be valid postprocessor";
+         ppModel->setData(name, fi->absoluteFilePath());
+         }
+      delete fi;
+      }
+  }
+
+
+// without main window there are no pages nor 3D view. Only the
+// parts needed to load models and tools and to create toolpaths
+// are available (used by benchmark and batch tools)
+void Kernel::initHeadless() {
+  view3D     = nullptr;
+  helper     = new Util3D();
+  selHdr     = new SelectionHandler();
+  work       = new Work();
+  loadConfig();
   }
 
 
@@ -163,10 +214,10 @@ void Kernel::initialize() {
   processAppArgs(app.arguments());
   curLocale = setupTranslators();
 
-  win.initialize();
+  win->initialize();
   getPostProcessors();
   loadConfig();
-  view3D     = win.viewer3D();
+  view3D     = win->viewer3D();
   config     = new ConfigPage(matModel, viseListModel);
   setupPage  = new SetupPage(matModel, viseListModel);
   operations = new OperationsPage();
@@ -180,14 +231,14 @@ void Kernel::initialize() {
   pages[Core::PgConfig]     = config;
   pages[Core::PgOperations] = operations;
 
-  win.setWindowTitle(QString("- %1 -").arg(app.applicationName()));
-  win.addPage(setupPage);
-  win.addPage(operations);
-  win.addPage(config);
-  win.restore();
+  win->setWindowTitle(QString("- %1 -").arg(app.applicationName()));
+  win->addPage(setupPage);
+  win->addPage(operations);
+  win->addPage(config);
+  win->restore();
 
   connect(view3D, &OcctQtViewer::clearCurves, this, &Kernel::clearCurves);
-  connect(operations, &OperationsPage::fileGenerated, win.editor, &EditorPage::loadFile);
+  connect(operations, &OperationsPage::fileGenerated, win->editor, &EditorPage::loadFile);
   connect(config, &ConfigPage::machineTypeChanged, operations, &OperationsPage::handleMachineType);
   configData.setValue("what", "nope");
   }
@@ -205,7 +256,22 @@ bool Kernel::loadConfig() {
   autoRotate = configData.value("autoRotateSelected").toBool();
   machineType = configData.value("machineType").toInt();
   genSepWithToolChange = configData.value("genSepToolChange").toBool();
+  exactSections = configData.value("exactSections", false).toBool();
+  meshDeflection = configData.value("meshDeflection", 0.02).toDouble();
+  adaptiveClearing = configData.value("adaptiveClearing", false).toBool();
+  adaptiveMinLoad = configData.value("adaptiveMinLoad", 0.5).toDouble();
+  chordTolerance = configData.value("chordTolerance", 0.01).toDouble();
+  scallopHeight = configData.value("scallopHeight", 0.01).toDouble();
+  trimAirCuts = configData.value("trimAirCuts", false).toBool();
+  keepDownLinks = configData.value("keepDownLinks", false).toBool();
+  featureInstancing = configData.value("featureInstancing", false).toBool();
+  feedOptimization = configData.value("feedOptimization", false).toBool();
+  feedMinFactor = configData.value("feedMinFactor", 0.5).toDouble();
+  feedMaxFactor = configData.value("feedMaxFactor", 1.5).toDouble();
+  maxFeed = configData.value("maxFeed", 0).toDouble();
   configData.endGroup();
+  boolEngine->loadProfile(configData);
+  pathPipeline->loadProfile(configData);
   if (rv) rv = loadViseList();
 
   return rv;
@@ -213,7 +279,8 @@ bool Kernel::loadConfig() {
 
 
 bool Kernel::loadModelFile(const QString &fileName) {
-  win.setWindowTitle(QString("- %1 -- %2 -").arg(app.applicationName(), fileName));
+  TraceSpan span("Kernel::loadModelFile");
+  if (win) win->setWindowTitle(QString("- %1 -- %2 -").arg(app.applicationName(), fileName));
 
   if (fileName.endsWith(".brep"))     topShape = helper->loadBRep(fileName);
   else if (fileName.endsWith(".step")
@@ -282,7 +349,7 @@ bool Kernel::loadProject(const QString &fileName) {
   else                             topShape = helper->loadStep(modelFile);
   pf->endGroup();
   if (tfn.exists()) loadTools(tfn.fileName());
-  win.setWindowTitle(QString("- %1 -- %2 -").arg(app.applicationName(), fileName));
+  win->setWindowTitle(QString("- %1 -- %2 -").arg(app.applicationName(), fileName));
   setupPage->loadProject(pf, topShape);
   operations->loadProject(pf);
 
@@ -290,17 +357,31 @@ bool Kernel::loadProject(const QString &fileName) {
   }
 
 
+// tool libraries come as xml document or as indexed database
 bool Kernel::loadTools(const QString &fileName) {
   QFile inFile(fileName);
   XmlToolReader xtr;
 
-  if (inFile.exists()) {
-     toolListModel->setData(xtr.read(&inFile));
-     inFile.close();
+  if (!inFile.exists()) return false;
+  if (fileName.endsWith(".db")) {
+     ToolDatabase* db = new ToolDatabase(fileName, this);
+
+     if (!db->isOpen()) {
+        delete db;
+        return false;
+        }
+     toolListModel->setDatabase(db);
+     delete toolDB;
+     toolDB = db;
 
      return true;
      }
-  return false;
+  toolListModel->setData(xtr.read(&inFile));
+  inFile.close();
+  delete toolDB;
+  toolDB = nullptr;
+
+  return true;
   }
 
 
@@ -366,17 +447,21 @@ bool Kernel::loadViseList() {
 void Kernel::onShutdown(QCloseEvent* ce) {
   QMap<QString, ApplicationWindow*>::const_iterator i = pages.constBegin();
 
+  boolEngine->dumpStats();
+
   while (i != pages.constEnd()) {
         qDebug() << "shutdown page:" << i.key();
         i.value()->closeEvent(ce);
         ++i;
         }
-  configData.beginGroup("MainWindow");
-  configData.setValue("geometry",    win.saveGeometry());
-  configData.setValue("windowState", win.saveState());
-  configData.setValue("spGeom", win.sp->saveGeometry());
-  configData.setValue("spState", win.sp->saveState());
-  configData.endGroup();
+  if (win) {
+     configData.beginGroup("MainWindow");
+     configData.setValue("geometry",    win->saveGeometry());
+     configData.setValue("windowState", win->saveState());
+     configData.setValue("spGeom", win->sp->saveGeometry());
+     configData.setValue("spState", win->sp->saveState());
+     configData.endGroup();
+     }
   if (!pf) return;
   const QString& tfn = pf->tempFileName();
   const QString& fn  = pf->fileName();
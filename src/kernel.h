@@ -34,6 +34,8 @@
 #include <TopoDS_Shape.hxx>
 #include <ShapeFix_ShapeTolerance.hxx>
 class ApplicationWindow;
+class BooleanEngine;
+class PathPipeline;
 class OcctQtViewer;
 class MainWindow;
 class ProjectFile;
@@ -46,7 +48,9 @@ class PluginListModel;
 class SelectionHandler;
 class SetupPage;
 class ShapeListModel;
+class SpecPostProcessor;
 class TDFactory;
+class ToolDatabase;
 class ToolListModel;
 class ViseEntry;
 class ViseListModel;
@@ -62,7 +66,7 @@ class Kernel : public QObject
 {
   Q_OBJECT
 public:
-  explicit Kernel(QApplication& app, MainWindow& win);
+  explicit Kernel(QApplication& app, MainWindow* win = nullptr);
 
   bool loadConfig();
   bool loadModelFile(const QString& fileName);
@@ -72,6 +76,7 @@ public:
 protected:
   void getPostProcessors();
   std::vector<QFileInfo*> findFile(const QDir& dir, const QStringList& nameFilters, QDir::Filters defFilters);
+  void initHeadless();
   void initialize();  
   bool loadMaterials();
   bool loadTools(const QString &fileName);
@@ -86,13 +91,15 @@ protected slots:
 
 private:
   QApplication&                     app;
-  MainWindow&                       win;
+  MainWindow*                       win;
   QLocale*                          curLocale;
   QSettings                         configData;
   QMap<QString, ApplicationWindow*> pages;
   ShapeFix_ShapeTolerance           shapeTolerance;
   OcctQtViewer*                     view3D;
   Util3D*                           helper;
+  BooleanEngine*                    boolEngine;
+  PathPipeline*                     pathPipeline;
   SelectionHandler*                 selHdr;
   ProjectFile*                      pf;
   TopoDS_Shape                      topShape;
@@ -104,6 +111,19 @@ private:
   bool                              AisTable;
   bool                              BisTable;
   bool                              CisTable;  
+  bool                              exactSections;
+  bool                              adaptiveClearing;
+  double                            adaptiveMinLoad;
+  double                            chordTolerance;
+  double                            scallopHeight;
+  bool                              trimAirCuts;
+  bool                              keepDownLinks;
+  bool                              featureInstancing;
+  bool                              feedOptimization;
+  double                            feedMinFactor;
+  double                            feedMaxFactor;
+  double                            maxFeed;
+  double                            meshDeflection;
   bool                              genSepWithToolChange;
   bool                              opAllInOne;
   QString                           langDir;
@@ -114,8 +134,10 @@ private:
   StringListModel*                  matModel;
   ShapeListModel*                   shapeListModel;
   ViseListModel*                    viseListModel;
+  ToolDatabase*                     toolDB;
   ToolListModel*                    toolListModel;
   PluginListModel*                  ppModel;
+  QMap<QString, SpecPostProcessor*> specPPs;      // compiled specs by path
   friend class Core;  
   };
 #endif // KERNEL_H
@@ -29,6 +29,10 @@
 #include <QObject>
 
 
+Q_LOGGING_CATEGORY(lcContour, "kute.contour", QtInfoMsg)
+Q_LOGGING_CATEGORY(lcPath,    "kute.path",    QtInfoMsg)
+
+
 namespace kute {
 
 int getDominantAxis(const gp_Dir& dir) {
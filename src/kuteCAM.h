@@ -27,10 +27,17 @@
 #define KUTECAM_H
 #include <gp_Dir.hxx>
 #include <gp_Pnt.hxx>
+#include <QLoggingCategory>
 #include <QString>
 #include <cmath>
 
 
+// debug output of hot paths is disabled by default. Enable it with
+// i.e. QT_LOGGING_RULES="kute.path.debug=true"
+Q_DECLARE_LOGGING_CATEGORY(lcContour)
+Q_DECLARE_LOGGING_CATEGORY(lcPath)
+
+
 namespace kute {
 extern int getDominantAxis(const gp_Dir& dir);
 extern double textAsDouble(const QString& value);
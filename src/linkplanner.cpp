@@ -0,0 +1,135 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       linkplanner.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "linkplanner.h"
+#include "kuteCAM.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include "workstep.h"
+#include "wstraverse.h"
+#include <QDebug>
+#include <algorithm>
+
+
+LinkPlanner::LinkPlanner(const StockModel& stock, const ToolEntry* tool, double clearance)
+ : stock(stock)
+ , lift(0)
+ , clearance(clearance)
+ , valid(false) {
+  valid = StockModel::cutterOf(tool, cutter, lift);
+  }
+
+
+// link is: up at start, over at link height and down to end. Going
+// up is free, as the cutter just left the stock there and the stock
+// model has no overhangs. Returns length of the link or a negative
+// value, if there is no link below zMax.
+double LinkPlanner::genLink(std::vector<Workstep*>& link, const gp_Pnt& from, const gp_Pnt& to, double zMax, bool& down) const {
+  double zLink = std::max(from.Z(), to.Z()) + clearance;
+  gp_Pnt p0(from.X(), from.Y(), zLink);
+  gp_Pnt p1(to.X(),   to.Y(),   zLink);
+
+  down = isFree(p0, p1);
+  if (!down) {
+     zLink = std::max(zLink, stock.maxTop(from, to, cutter.radius) - lift + clearance);
+     p0.SetZ(zLink);
+     p1.SetZ(zLink);
+     }
+  if (zLink >= zMax - kute::MinDelta) return -1;
+  if (!isFree(p1, to)) return -1;
+  double len = 0;
+
+  for (const gp_Pnt& p : {p0, p1, to}) {
+      const gp_Pnt& last = link.size() ? link.back()->endPos() : from;
+
+      if (kute::isEqual(last, p)) continue;
+      len += last.Distance(p);
+      link.push_back(new WSTraverse(last, p));
+      }
+  return len;
+  }
+
+
+bool LinkPlanner::isFree(const gp_Pnt& from, const gp_Pnt& to) const {
+  gp_Pnt a(from.X(), from.Y(), from.Z() + lift);
+  gp_Pnt b(to.X(),   to.Y(),   to.Z()   + lift);
+
+  return !stock.removesMaterial(a, b, cutter);
+  }
+
+
+// stock gets updated by all cuts, so each link sees the material
+// left at its position in the toolpath. Traverses before the first
+// and after the last cut stay as they are.
+LinkPlanner::Result LinkPlanner::plan(std::vector<Workstep*>& path) {
+  TraceSpan              span("LinkPlanner::plan");
+  Result                 rv;
+  std::vector<Workstep*> out;
+  int                    mx = path.size();
+
+  if (!valid) return rv;
+  out.reserve(mx);
+  for (int i=0; i < mx; ) {
+      Workstep* ws = path[i];
+
+      if (ws->type() != WTTraverse) {
+         stock.apply(ws, cutter, lift);
+         out.push_back(ws);
+         ++i;
+         continue;
+         }
+      int    j       = i;
+      double zMax    = ws->startPos().Z();
+      double origLen = 0;
+
+      while (j < mx && path[j]->type() == WTTraverse) {
+            zMax     = std::max(zMax, path[j]->endPos().Z());
+            origLen += path[j]->startPos().Distance(path[j]->endPos());
+            ++j;
+            }
+      std::vector<Workstep*> link;
+      bool                   down = false;
+      double                 len  = -1;
+
+      if (i > 0 && j < mx)
+         len = genLink(link, ws->startPos(), path[j - 1]->endPos(), zMax, down);
+      if (len >= 0 && len < origLen - kute::MinDelta) {
+         for (int k=i; k < j; ++k) delete path[k];
+         out.insert(out.end(), link.begin(), link.end());
+         ++rv.links;
+         if (down) ++rv.keptDown;
+         rv.savedLength += origLen - len;
+         }
+      else {
+         for (Workstep* l : link) delete l;
+         out.insert(out.end(), path.begin() + i, path.begin() + j);
+         }
+      i = j;
+      }
+  path.swap(out);
+
+  return rv;
+  }
@@ -0,0 +1,64 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       linkplanner.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef LINKPLANNER_H
+#define LINKPLANNER_H
+#include "stockmodel.h"
+#include <vector>
+class ToolEntry;
+class Workstep;
+
+
+// replaces the traverses between two cuts (usually retract to safe
+// height, move over and plunge) by a link, that is checked against
+// the stock left at that point of the toolpath. The link stays down
+// at clearance above the higher end, if the direct way is free, or
+// lifts only above the highest stock between both ends.
+class LinkPlanner
+{
+public:
+  struct Result {
+    int    links       = 0;   // traverse runs replaced
+    int    keptDown    = 0;   // ... of them without lifting
+    double savedLength = 0;   // mm of rapid moves
+    };
+  LinkPlanner(const StockModel& stock, const ToolEntry* tool, double clearance);
+
+  bool   isValid() const { return valid; }
+  Result plan(std::vector<Workstep*>& path);
+
+protected:
+  double genLink(std::vector<Workstep*>& link, const gp_Pnt& from, const gp_Pnt& to, double zMax, bool& down) const;
+  bool   isFree(const gp_Pnt& from, const gp_Pnt& to) const;
+
+private:
+  StockModel  stock;
+  CutterShape cutter;
+  double      lift;
+  double      clearance;
+  bool        valid;
+  };
+#endif // LINKPLANNER_H
@@ -0,0 +1,285 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       meshslicer.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "meshslicer.h"
+#include "kuteCAM.h"
+#include "tracer.h"
+#include <BRepBuilderAPI_MakePolygon.hxx>
+#include <BRepMesh_IncrementalMesh.hxx>
+#include <BRep_Builder.hxx>
+#include <BRep_Tool.hxx>
+#include <Poly_Triangulation.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopLoc_Location.hxx>
+#include <TopoDS.hxx>
+#include <TopoDS_Compound.hxx>
+#include <TopoDS_Face.hxx>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+#include <unordered_map>
+
+
+MeshSlicer::MeshSlicer(const TopoDS_Shape& shape, double deflection, double tolerance)
+ : deflection(deflection)
+ , tolerance(tolerance) {
+  triangulate(shape);
+  }
+
+
+// chain all segments of one level. Endpoints closer than tolerance
+// are merged by a grid hash with cell size of tolerance, so lookup
+// of coincident points is constant time.
+std::vector<SlicePolyline> MeshSlicer::chainSegments(const std::vector<Segment>& segments) const {
+  std::vector<SlicePolyline>                      rv;
+  std::unordered_map<long long, std::vector<int>> grid;
+  std::vector<gp_Pnt>                             points;
+  std::vector<std::vector<int>>                   adj;
+  std::vector<int>                                ends(segments.size() * 2, -1);
+  auto cellKey = [](long long ix, long long iy) {
+    return (ix << 32) ^ (iy & 0xffffffffLL);
+    };
+  auto pointID = [&](const gp_Pnt& p) {
+    long long ix = std::floor(p.X() / tolerance);
+    long long iy = std::floor(p.Y() / tolerance);
+
+    for (long long dx=-1; dx <= 1; ++dx) {
+        for (long long dy=-1; dy <= 1; ++dy) {
+            auto it = grid.find(cellKey(ix + dx, iy + dy));
+
+            if (it == grid.end()) continue;
+            for (int id : it->second) {
+                if (points[id].Distance(p) < tolerance) return id;
+                }
+            }
+        }
+    int id = points.size();
+
+    points.push_back(p);
+    adj.emplace_back();
+    grid[cellKey(ix, iy)].push_back(id);
+
+    return id;
+    };
+
+  for (int i=0; i < (int)segments.size(); ++i) {
+      int a = pointID(segments[i].p0);
+      int b = pointID(segments[i].p1);
+
+      if (a == b) continue;           // degenerated segment
+      ends[2 * i]     = a;
+      ends[2 * i + 1] = b;
+      adj[a].push_back(i);
+      adj[b].push_back(i);
+      }
+  std::vector<bool> used(segments.size(), false);
+  auto walk = [&](int start) {
+    SlicePolyline pl;
+    int           cur = start;
+
+    pl.points.push_back(points[cur]);
+    for (;;) {
+        int next = -1;
+
+        for (int s : adj[cur]) {
+            if (!used[s]) {
+               next = s;
+               break;
+               }
+            }
+        if (next < 0) break;
+        used[next] = true;
+        cur = ends[2 * next] == cur ? ends[2 * next + 1] : ends[2 * next];
+        if (cur == start) {
+           pl.closed = true;
+           break;
+           }
+        pl.points.push_back(points[cur]);
+        }
+    if (pl.points.size() > 1) {
+       simplify(pl);
+       rv.push_back(pl);
+       }
+    };
+
+  // open chains first (start at dangling ends), then all loops
+  for (int i=0; i < (int)points.size(); ++i)
+      if (adj[i].size() % 2) walk(i);
+  for (int i=0; i < (int)segments.size(); ++i)
+      if (!used[i] && ends[2 * i] >= 0) walk(ends[2 * i]);
+
+  if (lcPath().isDebugEnabled()) {
+     int open = 0;
+
+     for (auto& pl : rv) if (!pl.closed) ++open;
+     qCDebug(lcPath) << "MS: chained" << segments.size() << "segments to"
+                     << rv.size() << "polylines (" << open << "open)";
+     }
+  return rv;
+  }
+
+
+// nodes with Z >= z count as above, so vertices lying exactly
+// on the plane never produce degenerated or duplicate segments.
+void MeshSlicer::cutTriangle(const Triangle& t, double z, std::vector<Segment>& segments) const {
+  gp_Pnt cut[2];
+  int    nCut = 0;
+
+  for (int i=0; i < 3; ++i) {
+      int a = t.n[i];
+      int b = t.n[(i + 1) % 3];
+
+      if ((nodes[a].Z() >= z) == (nodes[b].Z() >= z)) continue;
+      if (a > b) std::swap(a, b);     // same edge - same point on both triangles
+      const gp_Pnt& pa = nodes[a];
+      const gp_Pnt& pb = nodes[b];
+      double        f  = (z - pa.Z()) / (pb.Z() - pa.Z());
+
+      cut[nCut++] = gp_Pnt(pa.X() + f * (pb.X() - pa.X())
+                         , pa.Y() + f * (pb.Y() - pa.Y())
+                         , z);
+      }
+  if (nCut == 2) segments.push_back({cut[0], cut[1]});
+  }
+
+
+// drop points that deviate less than tolerance from the line
+// between their neighbors
+void MeshSlicer::simplify(SlicePolyline& pl) const {
+  if (pl.points.size() < 3) return;
+  std::vector<gp_Pnt> res;
+  int                 mx = pl.points.size();
+
+  res.reserve(mx);
+  res.push_back(pl.points[0]);
+  for (int i=1; i < mx; ++i) {
+      const gp_Pnt& p    = pl.points[i];
+      bool          last = i + 1 == mx;
+
+      if (last && !pl.closed) {           // keep end of open chain
+         res.push_back(p);
+         break;
+         }
+      const gp_Pnt& a  = res.back();
+      const gp_Pnt& b  = last ? pl.points[0] : pl.points[i + 1];
+      double        dx = b.X() - a.X();
+      double        dy = b.Y() - a.Y();
+      double        l  = std::sqrt(dx * dx + dy * dy);
+
+      if (l > tolerance) {
+         double d = std::abs((p.X() - a.X()) * dy - (p.Y() - a.Y()) * dx) / l;
+
+         if (d < tolerance) continue;
+         }
+      res.push_back(p);
+      }
+  pl.points.swap(res);
+  }
+
+
+std::vector<SlicePolyline> MeshSlicer::slice(double z) const {
+  return slice(std::vector<double>{z}).front();
+  }
+
+
+std::vector<std::vector<SlicePolyline>> MeshSlicer::slice(const std::vector<double>& levels) const {
+  TraceSpan span("MeshSlicer::slice");
+  std::vector<std::vector<SlicePolyline>> rv(levels.size());
+  std::vector<int>                        order(levels.size());
+  std::vector<int>                        active;
+  std::vector<Segment>                    segments;
+  size_t                                  next = 0;
+
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&](int l, int r) { return levels[l] < levels[r]; });
+
+  for (int li : order) {
+      double z = levels[li];
+
+      while (next < tris.size() && tris[next].zMin <= z) active.push_back(next++);
+      for (size_t i=0; i < active.size(); ) {
+          if (tris[active[i]].zMax < z) {
+             active[i] = active.back();
+             active.pop_back();
+             }
+          else ++i;
+          }
+      segments.clear();
+      for (int ti : active) cutTriangle(tris[ti], z, segments);
+      rv[li] = chainSegments(segments);
+      }
+  return rv;
+  }
+
+
+TopoDS_Shape MeshSlicer::toShape(const std::vector<SlicePolyline>& section) const {
+  BRep_Builder    builder;
+  TopoDS_Compound comp;
+
+  builder.MakeCompound(comp);
+  for (auto& pl : section) {
+      BRepBuilderAPI_MakePolygon poly;
+
+      for (auto& p : pl.points) poly.Add(p);
+      if (pl.closed) poly.Close();
+      if (poly.IsDone()) builder.Add(comp, poly.Wire());
+      }
+  return comp;
+  }
+
+
+void MeshSlicer::triangulate(const TopoDS_Shape& shape) {
+  TraceSpan span("MeshSlicer::triangulate");
+  BRepMesh_IncrementalMesh mesher(shape, deflection, false, 0.5, true);
+
+  for (TopExp_Explorer faceExplorer(shape, TopAbs_FACE)
+     ; faceExplorer.More()
+     ; faceExplorer.Next()) {
+      const TopoDS_Face&         face = TopoDS::Face(faceExplorer.Current());
+      TopLoc_Location            loc;
+      Handle(Poly_Triangulation) pt   = BRep_Tool::Triangulation(face, loc);
+
+      if (pt.IsNull()) continue;
+      const gp_Trsf& trsf = loc.Transformation();
+      int            base = nodes.size();
+
+      for (int i=1; i <= pt->NbNodes(); ++i)
+          nodes.push_back(pt->Node(i).Transformed(trsf));
+      for (int i=1; i <= pt->NbTriangles(); ++i) {
+          Triangle t;
+
+          pt->Triangle(i).Get(t.n[0], t.n[1], t.n[2]);
+          for (int& n : t.n) n += base - 1;
+          t.zMin = std::min({nodes[t.n[0]].Z(), nodes[t.n[1]].Z(), nodes[t.n[2]].Z()});
+          t.zMax = std::max({nodes[t.n[0]].Z(), nodes[t.n[1]].Z(), nodes[t.n[2]].Z()});
+          tris.push_back(t);
+          }
+      }
+  std::sort(tris.begin(), tris.end(), [](const Triangle& l, const Triangle& r) { return l.zMin < r.zMin; });
+
+  qCDebug(lcPath) << "MS: mesh has" << nodes.size() << "nodes and" << tris.size() << "triangles";
+  }
@@ -0,0 +1,78 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       meshslicer.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef MESHSLICER_H
+#define MESHSLICER_H
+#include <gp_Pnt.hxx>
+#include <TopoDS_Shape.hxx>
+#include <vector>
+
+
+// closed (or open, if mesh is not watertight) polyline of a Z-section
+struct SlicePolyline
+{
+  std::vector<gp_Pnt> points;
+  bool                closed = false;
+  };
+
+
+// triangulates a shape once and computes any number of horizontal
+// sections from that mesh. Levels are processed by a sweep over
+// the triangles sorted by their lowest Z, so each triangle gets
+// touched only while it spans the current level.
+class MeshSlicer
+{
+public:
+  MeshSlicer(const TopoDS_Shape& shape, double deflection = 0.02, double tolerance = 0.001);
+
+  int                                     nodeCount() const     { return nodes.size(); }
+  int                                     triangleCount() const { return tris.size(); }
+  std::vector<SlicePolyline>              slice(double z) const;
+  std::vector<std::vector<SlicePolyline>> slice(const std::vector<double>& levels) const;
+  TopoDS_Shape                            toShape(const std::vector<SlicePolyline>& section) const;
+
+protected:
+  struct Triangle {
+    int    n[3];
+    double zMin;
+    double zMax;
+    };
+  struct Segment {
+    gp_Pnt p0;
+    gp_Pnt p1;
+    };
+  void                       cutTriangle(const Triangle& t, double z, std::vector<Segment>& segments) const;
+  std::vector<SlicePolyline> chainSegments(const std::vector<Segment>& segments) const;
+  void                       simplify(SlicePolyline& pl) const;
+  void                       triangulate(const TopoDS_Shape& shape);
+
+private:
+  double                deflection;
+  double                tolerance;
+  std::vector<gp_Pnt>   nodes;
+  std::vector<Triangle> tris;   // sorted by zMin
+  };
+#endif // MESHSLICER_H
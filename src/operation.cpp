@@ -48,6 +48,7 @@ Operation::Operation(int id, OperationType ot, QObject *parent)
  , curTool(0)
  , outside(true)
  , absolute(true)
+ , restMachining(false)
  , opA(0)
  , opB(0)
  , opC(0)
@@ -83,6 +84,7 @@ Operation::Operation(int id, QObject *parent)
  , curTool(0)
  , outside(true)
  , absolute(true)
+ , restMachining(false)
  , opA(0)
  , opB(0)
  , opC(0)
@@ -118,6 +120,7 @@ Operation::Operation(QObject* parent)
  , curTool(0)
  , outside(true)
  , absolute(true)
+ , restMachining(false)
  , opA(0)
  , opB(0)
  , opC(0)
@@ -214,6 +217,11 @@ bool Operation::isAbsolute() const {
   }
 
 
+bool Operation::isRestMachining() const {
+  return restMachining;
+  }
+
+
 bool Operation::isVertical() const {
   return vertical;
   }
@@ -440,6 +448,11 @@ void Operation::setQmax(double q) {
   }
 
 
+void Operation::setRestMachining(bool rest) {
+  restMachining = rest;
+  }
+
+
 void Operation::setSafeZ0(double z) {
   retZ0 = z;
   }
@@ -501,6 +514,7 @@ void Operation::restore(QSettings& s) {
   setSafeZ1(s.value("R1").toDouble());
   setSpeed(s.value("vc").toDouble());
   setVertical(s.value("vertical").toBool());
+  setRestMachining(s.value("restMachining", false).toBool());
   setWaterlineDepth(s.value("wld").toDouble());
   setDrillDepth(s.value("dz").toDouble());
   setFinalDepth(s.value("z").toDouble());
@@ -549,6 +563,7 @@ void Operation::store(QSettings& s) {
   s.setValue("R1", safeZ1());
   s.setValue("vc", speed());
   s.setValue("vertical", isVertical());
+  s.setValue("restMachining", isRestMachining());
   s.setValue("wld", waterlineDepth());
   s.setValue("dz", drillDepth());
   s.setValue("z", finalDepth());
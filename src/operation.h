@@ -32,9 +32,11 @@
 #include <AIS_Shape.hxx>
 #include <Bnd_Box.hxx>
 #include <TopoDS_Edge.hxx>
+#include <memory>
 #include <set>
 class GOContour;
 class QSettings;
+class StockModel;
 class TargetDefinition;
 class TDFactory;
 class ToolEntry;
@@ -97,6 +99,7 @@ public:
   int           fixture() const;
   bool          isAbsolute() const;
   bool          isOutside() const;
+  bool          isRestMachining() const;
   bool          isVertical() const;
   int           kind() const;
   QString       kindAsString() const;
@@ -149,6 +152,7 @@ public:
   void    setOutside(bool outside);
   void    setQmin(double q);
   void    setQmax(double q);
+  void    setRestMachining(bool rest);
   void    setRetract(double r);
   void    setSafeZ0(double z);
   void    setSafeZ1(double z);
@@ -172,6 +176,7 @@ public:
   std::vector<TargetDefinition*> targets;
   QVector<Handle(AIS_Shape)>     toolPaths;
   Handle(AIS_Shape)              cutPart;
+  std::shared_ptr<StockModel>    restStock;   // stock left by previous operations
   GOContour*                     cutShape;
   bool                           showCutPlanes;
   bool                           showCutParts;
@@ -196,6 +201,7 @@ private:
   bool                      outside;
   bool                      absolute;
   bool                      vertical;
+  bool                      restMachining;
   double                    ae;
   double                    ap;
   double                    depth2Drill; // calculated
@@ -26,7 +26,12 @@
  */
 #include "operationlistmodel.h"
 #include "operation.h"
+#include "kuteCAM.h"
+#include "stockmodel.h"
+#include "toolentry.h"
+#include "tracer.h"
 #include <QDebug>
+#include <algorithm>
 
 
 OperationListModel::OperationListModel(QObject *parent)
@@ -111,6 +116,28 @@ bool OperationListModel::removeRows(int row, int count, const QModelIndex& paren
   }
 
 
+// stock left by all operations in front of op, that work on the same
+// fixture and orientation. Operations with different orientation are
+// ignored, so the result may contain more stock than is left for real.
+StockModel* OperationListModel::restStock(const Operation* op) const {
+  TraceSpan span("OperationListModel::restStock");
+
+  if (!op || op->workPiece.IsNull()) return nullptr;
+  double      r  = op->toolEntry() ? op->toolEntry()->fluteDiameter() / 2 : 1;
+  StockModel* sm = new StockModel(op->workPiece->Shape(), std::max(0.1, r / 4));
+
+  for (Operation* prev : list) {
+      if (prev == op) break;
+      if (prev->fixture() != op->fixture()
+       || !kute::isEqual(prev->operationA(), op->operationA())
+       || !kute::isEqual(prev->operationB(), op->operationB())
+       || !kute::isEqual(prev->operationC(), op->operationC())) continue;
+      sm->apply(prev->workSteps(), prev->toolEntry());
+      }
+  return sm;
+  }
+
+
 int OperationListModel::rowCount(const QModelIndex& parent) const {
   return list.count();
   }
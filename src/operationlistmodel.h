@@ -29,6 +29,7 @@
 #include <QAbstractListModel>
 #include <QVector>
 class Operation;
+class StockModel;
 
 
 class OperationListModel : public QAbstractListModel
@@ -45,6 +46,7 @@ public:
   virtual void                insertData(Operation* op);
   virtual void                moveUp(const QModelIndex& index);
   virtual void                moveDown(const QModelIndex& index);
+  virtual StockModel*         restStock(const Operation* op) const;
   virtual bool                removeRows(int row, int count, const QModelIndex &parent = QModelIndex()) override;
   virtual int                 rowCount(const QModelIndex& parent = QModelIndex()) const override;
   virtual void                setData(const QVector<Operation*>& ops);
@@ -0,0 +1,182 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       operationscheduler.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "operationscheduler.h"
+#include "operation.h"
+#include "toolentry.h"
+#include "workstep.h"
+#include "kuteCAM.h"
+#include "tracer.h"
+#include <QDebug>
+#include <algorithm>
+
+
+const double OperationScheduler::DefaultToolChangeTime = 15;
+
+
+OperationScheduler::OperationScheduler(double toolChangeTime, double rapidFeed)
+ : tcTime(toolChangeTime)
+ , rapidFeed(rapidFeed) {
+  }
+
+
+// XY footprint of the cutting moves, enlarged by tool radius. Arcs
+// are taken by their endpoints, which is good enough to tell overlaps
+// of operations apart. Traverses (and the approach from tool change
+// position) don't cut, so they neither count for area nor for start
+// and end of the operation.
+OperationScheduler::Item OperationScheduler::itemOf(Operation* op) const {
+  Item                          rv { op, Bnd_Box(), gp_Pnt(), gp_Pnt() };
+  const std::vector<Workstep*>& path  = op->workSteps();
+  bool                          first = true;
+  auto                          flat  = [](const gp_Pnt& p) { return gp_Pnt(p.X(), p.Y(), 0); };
+
+  for (Workstep* ws : path) {
+      if (ws->type() == WTTraverse || ws->startPos().Z() >= 300) continue;
+      rv.area.Add(flat(ws->startPos()));
+      rv.area.Add(flat(ws->endPos()));
+      if (first) rv.start = ws->startPos();
+      rv.end = ws->endPos();
+      first  = false;
+      }
+  if (!rv.area.IsVoid() && op->toolEntry())
+     rv.area.Enlarge(op->toolEntry()->fluteDiameter() / 2);
+
+  return rv;
+  }
+
+
+// first is listed before second
+bool OperationScheduler::mustPrecede(const Item& first, const Item& second) const {
+  const Operation* a = first.op;
+  const Operation* b = second.op;
+
+  if (a->fixture() != b->fixture()
+   || !kute::isEqual(a->operationA(), b->operationA())
+   || !kute::isEqual(a->operationB(), b->operationB())
+   || !kute::isEqual(a->operationC(), b->operationC())) return true;
+  if (b->isRestMachining()) return true;
+  if (a->cutType() == CutRoughing && b->cutType() == CutFinish) return true;
+  if (a->kind() == DrillOperation && b->kind() == DrillOperation
+   && a->drillCycle() != Tapping  && b->drillCycle() == Tapping) return true;
+  if (first.area.IsVoid() || second.area.IsVoid()) return false;
+
+  return !first.area.IsOut(second.area);
+  }
+
+
+// rapids between operations with the same tool. A tool change
+// moves to the change position anyway.
+double OperationScheduler::rapidLength(const std::vector<const Item*>& order) const {
+  double rv = 0;
+
+  for (size_t i=1; i < order.size(); ++i) {
+      if (order[i - 1]->op->toolNum() != order[i]->op->toolNum()) continue;
+      rv += order[i - 1]->end.Distance(order[i]->start);
+      }
+  return rv;
+  }
+
+
+// greedy topological order: among the operations, that have all their
+// predecessors done, take one with current tool and nearest start.
+// Without such, the first one of the list keeps the users order.
+OperationScheduler::Result OperationScheduler::schedule(const QVector<Operation*>& operations) const {
+  TraceSpan                     span("OperationScheduler::schedule");
+  Result                        rv;
+  int                           mx = operations.size();
+  std::vector<Item>             items;
+  std::vector<std::vector<int>> successors(mx);
+  std::vector<int>              pending(mx, 0);
+  std::vector<bool>             done(mx, false);
+  std::vector<const Item*>      listed;
+  std::vector<const Item*>      proposed;
+
+  rv.order = operations;
+  if (mx < 2) return rv;
+  items.reserve(mx);
+  for (Operation* op : operations) items.push_back(itemOf(op));
+  for (int i=0; i < mx; ++i) {
+      listed.push_back(&items[i]);
+      for (int j=i + 1; j < mx; ++j) {
+          if (mustPrecede(items[i], items[j])) {
+             successors[i].push_back(j);
+             ++pending[j];
+             }
+          }
+      }
+  const Item* last = nullptr;
+
+  for (int n=0; n < mx; ++n) {
+      int    best     = -1;
+      int    near     = -1;
+      double nearDist = 0;
+
+      for (int i=0; i < mx; ++i) {
+          if (done[i] || pending[i]) continue;
+          if (best < 0) best = i;        // first ready keeps list order
+          if (!last || items[i].op->toolNum() != last->op->toolNum()) continue;
+          double d = last->end.Distance(items[i].start);
+
+          if (near < 0 || d < nearDist) {
+             near     = i;
+             nearDist = d;
+             }
+          }
+      if (near >= 0) best = near;
+      done[best] = true;
+      for (int s : successors[best]) --pending[s];
+      last = &items[best];
+      proposed.push_back(last);
+      }
+  rv.toolChangesBefore = toolChanges(listed);
+  rv.toolChangesAfter  = toolChanges(proposed);
+  rv.rapidBefore       = rapidLength(listed);
+  rv.rapidAfter        = rapidLength(proposed);
+  rv.savedTime         = (rv.toolChangesBefore - rv.toolChangesAfter) * tcTime
+                       + (rv.rapidBefore - rv.rapidAfter) / rapidFeed * 60;
+  if (rv.savedTime <= 0) {                 // no gain - keep users order
+     rv.toolChangesAfter = rv.toolChangesBefore;
+     rv.rapidAfter       = rv.rapidBefore;
+     rv.savedTime        = 0;
+
+     return rv;
+     }
+  rv.order.clear();
+  for (const Item* i : proposed) rv.order.push_back(i->op);
+
+  return rv;
+  }
+
+
+int OperationScheduler::toolChanges(const std::vector<const Item*>& order) const {
+  int rv = 0;
+
+  for (size_t i=1; i < order.size(); ++i)
+      if (order[i - 1]->op->toolNum() != order[i]->op->toolNum()) ++rv;
+
+  return rv;
+  }
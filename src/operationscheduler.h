@@ -0,0 +1,79 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       operationscheduler.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef OPERATIONSCHEDULER_H
+#define OPERATIONSCHEDULER_H
+#include "toolpathmetrics.h"
+#include <Bnd_Box.hxx>
+#include <gp_Pnt.hxx>
+#include <QVector>
+#include <vector>
+class Operation;
+
+
+// proposes an order of operations with less tool changes and shorter
+// rapids between operations. Order of the operation list is kept,
+// where it matters:
+//   - operations of different setups (fixture or rotation)
+//   - rest machining after all operations of its setup
+//   - roughing before finishing, drilling before tapping
+//   - operations, that work on overlapping areas
+// Tools for the next operation get prestaged by the post processor,
+// so the proposed order changes prepare tool commands too.
+class OperationScheduler
+{
+public:
+  struct Result {
+    QVector<Operation*> order;
+    int                 toolChangesBefore = 0;
+    int                 toolChangesAfter  = 0;
+    double              rapidBefore       = 0;   // mm between operations
+    double              rapidAfter        = 0;
+    double              savedTime         = 0;   // seconds
+    };
+  explicit OperationScheduler(double toolChangeTime = DefaultToolChangeTime, double rapidFeed = ToolpathMetrics::DefaultRapidFeed);
+
+  Result schedule(const QVector<Operation*>& operations) const;
+
+  static const double DefaultToolChangeTime;   // seconds
+
+protected:
+  struct Item {
+    Operation* op;
+    Bnd_Box    area;          // XY footprint of cutting moves
+    gp_Pnt     start;
+    gp_Pnt     end;
+    };
+  Item   itemOf(Operation* op) const;
+  bool   mustPrecede(const Item& first, const Item& second) const;
+  double rapidLength(const std::vector<const Item*>& order) const;
+  int    toolChanges(const std::vector<const Item*>& order) const;
+
+private:
+  double tcTime;
+  double rapidFeed;
+  };
+#endif // OPERATIONSCHEDULER_H
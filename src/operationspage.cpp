@@ -30,12 +30,14 @@
 #include "mainwindow.h"
 #include "core.h"
 #include "drilltargetdefinition.h"
+#include "gcodeverifier.h"
 #include "gcodewriter.h"
 #include "geomnodemodel.h"
 #include "HelixCurveAdaptor.h"
 #include "occtviewer.h"
 #include "operation.h"
 #include "operationlistmodel.h"
+#include "operationscheduler.h"
 #include "operationsubpage.h"
 #include "pathbuilder.h"
 #include "pathbuilderutil.h"
@@ -87,6 +89,7 @@
 #include <QThread>
 #include <QVector3D>
 #include <QDebug>
+#include <algorithm>
 
 
 OperationsPage::OperationsPage(QWidget *parent)
@@ -206,6 +209,10 @@ void OperationsPage::calcRotation4(const gp_Dir &n, double& aA, double& aB, doub
 
 void OperationsPage::clear() {
   olm->clear();
+  if (backplot.size()) {
+     Core().view3D()->removeShapes(backplot);
+     backplot.clear();
+     }
   }
 
 
@@ -322,12 +329,14 @@ void OperationsPage::genGCode() {
 
   qDebug() << "save gcode to:" << fileName;
 
+  scheduleOperations();
   GCodeWriter gcw(pp);
   Bnd_Box     wpBounds = Core().workData()->workPiece->BoundingBox();
   bool        genTC    = Core().isSepWithToolChange();
 
   if (Core().isAllInOneOperation()) {
      gcw.processAllInOne(fileName,  wpBounds, olm->operations());
+     verifyGCode(fileName);
      emit fileGenerated(fileName);
      }
   else
@@ -377,6 +386,7 @@ void OperationsPage::loadOperation(Operation* op) { // don't touch old operation
     case NotchOperation:   subPage = pages["Notch"];     break;
     case SweepOperation:   subPage = pages["Sweep"];     break;
     case ClampingPlugOP:   subPage = pages["ClampPlug"]; break;
+    case Face3DOperation:  subPage = pages["3D-surf"];   break;
     }
   opStack->setCurrentWidget(subPage);
 
@@ -452,6 +462,33 @@ void OperationsPage::saveOperations() {
   }
 
 
+// show the proposed order of operations with its savings and
+// let the user decide, whether to take it.
+void OperationsPage::scheduleOperations() {
+  OperationScheduler::Result sr = OperationScheduler().schedule(olm->operations());
+
+  if (sr.order == olm->operations()) return;
+  QString msg = tr("<p>Reordering the operations saves about %1 seconds:</p><ol>").arg(sr.savedTime, 0, 'f', 0);
+
+  for (Operation* op : sr.order)
+      msg += QString("<li>%1 (T%2)</li>").arg(op->name()).arg(op->toolNum());
+  msg += tr("</ol><p>tool changes: %1 instead of %2<br>rapids between operations: %3 mm instead of %4 mm</p>"
+            "<p>Use proposed order?</p>")
+            .arg(sr.toolChangesAfter)
+            .arg(sr.toolChangesBefore)
+            .arg(sr.rapidAfter, 0, 'f', 0)
+            .arg(sr.rapidBefore, 0, 'f', 0);
+  QMessageBox::StandardButton reply = QMessageBox::question(this
+                                                          , tr("Reorder Operations?")
+                                                          , msg
+                                                          , QMessageBox::Yes | QMessageBox::No);
+
+  if (reply != QMessageBox::Yes) return;
+  olm->setData(sr.order);
+  saveOperations();
+  }
+
+
 void OperationsPage::sel2Horizontal() {
 //  if (!Core().view3D()->selection().size()) return;
 //  TopoDS_Shape            selectedShape = Core().view3D()->selection().at(0);
@@ -607,3 +644,61 @@ void OperationsPage::toolPath() {
      subPage->toolPath();
      }
   }
+
+
+// read back the written program, show it as backplot and tell about
+// moves of the worksteps, that did not make it into the gcode
+void OperationsPage::verifyGCode(const QString& fileName) {
+  bool          plot = !Core().uiMainWin()->actionHideToolpath->isChecked();
+  FixtureLayout fixtures;
+  GCodeVerifier verifier;
+
+  fixtures.load(Core().projectFile());
+  verifier.setFixtures(fixtures);
+  GCodeVerifier::Result vr = verifier.verify(fileName, olm->operations(), plot);
+
+  if (!vr.valid) {
+     qCWarning(lcPath) << "failed to read back" << fileName << ":" << vr.error;
+     return;
+     }
+  qCInfo(lcPath) << "read back" << fileName << "-" << vr.lines << "lines," << vr.moves << "moves,"
+                 << vr.matched << "of" << vr.checked << "worksteps found in" << vr.ms << "ms";
+  if (backplot.size()) {
+     Core().view3D()->removeShapes(backplot);
+     backplot.clear();
+     }
+  if (plot) {
+     Handle(AIS_Shape) rapids = new AIS_Shape(vr.rapids);
+     Handle(AIS_Shape) cuts   = new AIS_Shape(vr.cuts);
+
+     rapids->SetColor(Quantity_NOC_CYAN);
+     rapids->SetWidth(1);
+     cuts->SetColor(Quantity_NOC_ORANGE);
+     cuts->SetWidth(2);
+     backplot.push_back(rapids);
+     backplot.push_back(cuts);
+     Core().view3D()->showShapes(backplot, false);
+     Core().view3D()->refresh();
+     }
+  if (!vr.missing) return;
+  QString msg = tr("<p>%1 of %2 moves of the operations were not found in the gcode:</p><ul>")
+                  .arg(vr.missing)
+                  .arg(vr.checked);
+
+  for (int i=0; i < std::min(10, static_cast<int>(vr.mismatches.size())); ++i) {
+      const GCodeVerifier::Mismatch& m = vr.mismatches[i];
+
+      msg += tr("<li>%1 step %2: expected %3/%4/%5 - line %6 has %7/%8/%9</li>")
+               .arg(olm->operations().at(m.op)->name())
+               .arg(m.step)
+               .arg(m.expected.X(), 0, 'f', 3)
+               .arg(m.expected.Y(), 0, 'f', 3)
+               .arg(m.expected.Z(), 0, 'f', 3)
+               .arg(m.line)
+               .arg(m.found.X(), 0, 'f', 3)
+               .arg(m.found.Y(), 0, 'f', 3)
+               .arg(m.found.Z(), 0, 'f', 3);
+      }
+  msg += "</ul>";
+  QMessageBox::warning(this, tr("GCode Verification"), msg);
+  }
@@ -63,10 +63,12 @@ public:
   void loadOperation(Operation* op);
   void loadProject(ProjectFile* pf);
   void saveOperations();
+  void scheduleOperations();
   void opSelected(const QItemSelection& selected, const QItemSelection& deselected);
   void rotate();
   void rotateIfFace(const std::vector<TopoDS_Shape>& selection);
   void shapeSelected(const TopoDS_Shape& shape);
+  void verifyGCode(const QString& fileName);
 
 public slots:
   void addOperation(Operation* op);
@@ -97,5 +99,6 @@ private:
   OperationSubPage*                subPage;
   std::vector<TargetDefinition*>   dummy;
   TargetDefListModel*              tdModel;
+  std::vector<Handle(AIS_Shape)>   backplot;
   };
 #endif // OPERATIONSPAGE_H
@@ -30,9 +30,13 @@
 #include "ui_opSub.h"
 #include "core.h"
 #include "cuttingparameters.h"
+#include "fixturelayout.h"
 #include "kuteCAM.h"
 #include "occtviewer.h"
+#include "operationlistmodel.h"
 #include "pathbuilder.h"
+#include "pathpipeline.h"
+#include "stockmodel.h"
 #include "targetdeflistmodel.h"
 #include "toolentry.h"
 #include "toollistmodel.h"
@@ -79,18 +83,7 @@ OperationSubPage::OperationSubPage(OperationListModel* olm, TargetDefListModel*
         << tr("Flood cooling");
   coolingModes = new QStringListModel(items, this);
 
-  items.clear();
-  items << "G53"
-        << "G54"
-        << "G55"
-        << "G56"
-        << "G57"
-        << "G58"
-        << "G59"
-        << "G59.1"
-        << "G59.2"
-        << "G59.3";
-  fixModel = new QStringListModel(items, this);
+  fixModel = new QStringListModel(FixtureLayout::fixtureNames(), this);
   if (wantUI) {
      ui->cbTool->setModel(Core().toolListModel());
      ui->cbCooling->setModel(coolingModes);
@@ -111,6 +104,7 @@ void OperationSubPage::connectSignals() {
   if (!wantUI) return;
   connect(ui->cAbsolute, &QCheckBox::toggled, this, &OperationSubPage::absToggled);
   connect(ui->cInside,   &QCheckBox::toggled, this, &OperationSubPage::outToggled);
+  connect(ui->cRest,     &QCheckBox::toggled, this, &OperationSubPage::restToggled);
   connect(ui->cbTool,    QOverload<int>::of(&QComboBox::currentIndexChanged), this, &OperationSubPage::toolChanged);
   connect(ui->cbCooling, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &OperationSubPage::coolingChanged);
   connect(ui->cbCycle,   QOverload<int>::of(&QComboBox::currentIndexChanged), this, &OperationSubPage::cycleChanged);
@@ -143,45 +137,37 @@ std::vector<Handle(AIS_Shape)> OperationSubPage::createCutPlanes(Operation* op)
      qDebug() << "can't increment depth without cut-depth value!";
      return cutPlanes;
      }
-  Bnd_Box bb = op->cutPart->BoundingBox();
-  double startZ = bb.CornerMax().Z();
-  double lastZ  = op->finalDepth() + op->offset();
-  double curZ   = startZ;
-  gp_Dir dir(0, 0, 1);
-  gp_Pnt pos(bb.CornerMin().X(), bb.CornerMin().Y(), curZ);
-  gp_Pln plane;
+  Bnd_Box             bb     = op->cutPart->BoundingBox();
+  double              startZ = bb.CornerMax().Z();
+  double              lastZ  = op->finalDepth() + op->offset();
+  double              curZ   = startZ;
+  std::vector<double> levels;
 
   qDebug() << "VM - final depth:" << op->finalDepth() << "\tlast cut depth:" << lastZ;
 
   curZ -= op->cutDepth();
   while (curZ > lastZ) {
-        qDebug() << "cut depth is" << curZ;
-        pos.SetZ(curZ);
-        plane = gp_Pln(pos, dir);
-        BRepBuilderAPI_MakeFace mf(plane, -500, 500, -500, 500);
-        Handle(AIS_Shape) wc    = new AIS_Shape(Core().helper3D()->intersect(op->cutPart->Shape(), mf.Shape()));
-        Bnd_Box           bbC   = wc->BoundingBox();
-
-        qDebug() << "cut-plane is from"
-                 << bbC.CornerMin().X() << "/" << bbC.CornerMin().Y() << "/" << bbC.CornerMin().Z()
-                 << "\tto\t"
-                 << bbC.CornerMax().X() << "/" << bbC.CornerMax().Y() << "/" << bbC.CornerMax().Z();
-        wc->SetColor(Quantity_NOC_LIGHTGOLDENRODYELLOW);
-        cutPlanes.push_back(wc);
-        op->cShapes.push_back(wc);
+        levels.push_back(curZ);
         curZ -= op->cutDepth();
         }
   if (!kute::isEqual(curZ, lastZ)) {
      qDebug() << "last cut depth is" << lastZ;
-     pos.SetZ(lastZ);
-     plane = gp_Pln(pos, dir);
-     BRepBuilderAPI_MakeFace mf(plane, -500, 500, -500, 500);
-     Handle(AIS_Shape) wc = new AIS_Shape(Core().helper3D()->intersect(op->cutPart->Shape(), mf.Shape()));
-
-     wc->SetColor(Quantity_NOC_LIGHTGOLDENRODYELLOW);
-     cutPlanes.push_back(wc);
-     op->cShapes.push_back(wc);
+     levels.push_back(lastZ);
      }
+  std::vector<TopoDS_Shape> sections = Core().helper3D()->sections(op->cutPart->Shape(), levels);
+
+  for (auto& sec : sections) {
+      Handle(AIS_Shape) wc  = new AIS_Shape(sec);
+      Bnd_Box           bbC = wc->BoundingBox();
+
+      qDebug() << "cut-plane is from"
+               << bbC.CornerMin().X() << "/" << bbC.CornerMin().Y() << "/" << bbC.CornerMin().Z()
+               << "\tto\t"
+               << bbC.CornerMax().X() << "/" << bbC.CornerMax().Y() << "/" << bbC.CornerMax().Z();
+      wc->SetColor(Quantity_NOC_LIGHTGOLDENRODYELLOW);
+      cutPlanes.push_back(wc);
+      op->cShapes.push_back(wc);
+      }
   return cutPlanes;
   }
 
@@ -356,6 +342,7 @@ void OperationSubPage::loadOP(Operation *op) {
   cutFeedChanged(op->feedPerTooth());
   ui->spOff->setValue(op->offset());
   ui->cAbsolute->setChecked(op->isAbsolute());
+  ui->cRest->setChecked(op->isRestMachining());
   ui->spDepth->setValue(op->finalDepth());
   ui->spR1->setValue(op->safeZ0());
   ui->spR2->setValue(op->safeZ1());
@@ -381,6 +368,30 @@ void OperationSubPage::opNameChanged(const QString& name) {
   }
 
 
+// run configured passes of the operation type. Toolpath is shown
+// by the generators already, so redraw only if a pass changed it.
+void OperationSubPage::optimizeToolPath() {
+  std::vector<Workstep*>& path    = curOP->workSteps();
+  int                     movesIn = path.size();
+  int                     changed = 0;
+  double                  ms      = 0;
+
+  if (path.empty()) return;
+  for (auto& s : Core().pathPipeline()->run(curOP->kind(), path)) {
+      changed += s.changed;
+      ms      += s.ms;
+      }
+  qCInfo(lcPath) << curOP->name() << ": toolpath passes reduced" << movesIn << "to"
+                 << path.size() << "moves in" << ms << "ms";
+  if (!changed) return;
+  if (curOP->toolPaths.size()) {
+     Core().view3D()->removeShapes(curOP->toolPaths);
+     curOP->toolPaths.clear();
+     }
+  showToolPath(curOP);
+  }
+
+
 void OperationSubPage::outToggled(const QVariant& v) {
   curOP->setOutside(v.toBool());
   }
@@ -405,6 +416,11 @@ void OperationSubPage::r2Changed(double v) {
   }
 
 
+void OperationSubPage::restToggled(const QVariant& v) {
+  curOP->setRestMachining(v.toBool());
+  }
+
+
 void OperationSubPage::showToolPath(Operation* op) {
   if (!op->workSteps().size()) return;
   if (Core().uiMainWin()->actionHideToolpath->isChecked()) return;
@@ -469,10 +485,13 @@ void OperationSubPage::toolChanged(const QVariant &i) {
 
 
 void OperationSubPage::toolPath() {
+  curOP->restStock.reset();
+  if (curOP->isRestMachining()) curOP->restStock.reset(olm->restStock(curOP));
   switch (curOP->cutType()) {
      case 1:  genFinishingToolPath(); break;
      default: genRoughingToolPath(); break;
      }
+  optimizeToolPath();
   }
 
 // switch between roughing and finishing
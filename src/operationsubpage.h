@@ -74,6 +74,7 @@ public slots:
   void outToggled(const QVariant& v);
   void r1Changed(double v);
   void r2Changed(double v);
+  void restToggled(const QVariant& v);
   void toolChanged(const QVariant& i);
   void typeChanged(const QVariant& v);
 
@@ -81,6 +82,7 @@ protected:
   virtual void connectSignals();
   Operation*   createOP(int id, const QString& name, OperationType type);
   QStringList  genCycleList();
+  void         optimizeToolPath();
   virtual void processTargets();
 
 signals:
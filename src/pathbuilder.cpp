@@ -25,9 +25,14 @@
  * **************************************************************************
  */
 #include "pathbuilder.h"
+#include "adaptivepathbuilder.h"
+#include "aircuttrimmer.h"
+#include "booleanengine.h"
+#include "linkplanner.h"
 #include "pathbuilderutil.h"
 #include "pocketpathbuilder.h"
 #include "profitmillingbuilder.h"
+#include "stockmodel.h"
 #include "core.h"
 #include "gocircle.h"
 #include "gocontour.h"
@@ -37,10 +42,13 @@
 #include "occtviewer.h"
 #include "operation.h"
 #include "contourtargetdefinition.h"
+#include "surfacepathbuilder.h"
 #include "sweeppathbuilder.h"
 #include "sweeptargetdefinition.h"
+#include "waterlinepathbuilder.h"
 #include "toolentry.h"
 #include "toollistmodel.h"
+#include "toolpathmetrics.h"
 #include "util3d.h"
 #include "work.h"
 #include "workstep.h"
@@ -48,9 +56,9 @@
 #include "wsstraightmove.h"
 #include "wsarc.h"
 #include "wscycle.h"
+#include "tracer.h"
 #include <AIS_Shape.hxx>
 #include <Bnd_Box.hxx>
-#include <BRepAlgoAPI_Common.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
 #include <BRepOffsetAPI_MakeOffset.hxx>
@@ -59,6 +67,7 @@
 #include <TopoDS.hxx>
 #include <TopoDS_Shape.hxx>
 #include <QDebug>
+#include <algorithm>
 
 
 static bool cmpContour(GOContour* l, GOContour* r) {
@@ -77,7 +86,7 @@ PathBuilder::PathBuilder(PathBuilderUtil* pbu)
 double PathBuilder::calcAdditionalOffset(SweepTargetDefinition* std, GOContour* c) {
   double rv = 0;
 
-  qDebug() << "requested additional offset for border processing!";
+  qCDebug(lcPath) << "requested additional offset for border processing!";
   if (!std || !c) return rv;
   switch (kute::getDominantAxis(std->baseDir())) {
     case  1:
@@ -105,6 +114,7 @@ double PathBuilder::calcAdditionalOffset(SweepTargetDefinition* std, GOContour*
 
 
 void PathBuilder::createHorizontalToolpaths(Operation* op, const std::vector<Handle(AIS_Shape)>& cutPlanes) {
+  TraceSpan span("PathBuilder::createHorizontalToolpaths");
   pbu->sweepPathBuilder()->createHorizontalToolpaths(op, cutPlanes);
   }
 
@@ -112,27 +122,27 @@ void PathBuilder::createHorizontalToolpaths(Operation* op, const std::vector<Han
 void dump(std::vector<std::vector<std::vector<GOContour*>>> cPool) {
   int n = 0;
 
-  qDebug() << "<< ================ dump clipped parts =======================";
+  qCDebug(lcPath) << "<< ================ dump clipped parts =======================";
   for (auto& cutPaths : cPool) {
       int i=0;
 
-      qDebug() << ">> dump layer #" << ++n;
+      qCDebug(lcPath) << ">> dump layer #" << ++n;
 
       for (auto& p : cutPaths) {
           int j=0;
 
-          qDebug() << ">> dump path #" << ++i;
+          qCDebug(lcPath) << ">> dump path #" << ++i;
 
           for (auto& c : p) {
-              qDebug() << ">> contour #" << ++j << c->sType()
+              qCDebug(lcPath) << ">> contour #" << ++j << c->sType()
                        << "   from " << c->startPoint().X() << " / " << c->startPoint().Y()
                        << "   to   " << c->endPoint().X() << " / " << c->endPoint().Y();
-              qDebug() << "   real - a0:" << c->a0() << " <> a1:" << c->a1();
-              qDebug() << c->toString();
+              qCDebug(lcPath) << "   real - a0:" << c->a0() << " <> a1:" << c->a1();
+              qCDebug(lcPath) << c->toString();
               }
           }
       }
-  qDebug() << "<< ================ dump clipped parts =======================";
+  qCDebug(lcPath) << "<< ================ dump clipped parts =======================";
   }
 
 
@@ -180,7 +190,7 @@ std::vector<Workstep*> PathBuilder::genFlatPaths(Operation* op, std::vector<Hand
      pool.push_back(contours);
      }
 
-  qDebug() << "collected " << pool.size() << " contours";
+  qCDebug(lcPath) << "collected " << pool.size() << " contours";
   gp_Pnt s = gp_Pnt(0, 0, 300), e = s;
   int    lmi=0, lmx = pool.size();
 
@@ -228,6 +238,7 @@ std::vector<Workstep*> PathBuilder::genFlatPaths(Operation* op, std::vector<Hand
 
 
 std::vector<Workstep*> PathBuilder::genRoundToolpaths(Operation* op, const std::vector<Handle(AIS_Shape)>& cutPlanes) {
+  TraceSpan span("PathBuilder::genRoundToolpaths");
   std::vector<Workstep*> workSteps;
   int                      mx = cutPlanes.size();
   gp_Pnt                   from, tmp, to, startXXPos;
@@ -298,14 +309,16 @@ std::vector<Workstep*> PathBuilder::genRoundToolpaths(Operation* op, const std::
      workSteps.push_back(new WSArc(from, to, c, !ccw));
      from = to;
      }
-  qDebug() << "rMin:" << rMin << "rMax:" << rMax << "topZ:" << topZ << "lastZ:" << op->lowerZ();
+  qCDebug(lcPath) << "rMin:" << rMin << "rMax:" << rMax << "topZ:" << topZ << "lastZ:" << op->lowerZ();
 
   for (int i=0; i < mx; ++i, curR = insideOut ? rMin : rMax) {
       Handle(AIS_Shape) s      = cutPlanes.at(i);
       Bnd_Box           bb     = s->BoundingBox(); bb.SetGap(0);
+
+      if (bb.IsVoid()) continue;        // level above or below of cut part
       double            nextZ  = bb.CornerMin().Z() + (topZ - bb.CornerMin().Z()) / 2;
 
-      qDebug() << "round cut plane: "
+      qCDebug(lcPath) << "round cut plane: "
                << bb.CornerMin().X() << "/" << bb.CornerMin().Y() << "/" << bb.CornerMin().Z()
                << "\tto\t"
                << bb.CornerMax().X() << "/" << bb.CornerMax().Y() << "/" << bb.CornerMax().Z();
@@ -398,7 +411,14 @@ std::vector<Workstep*> PathBuilder::genRoundToolpaths(Operation* op, const std::
   }
 
 
+std::vector<Workstep*> PathBuilder::genSurfacePath(Operation* op, const TopoDS_Shape& faces, const TopoDS_Shape& model) {
+  TraceSpan span("PathBuilder::genSurfacePath");
+  return pbu->surfacePathBuilder()->genFinishingPath(op, faces, model);
+  }
+
+
 std::vector<Workstep*> PathBuilder::genToolPath(Operation* op, Handle(AIS_Shape) cutPart, bool wantPockets) {
+  TraceSpan span("PathBuilder::genToolPath");
   TargetDefinition*        td  = op->targets.at(0);
   SweepTargetDefinition*   std = dynamic_cast<SweepTargetDefinition*>(td);
 //  ContourTargetDefinition* ctd = dynamic_cast<ContourTargetDefinition*>(td);
@@ -428,23 +448,28 @@ std::vector<Workstep*> PathBuilder::genToolPath(Operation* op, Handle(AIS_Shape)
 
   if (std && curveIsBorder) firstOffset += abs(calcAdditionalOffset(std, contour));
   contour->simplify(curZ);
-  qDebug() << "cutting contour:" << contour->toString();
-  qDebug() << "center of workpiece:" << center.X() << " / " << center.Y();
+  qCDebug(lcPath) << "cutting contour:" << contour->toString();
+  qCDebug(lcPath) << "center of workpiece:" << center.X() << " / " << center.Y();
 
   // prepare raw toolpaths
+  std::vector<double> levels;
+  std::vector<double> partZ;
+
   lastZ -=  2 * kute::MinDelta;
   while (curZ > lastZ) {
-        qDebug() << "cut depth is" << curZ;
+        qCDebug(lcPath) << "cut depth is" << curZ;
         std::vector<std::vector<GOContour*>> levelContours = processCurve(op, contour, curveIsBorder, center, /* xtend, */ firstOffset, curZ);
 
-        if (levelContours.size()) clippedParts.push_back(levelContours);
-        gp_Pln pln({0, 0, curZ}, {0, 0, 1});
-        BRepBuilderAPI_MakeFace mf(pln, -500, 500, -500, 500);
-
-        cutPlanes.push_back(new AIS_Shape(Core().helper3D()->intersect(op->cutPart->Shape(), mf.Shape())));
-
+        if (levelContours.size()) {
+           clippedParts.push_back(levelContours);
+           partZ.push_back(curZ);
+           }
+        levels.push_back(curZ);
         curZ -= op->cutDepth();
         }
+  // all sections at once - cutpart gets triangulated only once
+  for (auto& sec : Core().helper3D()->sections(op->cutPart->Shape(), levels))
+      cutPlanes.push_back(new AIS_Shape(sec));
   //TODO: show clippedParts without additional paths!
 //  dump(clippedParts);
 //  std::vector<Workstep*>   tP0 = genBasicPath(clippedParts.at(0));
@@ -457,34 +482,46 @@ std::vector<Workstep*> PathBuilder::genToolPath(Operation* op, Handle(AIS_Shape)
 
 //  return toolPath;
 
-  qDebug() << "have" << clippedParts.size() << "cut stages\n";
+  qCDebug(lcPath) << "have" << clippedParts.size() << "cut stages\n";
 
   if (!clippedParts.size()) return toolPath;
 
-  qDebug() << "center: " << center.X() << " / " << center.Y(); // << "   extend: " << xtend;
-  qDebug() << "workpiece: " << op->wpBounds.CornerMin().X() << " / " << op->wpBounds.CornerMin().Y()
+  qCDebug(lcPath) << "center: " << center.X() << " / " << center.Y(); // << "   extend: " << xtend;
+  qCDebug(lcPath) << "workpiece: " << op->wpBounds.CornerMin().X() << " / " << op->wpBounds.CornerMin().Y()
            << "   to   "    << op->wpBounds.CornerMax().X() << " / " << op->wpBounds.CornerMax().Y();
-  dump(clippedParts);
+  if (lcPath().isDebugEnabled()) dump(clippedParts);
   curZ = startZ;
 
   if (wantPockets) {
      std::vector<std::vector<GOPocket*>> pool = splitCurves(op, clippedParts);
      gp_Dir workDir = std ? std->baseDir() : gp_Dir(0, 0, 1);
 
+     if (op->restStock) skipMachinedPockets(op, pool, partZ);
 //     toolPath = genPath4Pockets(op, op->wpBounds, workDir, pool, curZ, xtend);
-     toolPath = pbu->pocketPathBuilder()->genPath(op, op->wpBounds, workDir, pool, curZ, xtend);
+     if (Core().isAdaptiveClearing())
+        toolPath = pbu->adaptivePathBuilder()->genPath(op, op->wpBounds, contour, firstOffset, pool, partZ);
+     else
+        toolPath = pbu->pocketPathBuilder()->genPath(op, op->wpBounds, workDir, pool, curZ, xtend);
      }
   else {
      toolPath = genFlatPaths(op, cutPlanes, clippedParts, curZ, xtend);
      }
+  if (Core().isTrimAirCuts())   trimAirCuts(op, toolPath);
+  if (Core().isKeepDownLinks()) planLinks(op, toolPath);
 //  cleanup(toolPath);
 
   return toolPath;
   }
 
 
+std::vector<Workstep*> PathBuilder::genWaterlinePath(Operation* op, const TopoDS_Shape& part, double zTop, double zBottom, const TopoDS_Shape& area) {
+  TraceSpan span("PathBuilder::genWaterlinePath");
+  return pbu->waterlinePathBuilder()->genFinishingPath(op, part, zTop, zBottom, area);
+  }
+
+
 void PathBuilder::drawDebugContour(Operation* op, GOContour* c, double z) {
-//  qDebug() << "process debug contour" << c->toString();
+//  qCDebug(lcPath) << "process debug contour" << c->toString();
   std::vector<GraphicObject*> segments = c->segments();
   int mx = segments.size() - 1;
 
@@ -503,10 +540,31 @@ void PathBuilder::drawDebugContour(Operation* op, GOContour* c, double z) {
   }
 
 
+// links between cuts get checked against the stock left at that
+// point, so the cutter stays down or lifts only as high as needed.
+void PathBuilder::planLinks(Operation* op, std::vector<Workstep*>& toolPath) {
+  TraceSpan span("PathBuilder::planLinks");
+
+  if (toolPath.empty() || (op->workPiece.IsNull() && !op->restStock)) return;
+  ToolEntry*  tool = op->toolEntry();
+  double      cell = std::max(0.1, tool->fluteDiameter() / 8);
+  LinkPlanner planner(op->restStock ? *op->restStock : StockModel(op->workPiece->Shape(), cell)
+                    , tool
+                    , op->safeZ0());
+
+  if (!planner.isValid()) return;
+  LinkPlanner::Result r = planner.plan(toolPath);
+
+  qCInfo(lcPath) << op->name() << ": replaced" << r.links << "links (" << r.keptDown
+                 << "kept down), saved" << r.savedLength << "mm of rapids";
+  }
+
+
 // all contiguous segments form a contour (instance of GOContour).
 // A cutted offset curve may lead to several subcontours (vector of GOContour)
 // processCurve processes all contour(-segments) of same z-level
 std::vector<std::vector<GOContour*>> PathBuilder::processCurve(Operation* op, GOContour* curve, bool curveIsBorder, const gp_Pnt& center, /* double xtend, */ double firstOffset, double curZ) {
+  TraceSpan span("PathBuilder::processCurve");
   BRepOffsetAPI_MakeOffset              offMaker(TopoDS::Wire(curve->toWire(curZ)));
   TopoDS_Shape                          rawPath;
   Bnd_Box                               bbCut = op->cutPart->BoundingBox();
@@ -517,7 +575,7 @@ std::vector<std::vector<GOContour*>> PathBuilder::processCurve(Operation* op, GO
       std::vector<GOContour*> pathParts;
       double offset = firstOffset + i * op->cutWidth();
 
-      qDebug() << "create offset contour with offset:" << offset;
+      qCDebug(lcPath) << "create offset contour with offset:" << offset;
 
       offMaker.Perform(offset, 0);
       if (offMaker.IsDone()) {
@@ -554,7 +612,7 @@ std::vector<std::vector<GOContour*>> PathBuilder::processCurve(Operation* op, GO
             pathParts.push_back(path);
             }
          else {
-            rawPath = BRepAlgoAPI_Common(offWire, op->cutPart->Shape());
+            rawPath = Core().booleanEngine()->common(offWire, op->cutPart->Shape());
             std::vector<TopoDS_Edge> segments = Core().helper3D()->allEdgesWithin(rawPath);
 
             if (!segments.size()) break;
@@ -598,23 +656,49 @@ std::vector<std::vector<GOContour*>> PathBuilder::processCurve(Operation* op, GO
 
 
 std::vector<Workstep*> PathBuilder::genNotchPath(Operation *op, opencascade::handle<AIS_Shape> cutPart, std::vector<Handle(AIS_Shape)> cutPlanes) {
+  TraceSpan span("PathBuilder::genNotchPath");
   return pbu->profitMillingBuilder()->genToolPath(op, cutPart, cutPlanes);
   }
 
 
+// rest machining: drop pockets, where no contour touches stock left
+// by previous operations. Levels stay in place, as pocket builders
+// derive Z of each level from its index.
+void PathBuilder::skipMachinedPockets(const Operation* op, std::vector<std::vector<GOPocket*>>& pool, const std::vector<double>& levels) {
+  TraceSpan span("PathBuilder::skipMachinedPockets");
+  double    radius  = op->toolEntry()->fluteDiameter() / 2;
+  int       skipped = 0;
+
+  for (int i=0; i < (int)pool.size() && i < (int)levels.size(); ++i) {
+      auto& lp = pool[i];
+      auto  it = std::stable_partition(lp.begin(), lp.end(), [&](GOPocket* p) {
+                                         for (GOContour* c : p->contours())
+                                             if (op->restStock->hasMaterial(c, levels[i], radius)) return true;
+                                         return false;
+                                         });
+
+      skipped += lp.end() - it;
+      for (auto p = it; p != lp.end(); ++p) delete *p;
+      lp.erase(it, lp.end());
+      }
+  qCDebug(lcPath) << "rest machining skipped" << skipped << "pockets without stock";
+  }
+
+
 std::vector<std::vector<GOPocket*>> PathBuilder::splitCurves(const Operation* op, const std::vector<std::vector<std::vector<GOContour*>>>& pool) {
+  TraceSpan span("PathBuilder::splitCurves");
   std::vector<std::vector<GOPocket*>> levels;
   auto& c = pool.at(0);
   int nL = 0; //, nC = 0, nCC = 0;
 
-  qDebug() << "pool has" << pool.size() << "Z-levels";
+  qCDebug(lcPath) << "pool has" << pool.size() << "Z-levels";
   for (auto lp : pool) {
       std::vector<GOPocket*> pockets;
       double size  = 0;
       int count    = 0;
       int maxCount = 0;
 
-      qDebug() << "\n" << ++nL << "level has parts of" << lp.size() << "offset contours";
+      qCDebug(lcPath) << "\n" << ++nL << "level has parts of" << lp.size() << "offset contours";
 
       for (int i=0; i < lp.size(); ++i) {
           auto& cp = lp.at(i);
@@ -629,7 +713,7 @@ std::vector<std::vector<GOPocket*>> PathBuilder::splitCurves(const Operation* op
                  }
               }
           }
-      qDebug() << "biggest contour parts at level #" << count << "   found with size" << size;
+      qCDebug(lcPath) << "biggest contour parts at level #" << count << "   found with size" << size;
       auto cp = lp.at(count);
 
       // first create all pockets necessary
@@ -637,9 +721,9 @@ std::vector<std::vector<GOPocket*>> PathBuilder::splitCurves(const Operation* op
           double a0 = c->a0();
           double a1 = c->a1();
 
-          qDebug() << "create pocket for contour from" << c->startPoint().X() << " / " << c->startPoint().Y()
+          qCDebug(lcPath) << "create pocket for contour from" << c->startPoint().X() << " / " << c->startPoint().Y()
                    << "   to   "   << c->endPoint().X() << " / " << c->endPoint().Y();
-          qDebug() << "   check: a0 == " << a0 << "   a1 == " << a1;
+          qCDebug(lcPath) << "   check: a0 == " << a0 << "   a1 == " << a1;
 
           if (!op->direction()) {
              if (a0 < a1) pockets.push_back(new GOPocket(c->endPoint(), c->startPoint(), c->centerPoint()));
@@ -670,10 +754,10 @@ std::vector<std::vector<GOPocket*>> PathBuilder::splitCurves(const Operation* op
                      match = true;
                      break;
                      }
-                  else qDebug() << "no match for pocket (" << ap0 << " <> " << ap1 << ")";
+                  else qCDebug(lcPath) << "no match for pocket (" << ap0 << " <> " << ap1 << ")";
                   }
               if (!match) {
-                 qDebug() << "OUPS - lost contour (" << ac0 << " <> " << ac1 << ")";
+                 qCWarning(lcPath) << "OUPS - lost contour (" << ac0 << " <> " << ac1 << ")";
                  }
               }
           }
@@ -723,3 +807,26 @@ void PathBuilder::stripPath(GOContour *firstContour, GOContour *masterContour) {
          }
       }
   }
+
+
+// levels start from the full offset ring of the cut part. Feed moves
+// outside of the real stock (or the stock left by previous operations
+// on rest machining) get replaced by rapids.
+void PathBuilder::trimAirCuts(Operation* op, std::vector<Workstep*>& toolPath) {
+  TraceSpan span("PathBuilder::trimAirCuts");
+
+  if (toolPath.empty() || (op->workPiece.IsNull() && !op->restStock)) return;
+  ToolEntry*    tool = op->toolEntry();
+  double        cell = std::max(0.1, tool->fluteDiameter() / 8);
+  AirCutTrimmer trimmer(op->restStock ? *op->restStock : StockModel(op->workPiece->Shape(), cell)
+                      , tool
+                      , ToolpathMetrics::feedOf(op)
+                      , op->safeZ0()
+                      , ToolpathMetrics::DefaultRapidFeed);
+
+  if (!trimmer.isValid()) return;
+  AirCutTrimmer::Result r = trimmer.trim(toolPath);
+
+  qCInfo(lcPath) << op->name() << ": replaced" << r.moves << "feed moves in" << r.runs
+                 << "runs by rapids, air cut" << r.airLength << "mm, saved" << r.savedTime << "s";
+  }
@@ -50,14 +50,19 @@ public:
   std::vector<Workstep*>               genFlatPaths(Operation* op, std::vector<Handle(AIS_Shape)> cutPlanes, std::vector<std::vector<std::vector<GOContour*>>> clippedParts, double curZ, double xtend, int level = -1);
   std::vector<Workstep*>               genNotchPath(Operation* op, Handle(AIS_Shape) cutPart, std::vector<Handle(AIS_Shape)> cutPlanes);
   std::vector<Workstep*>               genToolPath(Operation* op, Handle(AIS_Shape) cutPart, bool wantPockets);
+  std::vector<Workstep*>               genWaterlinePath(Operation* op, const TopoDS_Shape& part, double zTop, double zBottom, const TopoDS_Shape& area = TopoDS_Shape());
   std::vector<Workstep*>               genPath4Pockets(Operation* op, const Bnd_Box& bb, const gp_Dir& baseNorm, const std::vector<std::vector<GOPocket*>>& pool, double curZ, double xtend);
   std::vector<Workstep*>               genRoundToolpaths(Operation* op, const std::vector<Handle(AIS_Shape)>& cutPlanes);
+  std::vector<Workstep*>               genSurfacePath(Operation* op, const TopoDS_Shape& faces, const TopoDS_Shape& model = TopoDS_Shape());
   gp_Pnt                               genXTraverse(std::vector<Workstep*>& ws, int dir, const gp_Pnt& startPos, const gp_Pnt& endPos, const Bnd_Box& bb /*, double xtend */);
   gp_Pnt                               genYTraverse(std::vector<Workstep*>& ws, int dir, const gp_Pnt& startPos, const gp_Pnt& endPos, const Bnd_Box& bb /*, double xtend */);
+  void                                 planLinks(Operation* op, std::vector<Workstep*>& toolPath);
   std::vector<std::vector<GOContour*>> processCurve(Operation* op, GOContour* curve, bool curveIsBorder, const gp_Pnt& center, /* double extend, */ double firstOffset, double curZ);
   void                                 simplify(std::vector<GOContour*>& pool);
+  void                                 skipMachinedPockets(const Operation* op, std::vector<std::vector<GOPocket*>>& pool, const std::vector<double>& levels);
   std::vector<std::vector<GOPocket*>>  splitCurves(const Operation* op, const std::vector<std::vector<std::vector<GOContour*>>>& pool);
   void                                 stripPath(GOContour* firstContour, GOContour* masterContour);
+  void                                 trimAirCuts(Operation* op, std::vector<Workstep*>& toolPath);
 
 protected:
   void drawDebugContour(Operation* op, GOContour* c, double z);
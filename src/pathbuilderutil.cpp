@@ -24,17 +24,22 @@
  * **************************************************************************
  */
 #include "pathbuilderutil.h"
+#include "adaptivepathbuilder.h"
 #include "gocontour.h"
 #include "graphicobject.h"
 #include "gocircle.h"
 #include "goline.h"
+#include "pathpass.h"
 #include "pocketpathbuilder.h"
 #include "profitmillingbuilder.h"
+#include "surfacepathbuilder.h"
 #include "sweeppathbuilder.h"
+#include "waterlinepathbuilder.h"
 #include "wsarc.h"
 #include "wsstraightmove.h"
 #include "wstraverse.h"
 #include "kuteCAM.h"
+#include "tracer.h"
 #include <Bnd_Box.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRep_Tool.hxx>
@@ -43,25 +48,32 @@
 
 
 PathBuilderUtil::PathBuilderUtil()
- : ppb(nullptr)
+ : apb(nullptr)
+ , ppb(nullptr)
  , pmb(nullptr)
- , spb(nullptr) {
+ , sfb(nullptr)
+ , spb(nullptr)
+ , wlb(nullptr) {
   }
 
 
-void PathBuilderUtil::cleanup(std::vector<Workstep*>& tp) {
-  for (int i=0; i < tp.size(); ++i) {
-      Workstep* ws = tp.at(i);
+AdaptivePathBuilder* PathBuilderUtil::adaptivePathBuilder() {
+  if (!apb) apb = new AdaptivePathBuilder(this);
+  return apb;
+  }
 
-      if (kute::isEqual(ws->startPos(), ws->endPos())) {
-         tp.erase(tp.begin() + i--);
-         }
-      }
+
+// single pass instead of erasing in place. The configured passes of
+// an operation type run later on the complete toolpath.
+void PathBuilderUtil::cleanup(std::vector<Workstep*>& tp) {
+  TraceSpan span("PathBuilderUtil::cleanup");
+  ZeroLengthPass().run(tp);
   }
 
 
 //TODO: block region
 gp_Pnt PathBuilderUtil::genInterMove(std::vector<Workstep*>& ws, const gp_Pnt& from, const gp_Pnt& to, const gp_Pnt& center, const Bnd_Box& bb, double xtend) {
+  TraceSpan span("PathBuilderUtil::genInterMove");
   int reg0 = region(from, bb);
   int reg1 = region(to, bb);
   gp_Pnt   e=to, s=from, tmp=from;
@@ -277,6 +289,7 @@ gp_Pnt PathBuilderUtil::genInterMove(std::vector<Workstep*>& ws, const gp_Pnt& f
 
 
 gp_Pnt PathBuilderUtil::genRoundInterMove(std::vector<Workstep*>& ws, const gp_Pnt& from, const gp_Pnt& to, const Bnd_Box& bb, double xtend) {
+  TraceSpan span("PathBuilderUtil::genRoundInterMove");
   gp_Pnt c(bb.CornerMin().X() + (bb.CornerMax().X() - bb.CornerMin().X()) / 2
          , bb.CornerMin().Y() + (bb.CornerMax().Y() - bb.CornerMin().Y()) / 2
          , bb.CornerMin().Z() + (bb.CornerMax().Z() - bb.CornerMin().Z()) / 2);
@@ -286,7 +299,7 @@ gp_Pnt PathBuilderUtil::genRoundInterMove(std::vector<Workstep*>& ws, const gp_P
   double   safeR = r + xtend;
   gp_Pnt   e=to, s=from, tmp=from;
 
-  qDebug() << "need inter move from (" << reg0 << ")" << s.X() << " / " << s.Y() << " / " << s.Z()
+  qCDebug(lcPath) << "need inter move from (" << reg0 << ")" << s.X() << " / " << s.Y() << " / " << s.Z()
                         << "   to   (" << reg1 << ")" << e.X() << " / " << e.Y() << " / " << e.Z();
 
   c.SetZ(to.Z());
@@ -442,7 +455,8 @@ ProfitMillingBuilder* PathBuilderUtil::profitMillingBuilder() {
 
 
 gp_Pnt PathBuilderUtil::processContour(std::vector<Workstep*>& tp, GOContour* c) {
-  qDebug() << "process contour" << c->toString();
+  TraceSpan span("PathBuilderUtil::processContour");
+  qCDebug(lcPath) << "process contour" << c->toString();
   Workstep* ws = nullptr;
 
   for (auto& go : c->segments()) {
@@ -491,11 +505,23 @@ int PathBuilderUtil::region(const gp_Pnt& p, const Bnd_Box& bb) const {
   }
 
 
+SurfacePathBuilder* PathBuilderUtil::surfacePathBuilder() {
+  if (!sfb) sfb = new SurfacePathBuilder(this);
+  return sfb;
+  }
+
+
 SweepPathBuilder* PathBuilderUtil::sweepPathBuilder() {
   if (!spb) spb = new SweepPathBuilder(this);
   return spb;
   }
 
+
+WaterlinePathBuilder* PathBuilderUtil::waterlinePathBuilder() {
+  if (!wlb) wlb = new WaterlinePathBuilder(this);
+  return wlb;
+  }
+
 const int PathBuilderUtil::Inside = 0;
 const int PathBuilderUtil::Left   = 1;
 const int PathBuilderUtil::Right  = 2;
@@ -30,9 +30,12 @@
 class Bnd_Box;
 class Workstep;
 class GOContour;
+class AdaptivePathBuilder;
 class PocketPathBuilder;
 class ProfitMillingBuilder;
+class SurfacePathBuilder;
 class SweepPathBuilder;
+class WaterlinePathBuilder;
 
 
 class PathBuilderUtil
@@ -44,9 +47,12 @@ public:
   gp_Pnt genRoundInterMove(std::vector<Workstep*>& ws, const gp_Pnt& from, const gp_Pnt& to, const Bnd_Box& bb, double xtend);
   gp_Pnt genInterMove(std::vector<Workstep*>& toolPath, const gp_Pnt& e, const gp_Pnt& s, const gp_Pnt& center, const Bnd_Box& workBounds, double extend);
   gp_Pnt processContour(std::vector<Workstep*>& toolPath, GOContour* c);
+  AdaptivePathBuilder* adaptivePathBuilder();
   PocketPathBuilder* pocketPathBuilder();
   ProfitMillingBuilder* profitMillingBuilder();
+  SurfacePathBuilder* surfacePathBuilder();
   SweepPathBuilder*  sweepPathBuilder();
+  WaterlinePathBuilder* waterlinePathBuilder();
 
 protected:
   int quadrant(const gp_Pnt& p, const gp_Pnt& center = {0,0,0}) const;
@@ -59,9 +65,12 @@ protected:
   static const int Top;
 
 private:
+  AdaptivePathBuilder*  apb;
   PocketPathBuilder*    ppb;
   ProfitMillingBuilder* pmb;
+  SurfacePathBuilder*   sfb;
   SweepPathBuilder*     spb;
+  WaterlinePathBuilder* wlb;
   };
 
 #endif // PATHBUILDERUTIL_H
@@ -0,0 +1,201 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       pathpass.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "pathpass.h"
+#include "workstep.h"
+#include "wsstraightmove.h"
+#include "wstraverse.h"
+#include "kuteCAM.h"
+#include <gp_Ax1.hxx>
+#include <gp_Dir.hxx>
+#include <gp_Vec.hxx>
+#include <cmath>
+
+
+CollinearMergePass::CollinearMergePass(double tolerance)
+ : tolerance(tolerance) {
+  }
+
+
+namespace {
+// directions seen from run start, that pass all joints within
+// tolerance. A joint allows a cone around its direction, and the
+// intersection of two cones gets replaced by the largest cone inside
+// of it, so the window never allows more than the joints do.
+struct Window {
+  gp_Dir axis;
+  double angle = M_PI;
+
+  bool allows(const gp_Vec& v) const {
+    return v.Magnitude() > 0 && axis.Angle(gp_Dir(v)) <= angle;
+    }
+
+  bool narrow(const gp_Dir& dir, double a) {
+    if (angle >= M_PI) {
+       axis  = dir;
+       angle = a;
+       return true;
+       }
+    double t = axis.Angle(dir);
+
+    if (t > angle + a) return false;
+    if (t + a <= angle) {
+       axis  = dir;
+       angle = a;
+       return true;
+       }
+    if (t + angle <= a) return true;
+    double from = t - a;                 // lens on great circle from axis to dir
+    double to   = angle;
+
+    if (t > 1e-12) axis.Rotate(gp_Ax1(gp_Pnt(), axis.Crossed(dir)), (from + to) / 2);
+    angle = (to - from) / 2;
+
+    return true;
+    }
+  };
+}
+
+
+// greedy merge: the run grows as long as the direction from run start
+// to the new end stays within the window of all joints of the run
+// and the new move does not turn back. Each joint narrows the window
+// once, so the pass stays linear.
+int CollinearMergePass::run(std::vector<Workstep*>& path) {
+  std::vector<Workstep*> out;
+  int                    merged = 0;
+  size_t                 i      = 0;
+
+  out.reserve(path.size());
+  while (i < path.size()) {
+        Workstep* first = path[i];
+        size_t    j     = i + 1;
+
+        if (first->type() == WTStraightMove || first->type() == WTTraverse) {
+           gp_Pnt s = first->startPos();
+           gp_Pnt e = first->endPos();
+           Window w;
+
+           for (; j < path.size(); ++j) {
+               Workstep* next = path[j];
+
+               if (next->type() != first->type()
+                || next->color() != first->color()
+                || !kute::isEqual(next->startPos(), e)) break;
+               gp_Vec run(s, e);
+               gp_Vec step(e, next->endPos());
+               gp_Vec line(s, next->endPos());
+               Window nw = w;
+               double d  = run.Magnitude();
+
+               if (line.Magnitude() < tolerance || run.Dot(step) <= 0) break;
+               if (d > tolerance && !nw.narrow(gp_Dir(run), std::asin(tolerance / d))) break;
+               if (!nw.allows(line)) break;
+               w = nw;
+               e = next->endPos();
+               }
+           if (j > i + 1) {
+              Workstep* ws = first->type() == WTTraverse ? static_cast<Workstep*>(new WSTraverse(s, e))
+                                                         : static_cast<Workstep*>(new WSStraightMove(s, e));
+
+              ws->setColor(first->color());
+              for (size_t k=i; k < j; ++k) delete path[k];
+              merged += j - i;
+              out.push_back(ws);
+              i = j;
+              continue;
+              }
+           }
+        out.push_back(first);
+        i = j;
+        }
+  path.swap(out);
+
+  return merged;
+  }
+
+
+int TraverseCollapsePass::run(std::vector<Workstep*>& path) {
+  std::vector<Workstep*> out;
+  int                    collapsed = 0;
+
+  out.reserve(path.size());
+  for (Workstep* ws : path) {
+      Workstep* last = out.empty() ? nullptr : out.back();
+
+      if (!last
+       || ws->type()   != WTTraverse
+       || last->type() != WTTraverse
+       || !kute::isEqual(last->endPos(), ws->startPos())) {
+         out.push_back(ws);
+         continue;
+         }
+      gp_Pnt s = last->startPos();
+      gp_Pnt e = ws->endPos();
+
+      if (kute::isEqual(s, e)) {                            // out and back
+         out.pop_back();
+         delete last;
+         delete ws;
+         collapsed += 2;
+         }
+      else if (kute::isEqual(s.X(), e.X()) && kute::isEqual(s.Y(), e.Y())
+            && kute::isEqual(s.X(), ws->startPos().X())
+            && kute::isEqual(s.Y(), ws->startPos().Y())) { // up and down
+         Workstep* t = new WSTraverse(s, e);
+
+         t->setColor(last->color());
+         out.back() = t;
+         delete last;
+         delete ws;
+         collapsed += 2;
+         }
+      else {
+         out.push_back(ws);
+         }
+      }
+  path.swap(out);
+
+  return collapsed;
+  }
+
+
+int ZeroLengthPass::run(std::vector<Workstep*>& path) {
+  std::vector<Workstep*> out;
+  int                    dropped = 0;
+
+  out.reserve(path.size());
+  for (Workstep* ws : path) {
+      if (ws->type() != WTCycle && kute::isEqual(ws->startPos(), ws->endPos())) {
+         delete ws;
+         ++dropped;
+         }
+      else out.push_back(ws);
+      }
+  path.swap(out);
+
+  return dropped;
+  }
@@ -0,0 +1,81 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       pathpass.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef PATHPASS_H
+#define PATHPASS_H
+#include <QString>
+#include <vector>
+class Workstep;
+
+
+// a single optimization stage over the move stream of an operation.
+// Passes read the path once and write the result into a new vector,
+// so each pass is linear in the number of moves. Dropped moves get
+// deleted by the pass. Run returns the number of moves affected.
+class PathPass
+{
+public:
+  virtual ~PathPass() = default;
+
+  virtual QString name() const = 0;
+  virtual int     run(std::vector<Workstep*>& path) = 0;
+  };
+
+
+// drops moves, where start equals end. Cycles are kept, as their
+// start and end may match for good reason.
+class ZeroLengthPass : public PathPass
+{
+public:
+  virtual QString name() const override { return "zeroLength"; }
+  virtual int     run(std::vector<Workstep*>& path) override;
+  };
+
+
+// merges runs of straight moves (or traverses), where every joint of
+// the run lies within tolerance of the merged move.
+class CollinearMergePass : public PathPass
+{
+public:
+  explicit CollinearMergePass(double tolerance);
+
+  virtual QString name() const override { return "collinearMerge"; }
+  virtual int     run(std::vector<Workstep*>& path) override;
+
+private:
+  double tolerance;
+  };
+
+
+// removes traverses that go out and back to the same point and joins
+// consecutive vertical traverses at the same XY position.
+class TraverseCollapsePass : public PathPass
+{
+public:
+  virtual QString name() const override { return "traverseCollapse"; }
+  virtual int     run(std::vector<Workstep*>& path) override;
+  };
+#endif // PATHPASS_H
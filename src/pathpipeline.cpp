@@ -0,0 +1,142 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       pathpipeline.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "pathpipeline.h"
+#include "operation.h"
+#include "pathpass.h"
+#include "workstep.h"
+#include "kuteCAM.h"
+#include "tracer.h"
+#include <QElapsedTimer>
+#include <QSettings>
+#include <QDebug>
+#include <algorithm>
+#include <memory>
+
+
+PathPipeline::PathPipeline()
+ : tol(0.001) {
+  }
+
+
+QStringList PathPipeline::availablePasses() {
+  return { "zeroLength", "collinearMerge", "traverseCollapse" };
+  }
+
+
+PathPass* PathPipeline::createPass(const QString& name) const {
+  if (name == "zeroLength")       return new ZeroLengthPass();
+  if (name == "collinearMerge")   return new CollinearMergePass(tol);
+  if (name == "traverseCollapse") return new TraverseCollapsePass();
+
+  return nullptr;
+  }
+
+
+QStringList PathPipeline::defaultPasses(int opKind) {
+  if (opKind == DrillOperation) return { "zeroLength" };
+
+  return availablePasses();
+  }
+
+
+QString PathPipeline::kindName(int opKind) {
+  switch (opKind) {
+    case ContourOperation: return "contour";
+    case DrillOperation:   return "drill";
+    case SweepOperation:   return "sweep";
+    case ClampingPlugOP:   return "clampingPlug";
+    case NotchOperation:   return "notch";
+    case Face3DOperation:  return "face3D";
+    default:               break;
+    }
+  return "unknown";
+  }
+
+
+void PathPipeline::loadProfile(QSettings& settings) {
+  settings.beginGroup("PathPasses");
+  setTolerance(settings.value("tolerance", tol).toDouble());
+  for (int kind=ContourOperation; kind <= Face3DOperation; ++kind) {
+      QString key = kindName(kind);
+
+      if (settings.contains(key)) setPasses(kind, settings.value(key).toStringList());
+      }
+  settings.endGroup();
+  }
+
+
+QStringList PathPipeline::passes(int opKind) const {
+  return passLists.value(opKind, defaultPasses(opKind));
+  }
+
+
+// the path stays consistent after every pass, so an empty
+// or unknown pass name just gets skipped.
+std::vector<PathPipeline::Stats> PathPipeline::run(int opKind, std::vector<Workstep*>& path) const {
+  TraceSpan span("PathPipeline::run");
+  std::vector<Stats> rv;
+
+  for (const QString& name : passes(opKind)) {
+      std::unique_ptr<PathPass> pass(createPass(name.trimmed()));
+      QElapsedTimer             timer;
+      Stats                     s;
+
+      if (!pass) {
+         qCWarning(lcPath) << "unknown toolpath pass" << name;
+         continue;
+         }
+      timer.start();
+      s.pass     = pass->name();
+      s.movesIn  = path.size();
+      s.changed  = pass->run(path);
+      s.movesOut = path.size();
+      s.ms       = timer.nsecsElapsed() / 1e6;
+      qCDebug(lcPath) << kindName(opKind) << s.pass << ":" << s.movesIn << "->" << s.movesOut
+                      << "moves," << s.changed << "changed," << s.ms << "ms";
+      rv.push_back(s);
+      }
+  return rv;
+  }
+
+
+void PathPipeline::setPasses(int opKind, const QStringList& passes) {
+  passLists[opKind] = passes;
+  }
+
+
+void PathPipeline::setTolerance(double tolerance) {
+  tol = std::max(tolerance, kute::MinDelta);
+  }
+
+
+void PathPipeline::storeProfile(QSettings& settings) const {
+  settings.beginGroup("PathPasses");
+  settings.setValue("tolerance", tol);
+  for (int kind=ContourOperation; kind <= Face3DOperation; ++kind)
+      settings.setValue(kindName(kind), passes(kind));
+  settings.endGroup();
+  }
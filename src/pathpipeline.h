@@ -0,0 +1,72 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       pathpipeline.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef PATHPIPELINE_H
+#define PATHPIPELINE_H
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <vector>
+class PathPass;
+class QSettings;
+class Workstep;
+
+
+// runs the configured list of optimization passes over the toolpath
+// of an operation. Each operation type has its own pass list, so i.e.
+// drill cycles don't get touched by merging passes.
+class PathPipeline
+{
+public:
+  struct Stats {
+    QString pass;
+    int     movesIn  = 0;
+    int     movesOut = 0;
+    int     changed  = 0;
+    double  ms       = 0;
+    };
+  PathPipeline();
+
+  void               loadProfile(QSettings& settings);
+  QStringList        passes(int opKind) const;
+  std::vector<Stats> run(int opKind, std::vector<Workstep*>& path) const;
+  void               setPasses(int opKind, const QStringList& passes);
+  void               setTolerance(double tolerance);
+  void               storeProfile(QSettings& settings) const;
+  double             tolerance() const   { return tol; }
+
+  static QStringList availablePasses();
+  static QStringList defaultPasses(int opKind);
+  static QString     kindName(int opKind);
+
+protected:
+  PathPass*          createPass(const QString& name) const;
+
+private:
+  QMap<int, QStringList> passLists;
+  double                 tol;
+  };
+#endif // PATHPIPELINE_H
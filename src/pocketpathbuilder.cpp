@@ -27,10 +27,12 @@
 #include "core.h"
 #include "gocontour.h"
 #include "gopocket.h"
+#include "kuteCAM.h"
 #include "operation.h"
 #include "pathbuilderutil.h"
 #include "work.h"
 #include "wstraverse.h"
+#include "tracer.h"
 #include <Bnd_Box.hxx>
 #include <gp_Dir.hxx>
 #include <gp_Pnt.hxx>
@@ -43,6 +45,7 @@ PocketPathBuilder::PocketPathBuilder(PathBuilderUtil* pbu)
 
 
 std::vector<Workstep*> PocketPathBuilder::genPath(Operation* op, const Bnd_Box& bb, const gp_Dir& baseNorm, const std::vector<std::vector<GOPocket*>>& pool, double curZ, double xtend) {
+  TraceSpan span("PocketPathBuilder::genPath");
   double radius = 0;
   gp_Pnt center(bb.CornerMin().X() + (bb.CornerMax().X() - bb.CornerMin().X()) / 2
               , bb.CornerMin().Y() + (bb.CornerMax().Y() - bb.CornerMin().Y()) / 2
@@ -60,7 +63,7 @@ std::vector<Workstep*> PocketPathBuilder::genPath(Operation* op, const Bnd_Box&
           GOPocket* p = levelParts.at(i);
           int mx = p->contours().size();
 
-          p->dump();
+          if (lcPath().isDebugEnabled()) p->dump();
           for (int j=0; j < mx; ++j) {
               GOContour* c   = p->contours().at(j);
 
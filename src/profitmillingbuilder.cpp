@@ -35,6 +35,7 @@
 #include "wsarc.h"
 #include "wsstraightmove.h"
 #include "wstraverse.h"
+#include "tracer.h"
 #include <BRep_Tool.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <ElCLib.hxx>
@@ -88,17 +89,17 @@ TopoDS_Edge ProfitMillingBuilder::determineCenterLine(const NotchTargetDefinitio
      p1 = pM0 = c0->Value(prm0 + (prm1 - prm0) / 2);
      p2 = c0->Value(prm1);
 
-     qDebug() << "first normal(0):" << p0.X() << " / " << p0.Y() << " / " << p0.Z();
-     qDebug() << "first normal(1):" << p1.X() << " / " << p1.Y() << " / " << p1.Z();
-     qDebug() << "first normal(2):" << p2.X() << " / " << p2.Y() << " / " << p2.Z();
+     qCDebug(lcPath) << "first normal(0):" << p0.X() << " / " << p0.Y() << " / " << p0.Z();
+     qCDebug(lcPath) << "first normal(1):" << p1.X() << " / " << p1.Y() << " / " << p1.Z();
+     qCDebug(lcPath) << "first normal(2):" << p2.X() << " / " << p2.Y() << " / " << p2.Z();
 
      p0 = c1->Value(prm2);
      p1 = pM1 = c1->Value(prm2 + (prm3 - prm2) / 2);
      p2 = c1->Value(prm3);
 
-     qDebug() << "second normal(0):" << p0.X() << " / " << p0.Y() << " / " << p0.Z();
-     qDebug() << "second normal(1):" << p1.X() << " / " << p1.Y() << " / " << p1.Z();
-     qDebug() << "second normal(2):" << p2.X() << " / " << p2.Y() << " / " << p2.Z();
+     qCDebug(lcPath) << "second normal(0):" << p0.X() << " / " << p0.Y() << " / " << p0.Z();
+     qCDebug(lcPath) << "second normal(1):" << p1.X() << " / " << p1.Y() << " / " << p1.Z();
+     qCDebug(lcPath) << "second normal(2):" << p2.X() << " / " << p2.Y() << " / " << p2.Z();
      }
   else {
      gp_Lin b0  = gl0->Lin();
@@ -123,17 +124,17 @@ TopoDS_Edge ProfitMillingBuilder::determineCenterLine(const NotchTargetDefinitio
      p1 = pM0 = c0->Value(prm0 + (prm1 - prm0) / 2);
      p2 = c0->Value(prm1);
 
-     qDebug() << "first normal(0):" << p0.X() << " / " << p0.Y() << " / " << p0.Z();
-     qDebug() << "first normal(1):" << p1.X() << " / " << p1.Y() << " / " << p1.Z();
-     qDebug() << "first normal(2):" << p2.X() << " / " << p2.Y() << " / " << p2.Z();
+     qCDebug(lcPath) << "first normal(0):" << p0.X() << " / " << p0.Y() << " / " << p0.Z();
+     qCDebug(lcPath) << "first normal(1):" << p1.X() << " / " << p1.Y() << " / " << p1.Z();
+     qCDebug(lcPath) << "first normal(2):" << p2.X() << " / " << p2.Y() << " / " << p2.Z();
 
      p0 = c1->Value(prm2);
      p1 = pM1 = c1->Value(prm2 + (prm3 - prm2) / 2);
      p2 = c1->Value(prm3);
 
-     qDebug() << "second normal(0):" << p0.X() << " / " << p0.Y() << " / " << p0.Z();
-     qDebug() << "second normal(1):" << p1.X() << " / " << p1.Y() << " / " << p1.Z();
-     qDebug() << "second normal(2):" << p2.X() << " / " << p2.Y() << " / " << p2.Z();
+     qCDebug(lcPath) << "second normal(0):" << p0.X() << " / " << p0.Y() << " / " << p0.Z();
+     qCDebug(lcPath) << "second normal(1):" << p1.X() << " / " << p1.Y() << " / " << p1.Z();
+     qCDebug(lcPath) << "second normal(2):" << p2.X() << " / " << p2.Y() << " / " << p2.Z();
      }
   GC_MakeLine bCL(pM0, pM1);
   TopoDS_Edge eCL = BRepBuilderAPI_MakeEdge(bCL.Value()->Lin(), -500, 500);
@@ -149,9 +150,9 @@ TopoDS_Edge ProfitMillingBuilder::determineCenterLine(const NotchTargetDefinitio
         std::vector<gp_Pnt> cutPoints = Core().helper3D()->allVertexCoordinatesWithin(sCL);
 
         for (auto p : cutPoints) {
-            qDebug() << "cutpoint:" << p.X() << " / " << p.Y() << " / " << p.Z();
+            qCDebug(lcPath) << "cutpoint:" << p.X() << " / " << p.Y() << " / " << p.Z();
             }
-        qDebug() << "cutPoints done (" << cutPoints.size() << ")";
+        qCDebug(lcPath) << "cutPoints done (" << cutPoints.size() << ")";
         if (cutPoints.size() > 1)
            rv = BRepBuilderAPI_MakeEdge(cutPoints.at(0), cutPoints.at(1));
         }
@@ -160,7 +161,7 @@ TopoDS_Edge ProfitMillingBuilder::determineCenterLine(const NotchTargetDefinitio
      rv = TopoDS::Edge(sCL);
      }
   else {
-     qDebug() << "SupOPNotch: unsupported CUT result!!! bye!";
+     qCDebug(lcPath) << "SupOPNotch: unsupported CUT result!!! bye!";
      return rv;
      }
   return rv;
@@ -168,6 +169,7 @@ TopoDS_Edge ProfitMillingBuilder::determineCenterLine(const NotchTargetDefinitio
 
 
 std::vector<Workstep*> ProfitMillingBuilder::genToolPath(Operation* op, Handle(AIS_Shape) cutPart, std::vector<Handle(AIS_Shape)> cutPlanes) {
+  TraceSpan span("ProfitMillingBuilder::genToolPath");
   NotchTargetDefinition* ntd = dynamic_cast<NotchTargetDefinition*>(op->targets.at(0));
   GC_MakeLine ml0(ntd->borderPoint(0), ntd->borderPoint(1));
   GC_MakeLine ml1(ntd->borderPoint(2), ntd->borderPoint(3));
@@ -191,7 +193,7 @@ std::vector<Workstep*> ProfitMillingBuilder::genToolPath(Operation* op, Handle(A
   double leadInOutRadius = (int)(radius * 0.3 + 0.9);
 
   if (radius < 0) {
-     qDebug() << "OUPS!!! - tool diameter to big for this notch!!!";
+     qCWarning(lcPath) << "OUPS!!! - tool diameter to big for this notch!!!";
      return rv;
      }
   xMax += radius;
@@ -248,7 +250,7 @@ std::vector<Workstep*> ProfitMillingBuilder::genToolPath(Operation* op, Handle(A
                 solver.Tangency2(1, cPrm0, cPrm1, tangentLI);
                 }
              else {
-                qDebug() << "OUPS - no tangent line created!";
+                qCWarning(lcPath) << "OUPS - no tangent line created!";
                 }
              // Path-Segment #3 (lead out)
              rv.push_back(new WSArc({ptLO.X(), ptLO.Y(), centerMain.Z()}
@@ -25,7 +25,9 @@
  * **************************************************************************
  */
 #include "selectionhandler.h"
+#include "booleanengine.h"
 #include "core.h"
+#include "edgechainer.h"
 #include "gocontour.h"
 #include "occtviewer.h"
 #include "operation.h"
@@ -34,6 +36,7 @@
 #include "util3d.h"
 #include "work.h"
 #include "kuteCAM.h"
+#include "tracer.h"
 
 #include <BRepAlgoAPI_Common.hxx>
 #include <BRepAlgoAPI_Fuse.hxx>
@@ -56,6 +59,36 @@ SelectionHandler::SelectionHandler() {
   }
 
 
+// edges get chained first, so segments are added to the contour in
+// order. Edges of other chains can't be part of the contour, they
+// are shown only. Gaps get reported by the chainer.
+void SelectionHandler::addChained(Operation* op, GOContour* contour, const std::vector<TopoDS_Edge>& edges) {
+  EdgeChainer            chainer(kute::MinDelta);
+  std::vector<EdgeChain> chains = chainer.chain(edges);
+
+  if (chains.size() > 1)
+     qCWarning(lcContour) << "selection falls apart into" << chains.size() << "chains - contour uses the first one";
+  for (int i=0; i < (int)chains.size(); ++i) {
+      for (auto& e : chains[i].edges) {
+          Handle(AIS_Shape) as = new AIS_Shape(e);
+
+          as->SetColor(Quantity_NOC_ORANGE);
+          as->SetWidth(3);
+          op->cShapes.push_back(as);
+          if (i) continue;
+          GraphicObject* go = GOContour::occ2GO(e);
+
+          if (!go) continue;
+          if (kute::isEqual(go->startPoint(), go->endPoint())) {
+             delete go;
+             continue;
+             }
+          contour->add(go);
+          }
+      }
+  }
+
+
 GOContour* SelectionHandler::createContourFromSelection(Operation* op, Bnd_Box* pBB) {
   std::vector<TopoDS_Shape> selection = Core().view3D()->selection();
 
@@ -92,38 +125,14 @@ GOContour* SelectionHandler::createContourFromSelection(Operation* op, Bnd_Box*
 
      qDebug() << "cut line contains " << ce.size() << "segments";
 
-     for (auto& s : ce) {
-         GraphicObject*    go = GOContour::occ2GO(s);
-
-         if (kute::isEqual(go->startPoint(), go->endPoint())) {
-            delete go;
-            continue;
-            }
-         contour->add(go);
-         Handle(AIS_Shape) as = new AIS_Shape(s);
-
-         as->SetColor(Quantity_NOC_ORANGE);
-         as->SetWidth(3);
-         op->cShapes.push_back(as);
-         }
+     addChained(op, contour, ce);
 //     qDebug() << "check it out?!?";
      }
   else if (selection.at(0).ShapeType() == TopAbs_EDGE) {
-     qDebug() << "TODO: create a wire ...";
-     for (auto& s : selection) {
-         GraphicObject*    go = GOContour::occ2GO(TopoDS::Edge(s));
-
-         if (kute::isEqual(go->startPoint(), go->endPoint())) {
-            delete go;
-            continue;
-            }
-         contour->add(go);
-         Handle(AIS_Shape) as = new AIS_Shape(s);
-
-         as->SetColor(Quantity_NOC_ORANGE);
-         as->SetWidth(3);
-         op->cShapes.push_back(as);
-         }
+     std::vector<TopoDS_Edge> edges;
+
+     for (auto& s : selection) edges.push_back(TopoDS::Edge(s));
+     addChained(op, contour, edges);
      }
   else {
      throw std::domain_error("SelectionHandler - invalid/unknown shape type!");
@@ -142,38 +151,29 @@ TopoDS_Shape SelectionHandler::createBaseContour(const gp_Pnt& pos, const gp_Dir
   gp_Pln                  selectedPlane(pos, dir);
   BRepBuilderAPI_MakeFace mfSelected(selectedPlane, -500, 500, -500, 500);
 
-  return BRepAlgoAPI_Section(curBF->Shape(), mfSelected.Shape());
+  return Core().booleanEngine()->section(curBF->Shape(), mfSelected.Shape());
   }
 
 
 Handle(AIS_Shape) SelectionHandler::createCutPart(Handle(AIS_Shape) src, TopoDS_Shape cf, Operation* op, bool wantFirst) {
+  TraceSpan span("SelectionHandler::createCutPart");
 //  Handle(AIS_Shape) curWP = Core().helper3D()->fixRotation(Core().workData()->workPiece->Shape()
 //                                                         , op->operationA()
 //                                                         , op->operationB()
 //                                                         , op->operationC());
-  Handle(AIS_Shape) curBF = Core().helper3D()->fixRotation(Core().view3D()->baseFace()->Shape()
-                                                         , op->operationA()
-                                                         , op->operationB()
-                                                         , op->operationC());
-  gp_Vec vb = Core().helper3D()->deburr(Core().helper3D()->normalOfFace(curBF->Shape()));
-
-  qDebug() << "SH::createCutPart - direction of baseFace:" << vb.X() << " / " << vb.Y() << " / " << vb.Z();
-
-  Handle(AIS_Shape)    rv;
-  BRepAlgoAPI_Splitter splitter;
-  TopTools_ListOfShape splitArgs;
-  TopTools_ListOfShape splitTools;
-
-  splitArgs.Append(src->Shape());
-  splitTools.Append(cf);
-  splitter.SetArguments(splitArgs);
-  splitter.SetTools(splitTools);
-  splitter.SetFuzzyValue(kute::MinDelta);
-  splitter.Build();
-
-  if (splitter.IsDone()) {
-     splitter.SimplifyResult();
-     TopoDS_Shape    result = splitter.Shape();
+  if (Core().view3D() && !Core().view3D()->baseFace().IsNull()) {  // no view when running headless
+     Handle(AIS_Shape) curBF = Core().helper3D()->fixRotation(Core().view3D()->baseFace()->Shape()
+                                                            , op->operationA()
+                                                            , op->operationB()
+                                                            , op->operationC());
+     gp_Vec vb = Core().helper3D()->deburr(Core().helper3D()->normalOfFace(curBF->Shape()));
+
+     qDebug() << "SH::createCutPart - direction of baseFace:" << vb.X() << " / " << vb.Y() << " / " << vb.Z();
+     }
+  Handle(AIS_Shape) rv;
+  TopoDS_Shape      result = Core().booleanEngine()->split(src->Shape(), cf, true);
+
+  if (!result.IsNull()) {
      TopoDS_Iterator it(result);
      TopoDS_Shape      s0  = it.Value(); it.Next();
      TopoDS_Shape      s1  = it.Value();
@@ -215,23 +215,9 @@ Handle(AIS_Shape) SelectionHandler::createCutPart(Operation* op, SweepTargetDefi
 
   gp_Pln                  pln(cutPos, dir);
   BRepBuilderAPI_MakeFace mf(pln, -500, 500, -500, 500);
-  BRepAlgoAPI_Splitter    splitter;
-  TopTools_ListOfShape    splitArgs;
-  TopTools_ListOfShape    splitTools;
-
-  splitArgs.Append(curWP->Shape());
-  splitter.SetArguments(splitArgs);
-
-  splitTools.Append(mf.Shape());
-  splitter.SetTools(splitTools);
-
-  splitter.SetNonDestructive(Standard_True);
-  splitter.SetFuzzyValue(kute::MinDelta);
-  splitter.Build();
+  TopoDS_Shape            result = Core().booleanEngine()->split(curWP->Shape(), mf.Shape(), true);
 
-  if (splitter.IsDone()) {
-     splitter.SimplifyResult();
-     TopoDS_Shape    result = splitter.Shape();
+  if (!result.IsNull()) {
      TopoDS_Iterator it(result);
      // first shape contains model, second shape is rest of workpiece
      TopoDS_Shape      s0  = it.Value(); it.Next();
@@ -26,8 +26,10 @@
  */
 #ifndef SELECTIONHANDLER_H
 #define SELECTIONHANDLER_H
+#include <TopoDS_Edge.hxx>
 #include <TopoDS_Wire.hxx>
 #include <AIS_Shape.hxx>
+#include <vector>
 class GOContour;
 class Operation;
 class SweepTargetDefinition;
@@ -43,5 +45,8 @@ public:
   Handle(AIS_Shape) createCutPart(Handle(AIS_Shape) src, TopoDS_Shape cf, Operation* op, bool wantFirst = true);
   Handle(AIS_Shape) createCutPart(Operation* op);
   Handle(AIS_Shape) createCutPart(Operation* op, SweepTargetDefinition* std);
+
+protected:
+  void              addChained(Operation* op, GOContour* contour, const std::vector<TopoDS_Edge>& edges);
   };
 #endif // SELECTIONHANDLER_H
@@ -30,6 +30,7 @@
 #include "ui_mainwindow.h"
 #include "mainwindow.h"
 #include "core.h"
+#include "fixturelayout.h"
 #include "util3d.h"
 #include "occtviewer.h"
 #include "viselistmodel.h"
@@ -44,10 +45,13 @@
 #include <BRepTools.hxx>
 #include <Geom_CylindricalSurface.hxx>
 #include <gp_Quaternion.hxx>
+#include <QComboBox>
 #include <QDoubleSpinBox>
 #include <QStringListModel>
+#include <QTableWidget>
 #include <QVector3D>
 #include <QDebug>
+#include <algorithm>
 
 
 SetupPage::SetupPage(StringListModel* matModel, ViseListModel* vises, QWidget *parent)
@@ -64,6 +68,28 @@ SetupPage::SetupPage(StringListModel* matModel, ViseListModel* vises, QWidget *p
   connect(this, &SetupPage::raiseMessage, Core().mainWin(), &MainWindow::setStatusMessage);
   connect(this, &SetupPage::modelChanged, Core().mainWin(), &MainWindow::refresh);
   ui->cbMaterial->setModel(matModel);
+  connect(ui->pbFixAdd,    &QPushButton::clicked, this, &SetupPage::addFixture);
+  connect(ui->pbFixRemove, &QPushButton::clicked, this, &SetupPage::removeFixture);
+  connect(ui->pbFixSet,    &QPushButton::clicked, this, &SetupPage::fixFixtures);
+  }
+
+
+// new instances default to the next work offset
+void SetupPage::addFixture() {
+  int         row   = ui->twFixtures->rowCount();
+  QComboBox*  cb    = new QComboBox();
+  QStringList names = FixtureLayout::fixtureNames();
+
+  cb->addItems(names);
+  cb->setCurrentIndex(std::min(row + 1, names.size() - 1));
+  ui->twFixtures->insertRow(row);
+  ui->twFixtures->setCellWidget(row, 0, cb);
+  for (int c=1; c < 4; ++c) {
+      QTableWidgetItem* item = new QTableWidgetItem();
+
+      item->setData(Qt::EditRole, 0.0);
+      ui->twFixtures->setItem(row, c, item);
+      }
   }
 
 
@@ -357,6 +383,24 @@ void SetupPage::fixClamping() {
   }
 
 
+void SetupPage::fixFixtures() {
+  FixtureLayout layout;
+
+  for (int r=0; r < ui->twFixtures->rowCount(); ++r) {
+      QComboBox* cb = qobject_cast<QComboBox*>(ui->twFixtures->cellWidget(r, 0));
+
+      layout.add(cb ? cb->currentIndex() : 1
+               , gp_Vec(ui->twFixtures->item(r, 1)->data(Qt::EditRole).toDouble()
+                      , ui->twFixtures->item(r, 2)->data(Qt::EditRole).toDouble()
+                      , ui->twFixtures->item(r, 3)->data(Qt::EditRole).toDouble()));
+      }
+  layout.setMode(ui->cFixCopies->isChecked() ? FixtureLayout::TransformedCopies
+                                             : FixtureLayout::WorkOffsets);
+  layout.store(Core().projectFile());
+  emit raiseMessage(tr("%1 fixture instances set").arg(layout.count()));
+  }
+
+
 void SetupPage::fixModel() {
   gp_Trsf             t      = Core().workData()->model->Transformation();
   const TopoDS_Shape& base   = Core().workData()->model->Shape();
@@ -638,6 +682,10 @@ void SetupPage::loadProject(ProjectFile* pf, const TopoDS_Shape& mShape) {
   enableModel(false);
   view3D->iso1View();
   pf->endGroup();
+  FixtureLayout fixtures;
+
+  fixtures.load(pf);
+  showFixtures(fixtures);
   }
 
 
@@ -658,6 +706,13 @@ void SetupPage::onTopToggle() {
   }
 
 
+void SetupPage::removeFixture() {
+  int row = ui->twFixtures->currentRow();
+
+  if (row >= 0) ui->twFixtures->removeRow(row);
+  }
+
+
 void SetupPage::transformModel() {
   double        dA = ui->angABase->value();
   double        dB = ui->angBBase->value();
@@ -705,6 +760,21 @@ void SetupPage::setupDone() {
   }
 
 
+void SetupPage::showFixtures(const FixtureLayout& layout) {
+  ui->twFixtures->setRowCount(0);
+  for (const FixtureInstance& fi : layout.instances()) {
+      int row = ui->twFixtures->rowCount();
+
+      addFixture();
+      qobject_cast<QComboBox*>(ui->twFixtures->cellWidget(row, 0))->setCurrentIndex(fi.fixture);
+      ui->twFixtures->item(row, 1)->setData(Qt::EditRole, fi.offset.X());
+      ui->twFixtures->item(row, 2)->setData(Qt::EditRole, fi.offset.Y());
+      ui->twFixtures->item(row, 3)->setData(Qt::EditRole, fi.offset.Z());
+      }
+  ui->cFixCopies->setChecked(layout.mode() == FixtureLayout::TransformedCopies);
+  }
+
+
 void SetupPage::updateClampingPlug() {
   Bnd_Box xt  = Core().workData()->workPiece->BoundingBox();
   double xNeg = ui->xNegClamp->value();
@@ -34,6 +34,7 @@ namespace Ui {
 class SetupPage;
 }
 QT_END_NAMESPACE
+class FixtureLayout;
 class ProjectFile;
 class QStringList;
 class Util3D;
@@ -48,6 +49,7 @@ class SetupPage : public ApplicationWindow
 public:
   explicit SetupPage(StringListModel* matModel, ViseListModel* vises, QWidget *parent = nullptr);
 
+  void addFixture();
   void changeVise(const QString& vise);
   void createClamping();
   void createWorkPiece(Handle(AIS_Shape) model);
@@ -59,15 +61,18 @@ public:
   void enableVise(bool enabled);
   void exploreModel(const TopoDS_Shape& s);
   void fixClamping();
+  void fixFixtures();
   void fixModel();
   void fixWorkpiece();
   void fixVise();
   void loadProject(ProjectFile* pf, const TopoDS_Shape& model);
   void onTopToggle();
+  void removeFixture();
   void transformModel();
   void setModel(const TopoDS_Shape& shape);
   void setProject(ProjectFile* pf);
   void setupDone();
+  void showFixtures(const FixtureLayout& layout);
   void updateClampingPlug();
   void updateWorkPiece();
   void updateVise();
@@ -0,0 +1,410 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       stockmodel.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "stockmodel.h"
+#include "gocontour.h"
+#include "helixarc.h"
+#include "kuteCAM.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include "workstep.h"
+#include "wsarc.h"
+#include <BRepAdaptor_Curve.hxx>
+#include <BRepBndLib.hxx>
+#include <GCPnts_UniformAbscissa.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+
+
+static const double NoStock   = -1e99;
+static const double Clearance = 0.01;       // material below is treated as gone
+static const double MaxCells  = 2e6;
+
+
+StockModel::StockModel(const TopoDS_Shape& stock, double cellSize)
+ : x0(0)
+ , y0(0)
+ , h(std::max(cellSize, 0.01))
+ , nx(0)
+ , ny(0) {
+  TraceSpan span("StockModel::StockModel");
+
+  if (stock.IsNull()) return;
+  BRepBndLib::Add(stock, bb);
+  if (bb.IsVoid()) return;
+  bb.SetGap(0);
+  double w = bb.CornerMax().X() - bb.CornerMin().X();
+  double d = bb.CornerMax().Y() - bb.CornerMin().Y();
+
+  while ((w / h + 1) * (d / h + 1) > MaxCells) h *= 1.5;
+  x0 = bb.CornerMin().X();
+  y0 = bb.CornerMin().Y();
+  nx = std::ceil(w / h) + 1;
+  ny = std::ceil(d / h) + 1;
+  top.resize(nx * ny, NoStock);
+
+  // highest point of stock around each cell
+  CutterShape probe;
+
+  probe.radius = h / 2;
+  DropCutter dc(stock, probe, std::max(h / 4, 0.01));
+
+  OSD_Parallel::For(0, ny, [&](int j) {
+    double z;
+
+    for (int i=0; i < nx; ++i)
+        if (dc.drop(x0 + i * h, y0 + j * h, z)) top[j * nx + i] = z;
+    });
+  }
+
+
+// replay toolpath of an operation. Rapids don't cut, drill cycles
+// cut from start to end position.
+void StockModel::apply(const std::vector<Workstep*>& path, const ToolEntry* tool) {
+  TraceSpan   span("StockModel::apply");
+  CutterShape cutter;
+  double      lift;
+
+  if (!cutterOf(tool, cutter, lift)) return;
+  for (Workstep* ws : path) apply(ws, cutter, lift);
+  }
+
+
+void StockModel::apply(const Workstep* ws, const CutterShape& cutter, double lift) {
+  std::vector<gp_Pnt> pl = polylineOf(ws, lift);
+
+  for (int i=1; i < (int)pl.size(); ++i) cut(pl[i - 1], pl[i], cutter);
+  }
+
+
+// horizontal moves lower all cells the cutter covers completely,
+// others get sampled by single cutter positions.
+void StockModel::cut(const gp_Pnt& from, const gp_Pnt& to, const CutterShape& cutter) {
+  lower(from, to, cutter, Window{0, nx - 1, 0, ny - 1});
+  }
+
+
+// cones (drills, chamfer mills) act as flat cutter of full diameter
+// lifted by the height of the cone, which removes less than the real
+// tool does.
+bool StockModel::cutterOf(const ToolEntry* tool, CutterShape& cutter, double& lift) {
+  lift = 0;
+  if (CutterShape::fromTool(tool, cutter)) return true;
+  if (!tool || tool->fluteDiameter() <= 0 || tool->cuttingAngle() <= 0) return false;
+  cutter.radius       = tool->fluteDiameter() / 2;
+  cutter.cornerRadius = 0;
+  lift                = cutter.radius / std::tan(kute::deg2rad(tool->cuttingAngle() / 2));
+
+  return true;
+  }
+
+
+// any stock above z within radius around path of contour
+bool StockModel::hasMaterial(GOContour* c, double z, double radius) const {
+  TopoDS_Shape wire = c->toWire(z);
+
+  if (wire.IsNull()) return true;
+  for (TopExp_Explorer ex(wire, TopAbs_EDGE); ex.More(); ex.Next()) {
+      BRepAdaptor_Curve      ac(TopoDS::Edge(ex.Current()));
+      GCPnts_UniformAbscissa ua(ac, h);
+
+      if (!ua.IsDone()) return true;
+      for (int i=1; i <= ua.NbPoints(); ++i) {
+          gp_Pnt p = ac.Value(ua.Parameter(i));
+
+          p.SetZ(z);
+          if (hasMaterial(p, radius)) return true;
+          }
+      }
+  return false;
+  }
+
+
+bool StockModel::hasMaterial(const gp_Pnt& p, double radius) const {
+  if (top.empty()) return true;
+  double r  = radius + h;
+  int    i0 = std::max(0,      (int)std::floor((p.X() - r - x0) / h));
+  int    i1 = std::min(nx - 1, (int)std::ceil((p.X() + r - x0) / h));
+  int    j0 = std::max(0,      (int)std::floor((p.Y() - r - y0) / h));
+  int    j1 = std::min(ny - 1, (int)std::ceil((p.Y() + r - y0) / h));
+
+  for (int j=j0; j <= j1; ++j)
+      for (int i=i0; i <= i1; ++i)
+          if (top[j * nx + i] > p.Z() + Clearance
+           && std::hypot(x0 + i * h - p.X(), y0 + j * h - p.Y()) <= r) return true;
+  return false;
+  }
+
+
+// lowers the cells of window w below the cutter moving from - to and
+// returns the removed volume. With touched set, cells the cutter only
+// partly covers get lowered by the covered fraction of their stock and
+// count with that part, so rim cells run out of stock when covered
+// again by the next move, like the real rim does. Such cells hold the
+// average height of the cell, so they may tell air, where stock is.
+double StockModel::lower(const gp_Pnt& from, const gp_Pnt& to, const CutterShape& cutter, const Window& w, bool touched) {
+  if (top.empty()) return 0;
+  double rv = 0;
+
+  if (std::abs(to.Z() - from.Z()) > kute::MinDelta) {
+     int n = std::max(1, (int)std::ceil(from.Distance(to) / (h / 2)));
+
+     for (int i=0; i <= n; ++i)
+         rv += stamp(gp_Pnt(from.XYZ() + (to.XYZ() - from.XYZ()) * i / n), cutter, w, touched);
+     return rv;
+     }
+  double r   = cutter.radius;
+  double dx  = to.X() - from.X();
+  double dy  = to.Y() - from.Y();
+  double l2  = dx * dx + dy * dy;
+  double pad = h * M_SQRT1_2;
+  int    i0  = std::max(w.i0, (int)std::floor((std::min(from.X(), to.X()) - r - x0) / h));
+  int    i1  = std::min(w.i1, (int)std::ceil((std::max(from.X(), to.X()) + r - x0) / h));
+  int    j0  = std::max(w.j0, (int)std::floor((std::min(from.Y(), to.Y()) - r - y0) / h));
+  int    j1  = std::min(w.j1, (int)std::ceil((std::max(from.Y(), to.Y()) + r - y0) / h));
+
+  for (int j=j0; j <= j1; ++j) {
+      for (int i=i0; i <= i1; ++i) {
+          double px = x0 + i * h - from.X();
+          double py = y0 + j * h - from.Y();
+          double t  = l2 > 0 ? std::max(0.0, std::min(1.0, (px * dx + py * dy) / l2)) : 0;
+          double d  = std::hypot(px - t * dx, py - t * dy);
+          double df = d + pad;                        // cell covered completely
+          double dn = std::max(0.0, d - pad);         // cell touched
+
+          if ((touched ? dn : df) > r) continue;
+          double& cell = top[j * nx + i];
+          double  z    = from.Z() + cutter.height(df <= r ? df : dn);
+          double  f    = df <= r ? 1 : (r - dn) / (df - dn);    // covered part of cell
+
+          if (cell <= z || cell <= NoStock) continue;
+          double  cut  = f * (cell - z);
+
+          rv   += cut * h * h;
+          cell -= cut;
+          }
+      }
+  return rv;
+  }
+
+
+// highest stock within radius around the straight line from - to
+double StockModel::maxTop(const gp_Pnt& from, const gp_Pnt& to, double radius) const {
+  double rv = NoStock;
+
+  if (top.empty()) return rv;
+  double r  = radius + h;
+  double dx = to.X() - from.X();
+  double dy = to.Y() - from.Y();
+  double l2 = dx * dx + dy * dy;
+  int    i0 = std::max(0,      (int)std::floor((std::min(from.X(), to.X()) - r - x0) / h));
+  int    i1 = std::min(nx - 1, (int)std::ceil((std::max(from.X(), to.X()) + r - x0) / h));
+  int    j0 = std::max(0,      (int)std::floor((std::min(from.Y(), to.Y()) - r - y0) / h));
+  int    j1 = std::min(ny - 1, (int)std::ceil((std::max(from.Y(), to.Y()) + r - y0) / h));
+
+  for (int j=j0; j <= j1; ++j) {
+      for (int i=i0; i <= i1; ++i) {
+          double px = x0 + i * h - from.X();
+          double py = y0 + j * h - from.Y();
+          double t  = l2 > 0 ? std::max(0.0, std::min(1.0, (px * dx + py * dy) / l2)) : 0;
+
+          if (std::hypot(px - t * dx, py - t * dy) <= r) rv = std::max(rv, top[j * nx + i]);
+          }
+      }
+  return rv;
+  }
+
+
+// path of cutter tip for moves that cut. Arcs get split into chords
+// deviating less than 1/8 of cell size.
+std::vector<gp_Pnt> StockModel::polylineOf(const Workstep* ws, double lift) const {
+  std::vector<gp_Pnt> rv;
+  gp_Pnt              s = ws->startPos(); s.SetZ(s.Z() + lift);
+  gp_Pnt              e = ws->endPos();   e.SetZ(e.Z() + lift);
+
+  switch (ws->type()) {
+    case WTStraightMove:
+    case WTCycle:
+         rv.push_back(s);
+         rv.push_back(e);
+         break;
+    case WTArc: {
+         const WSArc* arc = static_cast<const WSArc*>(ws);
+         gp_Pnt       c   = arc->centerPos();
+
+         c.SetZ(c.Z() + lift);
+         HelixArc(s, e, c, arc->isCCW()).tessellate(h / 8, rv);
+         } break;
+    default:
+         break;
+    }
+  return rv;
+  }
+
+
+// volume removed by each move of path, which gets applied to the
+// stock. Cells at the rim of the cutter count by their covered part,
+// so the volume does not depend on how a path is split into moves.
+// Heights of rim cells get averaged that way, so the stock is for
+// measuring only afterwards. Removal depends on the order of moves
+// only per cell, so the grid is split into tiles, that get processed
+// in parallel, each one replaying the moves touching it in path order.
+std::vector<double> StockModel::removal(const std::vector<Workstep*>& path, const CutterShape& cutter, double lift) {
+  TraceSpan                        span("StockModel::removal");
+  int                              mx = path.size();
+  std::vector<double>              rv(mx, 0);
+  std::vector<std::vector<gp_Pnt>> lines(mx);
+
+  if (top.empty() || !mx) return rv;
+  OSD_Parallel::For(0, mx, [&](int i) { lines[i] = polylineOf(path[i], lift); });
+  int    tx = (nx + TileSize - 1) / TileSize;
+  int    ty = (ny + TileSize - 1) / TileSize;
+  double r  = cutter.radius + h;
+  std::vector<std::vector<std::pair<int, int>>> bins(tx * ty);   // move, segment
+
+  for (int m=0; m < mx; ++m) {
+      const std::vector<gp_Pnt>& pl = lines[m];
+
+      for (int k=1; k < (int)pl.size(); ++k) {
+          int i0 = std::max(0,      (int)std::floor((std::min(pl[k - 1].X(), pl[k].X()) - r - x0) / h) / TileSize);
+          int i1 = std::min(tx - 1, (int)std::ceil((std::max(pl[k - 1].X(), pl[k].X()) + r - x0) / h) / TileSize);
+          int j0 = std::max(0,      (int)std::floor((std::min(pl[k - 1].Y(), pl[k].Y()) - r - y0) / h) / TileSize);
+          int j1 = std::min(ty - 1, (int)std::ceil((std::max(pl[k - 1].Y(), pl[k].Y()) + r - y0) / h) / TileSize);
+
+          for (int j=j0; j <= j1; ++j)
+              for (int i=i0; i <= i1; ++i)
+                  bins[j * tx + i].push_back({m, k});
+          }
+      }
+  std::vector<std::vector<std::pair<int, double>>> parts(tx * ty);   // move, volume
+
+  OSD_Parallel::For(0, tx * ty, [&](int t) {
+    Window w;
+
+    w.i0 = (t % tx) * TileSize;
+    w.i1 = std::min(nx - 1, w.i0 + TileSize - 1);
+    w.j0 = (t / tx) * TileSize;
+    w.j1 = std::min(ny - 1, w.j0 + TileSize - 1);
+    for (const auto& b : bins[t]) {
+        const std::vector<gp_Pnt>& pl = lines[b.first];
+        double                     v  = lower(pl[b.second - 1], pl[b.second], cutter, w, true);
+
+        if (v <= 0) continue;
+        if (parts[t].size() && parts[t].back().first == b.first) parts[t].back().second += v;
+        else                                                      parts[t].push_back({b.first, v});
+        }
+    });
+  for (const auto& p : parts)
+      for (const auto& e : p) rv[e.first] += e.second;
+
+  return rv;
+  }
+
+
+// true, if cutter touches stock anywhere between from and to. Cells
+// count with the distance to their far side and sloped moves at
+// their lower end, so a move is only reported as air, if it is sure.
+bool StockModel::removesMaterial(const gp_Pnt& from, const gp_Pnt& to, const CutterShape& cutter) const {
+  if (top.empty()) return true;
+  double r  = cutter.radius + h;
+  double z  = std::min(from.Z(), to.Z()) + Clearance;
+  double dx = to.X() - from.X();
+  double dy = to.Y() - from.Y();
+  double l2 = dx * dx + dy * dy;
+  int    i0 = std::max(0,      (int)std::floor((std::min(from.X(), to.X()) - r - x0) / h));
+  int    i1 = std::min(nx - 1, (int)std::ceil((std::max(from.X(), to.X()) + r - x0) / h));
+  int    j0 = std::max(0,      (int)std::floor((std::min(from.Y(), to.Y()) - r - y0) / h));
+  int    j1 = std::min(ny - 1, (int)std::ceil((std::max(from.Y(), to.Y()) + r - y0) / h));
+
+  for (int j=j0; j <= j1; ++j) {
+      for (int i=i0; i <= i1; ++i) {
+          double cell = top[j * nx + i];
+
+          if (cell <= z) continue;
+          double px = x0 + i * h - from.X();
+          double py = y0 + j * h - from.Y();
+          double t  = l2 > 0 ? std::max(0.0, std::min(1.0, (px * dx + py * dy) / l2)) : 0;
+          double d  = std::hypot(px - t * dx, py - t * dy);
+
+          if (d > r) continue;
+          if (cell > z + cutter.height(std::max(0.0, std::min(cutter.radius, d - h)))) return true;
+          }
+      }
+  return false;
+  }
+
+
+bool StockModel::removesMaterial(const Workstep* ws, const CutterShape& cutter, double lift) const {
+  std::vector<gp_Pnt> pl = polylineOf(ws, lift);
+
+  for (int i=1; i < (int)pl.size(); ++i)
+      if (removesMaterial(pl[i - 1], pl[i], cutter)) return true;
+  return false;
+  }
+
+
+double StockModel::stamp(const gp_Pnt& tip, const CutterShape& cutter, const Window& w, bool touched) {
+  double r   = cutter.radius;
+  double pad = h * M_SQRT1_2;
+  double rv  = 0;
+  int    i0  = std::max(w.i0, (int)std::floor((tip.X() - r - x0) / h));
+  int    i1  = std::min(w.i1, (int)std::ceil((tip.X() + r - x0) / h));
+  int    j0  = std::max(w.j0, (int)std::floor((tip.Y() - r - y0) / h));
+  int    j1  = std::min(w.j1, (int)std::ceil((tip.Y() + r - y0) / h));
+
+  for (int j=j0; j <= j1; ++j) {
+      for (int i=i0; i <= i1; ++i) {
+          double d  = std::hypot(x0 + i * h - tip.X(), y0 + j * h - tip.Y());
+          double df = d + pad;
+          double dn = std::max(0.0, d - pad);
+
+          if ((touched ? dn : df) > r) continue;
+          double& cell = top[j * nx + i];
+          double  z    = tip.Z() + cutter.height(df <= r ? df : dn);
+          double  f    = df <= r ? 1 : (r - dn) / (df - dn);    // covered part of cell
+
+          if (cell <= z || cell <= NoStock) continue;
+          double  cut  = f * (cell - z);
+
+          rv   += cut * h * h;
+          cell -= cut;
+          }
+      }
+  return rv;
+  }
+
+
+double StockModel::topAt(double x, double y) const {
+  int i = std::round((x - x0) / h);
+  int j = std::round((y - y0) / h);
+
+  if (i < 0 || j < 0 || i >= nx || j >= ny) return NoStock;
+  return top[j * nx + i];
+  }
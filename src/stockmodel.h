@@ -0,0 +1,82 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       stockmodel.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef STOCKMODEL_H
+#define STOCKMODEL_H
+#include "dropcutter.h"
+#include <Bnd_Box.hxx>
+#include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
+#include <vector>
+class GOContour;
+class ToolEntry;
+class Workstep;
+
+
+// 2.5D stock as grid of top heights (Z-map). Toolpaths get replayed
+// by lowering the cells below the cutter, which is fast enough to
+// replay whole operation lists. Where the model can't tell for sure,
+// it keeps material, so it never reports air where stock is left.
+class StockModel
+{
+public:
+  StockModel(const TopoDS_Shape& stock, double cellSize);
+
+  void                apply(const std::vector<Workstep*>& path, const ToolEntry* tool);
+  void                apply(const Workstep* ws, const CutterShape& cutter, double lift = 0);
+  const Bnd_Box&      bounds() const   { return bb; }
+  double              cellSize() const { return h; }
+  void                cut(const gp_Pnt& from, const gp_Pnt& to, const CutterShape& cutter);
+  bool                hasMaterial(GOContour* c, double z, double radius) const;
+  bool                hasMaterial(const gp_Pnt& p, double radius) const;
+  double              maxTop(const gp_Pnt& from, const gp_Pnt& to, double radius) const;
+  std::vector<gp_Pnt> polylineOf(const Workstep* ws, double lift) const;
+  std::vector<double> removal(const std::vector<Workstep*>& path, const CutterShape& cutter, double lift = 0);
+  bool                removesMaterial(const gp_Pnt& from, const gp_Pnt& to, const CutterShape& cutter) const;
+  bool                removesMaterial(const Workstep* ws, const CutterShape& cutter, double lift = 0) const;
+  double              topAt(double x, double y) const;
+
+  static bool         cutterOf(const ToolEntry* tool, CutterShape& cutter, double& lift);
+
+protected:
+  struct Window {
+    int i0, i1, j0, j1;     // inclusive cell range
+    };
+  double              lower(const gp_Pnt& from, const gp_Pnt& to, const CutterShape& cutter, const Window& w, bool touched = false);
+  double              stamp(const gp_Pnt& tip, const CutterShape& cutter, const Window& w, bool touched = false);
+
+  static const int    TileSize = 32;
+
+private:
+  double              x0;
+  double              y0;
+  double              h;
+  int                 nx;
+  int                 ny;
+  Bnd_Box             bb;
+  std::vector<double> top;
+  };
+#endif // STOCKMODEL_H
@@ -27,21 +27,31 @@
 #include "ui_opSub.h"
 #include "ui_mainwindow.h"
 #include "core.h"
+#include "face3dtargetdefinition.h"
 #include "kuteCAM.h"
 #include "occtviewer.h"
 #include "operationlistmodel.h"
 #include "pathbuilder.h"
+#include "targetdeflistmodel.h"
 #include "util3d.h"
+#include "work.h"
+#include <BRep_Builder.hxx>
 #include <BRep_Tool.hxx>
 #include <GeomAdaptor_Surface.hxx>
 #include <Geom_Plane.hxx>
 #include <Geom_Surface.hxx>
+#include <TopoDS_Compound.hxx>
 #include <QAction>
 #include <QDebug>
 
 
 SubOP3DFace::SubOP3DFace(OperationListModel* olm, TargetDefListModel* tdModel, PathBuilder* pb, QWidget* parent)
  : OperationSubPage(olm, tdModel, pb, parent) {
+  ui->lCycle->setVisible(false);
+  ui->cbCycle->setVisible(false);
+  ui->lRetract->setVisible(false);
+  ui->spRetract->setVisible(false);
+  ui->spDwell->setVisible(false);
   connect(Core().uiMainWin()->action3DFaceNew, &QAction::triggered, this, &SubOP3DFace::createOP);
   }
 
@@ -49,26 +59,68 @@ SubOP3DFace::SubOP3DFace(OperationListModel* olm, TargetDefListModel* tdModel, P
 void SubOP3DFace::createOP() {
   int mx = olm->rowCount();
 
-  OperationSubPage::createOP(mx, QString(tr("Notch #%1")).arg(mx), NotchOperation);
+  OperationSubPage::createOP(mx, QString(tr("3D-Face #%1")).arg(mx), Face3DOperation);
   connectSignals();
   }
 
 
+// all selected faces form one target
 void SubOP3DFace::processSelection() {
   std::vector<TopoDS_Shape> selection = Core().view3D()->selection();
-
-  if (selection.size() > 1) {
+  BRep_Builder              builder;
+  TopoDS_Compound           faces;
+  int                       n = 0;
+
+  builder.MakeCompound(faces);
+  for (auto& s : selection) {
+      if (s.ShapeType() != TopAbs_FACE) continue;
+      builder.Add(faces, s);
+      ++n;
+      }
+  if (!n) return;
+  if (curOP->cShapes.size()) {
+     Core().view3D()->removeShapes(curOP->cShapes);
+     curOP->cShapes.clear();
      }
+  tdModel->clear();
+  tdModel->append(new Face3DTargetDefinition(faces));
+  processTargets();
   }
 
 
 void SubOP3DFace::processTargets() {
-
+  if (!tdModel->rowCount()) return;
+  Face3DTargetDefinition* ftd = dynamic_cast<Face3DTargetDefinition*>(tdModel->item(0));
+
+  if (!ftd || ftd->faces().IsNull()) return;
+  Handle(AIS_Shape) asFaces = new AIS_Shape(ftd->faces());
+  Bnd_Box           bb      = asFaces->BoundingBox();
+
+  curOP->setUpperZ(bb.CornerMax().Z());
+  curOP->setLowerZ(bb.CornerMin().Z());
+  asFaces->SetColor(Quantity_NOC_CYAN);
+  asFaces->SetTransparency(0.6);
+  curOP->cShapes.push_back(asFaces);
+  Core().view3D()->showShapes(curOP->cShapes);
+  Core().view3D()->refresh();
   }
 
 
 void SubOP3DFace::genFinishingToolPath() {
-
+  if (!tdModel->rowCount()) return;
+  Face3DTargetDefinition* ftd = dynamic_cast<Face3DTargetDefinition*>(tdModel->item(0));
+
+  if (!ftd) return;
+  Work*        work = Core().workData();
+  TopoDS_Shape model;                             // neighbors must not get gouged
+
+  if (!work->model.IsNull())
+     model = Core().helper3D()->fixRotation(work->model->Shape()
+                                          , curOP->operationA()
+                                          , curOP->operationB()
+                                          , curOP->operationC())->Shape();
+  curOP->workSteps() = pathBuilder()->genSurfacePath(curOP, ftd->faces(), model);
+  showToolPath(curOP);
   }
 
 
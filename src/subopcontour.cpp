@@ -28,6 +28,7 @@
 #include "ui_opSub.h"
 #include "ui_mainwindow.h"
 #include "cuttingparameters.h"
+#include "featurehasher.h"
 #include "gocircle.h"
 #include "gocontour.h"
 #include "kuteCAM.h"
@@ -39,11 +40,13 @@
 #include "targetdeflistmodel.h"
 #include "toolentry.h"
 #include "toollistmodel.h"
+#include "tracer.h"
 #include "core.h"
 #include "util3d.h"
 #include "work.h"
 #include "workstep.h"
 #include "wsarc.h"
+#include "wstraverse.h"
 #include <BRepBuilderAPI_MakeFace.hxx>
 #include <BRepOffsetAPI_MakeOffset.hxx>
 #include <BRepAlgoAPI_Section.hxx>
@@ -51,12 +54,43 @@
 #include <BRepPrimAPI_MakeBox.hxx>
 #include <BRepPrimAPI_MakeCylinder.hxx>
 #include <BRepPrimAPI_MakePrism.hxx>
+#include <BRep_Builder.hxx>
 #include <GeomAdaptor_Surface.hxx>
 #include <Geom_CylindricalSurface.hxx>
+#include <TopoDS_Compound.hxx>
 #include <TopoDS_Iterator.hxx>
 #include <QAction>
 #include <QStringListModel>
 #include <QDebug>
+#include <algorithm>
+
+
+// path builders start at tool change position (Z 300), which
+// must not show up in the middle of a path, nor get placed.
+static void dropToolChange(std::vector<Workstep*>& part) {
+  auto it = part.begin();
+
+  for (; it != part.end() && (*it)->startPos().Z() >= 300; ++it) delete *it;
+  part.erase(part.begin(), it);
+  }
+
+
+// lift to clearance height of the workpiece, then move over
+static void appendPath(std::vector<Workstep*>& path, const std::vector<Workstep*>& part, double clearZ) {
+  if (part.empty()) return;
+  if (!path.empty()) {
+     gp_Pnt from = path.back()->endPos();
+     gp_Pnt to   = part.front()->startPos();
+     double z    = std::max({clearZ, from.Z(), to.Z()});
+     gp_Pnt p0(from.X(), from.Y(), z);
+     gp_Pnt p1(to.X(), to.Y(), z);
+
+     if (!kute::isEqual(from, p0)) path.push_back(new WSTraverse(from, p0));
+     if (!kute::isEqual(p0, p1))   path.push_back(new WSTraverse(p0, p1));
+     if (!kute::isEqual(p1, to))   path.push_back(new WSTraverse(p1, to));
+     }
+  path.insert(path.end(), part.begin(), part.end());
+  }
 
 
 SubOPContour::SubOPContour(OperationListModel* olm, TargetDefListModel* tdModel, PathBuilder* pb, QWidget *parent)
@@ -112,10 +146,23 @@ void SubOPContour::processSelection() {
      aw->SetColor(Quantity_NOC_ORANGE);
      aw->SetWidth(3);
      curOP->cShapes.push_back(aw);
-     if (!tdModel->rowCount()) {
-        ContourTargetDefinition* ctd = new ContourTargetDefinition(center, -1);
+     // with feature instancing each selected contour becomes a target,
+     // so patterned pockets get machined by one operation. Same
+     // selection twice is ignored. Otherwise first selection wins.
+     bool known = !Core().isFeatureInstancing() && tdModel->rowCount();
+
+     for (TargetDefinition* td : curOP->targets) {
+         GOContour* c = td->contour();
+
+         if (c && c->size() == contour->size() && kute::isEqual(c->startPoint(), contour->startPoint())) known = true;
+         }
+     if (!known) {
+        ContourTargetDefinition* ctd   = new ContourTargetDefinition(center, -1);
+        Bnd_Box                  bbCut = cutPart->BoundingBox(); bbCut.SetGap(0);
 
         ctd->setContour(contour);
+        ctd->setZMin(bbCut.CornerMin().Z());
+        ctd->setZMax(bbCut.CornerMax().Z());
         tdModel->append(ctd);
         }
      }
@@ -265,8 +312,104 @@ void SubOPContour::processTargets() {
   }
 
 
+// finish walls of the model by waterlines from top of model
+// down to final depth of the operation. With targets only the
+// walls within their cut parts get finished.
 void SubOPContour::genFinishingToolPath() {
+  if (Core().workData()->model.IsNull()) return;
+  Handle(AIS_Shape)              md  = Core().helper3D()->fixRotation(Core().workData()->model->Shape()
+                                                                    , curOP->operationA()
+                                                                    , curOP->operationB()
+                                                                    , curOP->operationC());
+  Bnd_Box                        bb  = md->BoundingBox();
+  std::vector<TargetDefinition*> all = curOP->targets;
+  TopoDS_Compound                area;
+  BRep_Builder                   builder;
+  bool                           hasArea = false;
+
+  builder.MakeCompound(area);
+  for (TargetDefinition* td : all) {
+      curOP->targets = { td };
+      processTargets();
+      if (curOP->cutPart.IsNull()) continue;
+      builder.Add(area, curOP->cutPart->Shape());
+      hasArea = true;
+      }
+  curOP->targets = all;
+  if (all.size() && !hasArea) return;
+  curOP->workSteps() = pathBuilder()->genWaterlinePath(curOP
+                                                     , md->Shape()
+                                                     , bb.CornerMax().Z()
+                                                     , curOP->finalDepth()
+                                                     , hasArea ? TopoDS_Shape(area) : TopoDS_Shape());
+  showToolPath(curOP);
+  }
+
 
+// every target gets machined. Congruent pockets share the toolpath
+// of their representative, which gets placed on the other targets.
+// Outside contours and rest machining depend on the stock around
+// the target, so they still get a full run per target.
+// Depth of a target is known from its cut part only, and a copy
+// gets placed only, if its cut part (islands, floor) matches too.
+void SubOPContour::genInstancedToolPath() {
+  TraceSpan                      span("SubOPContour::genInstancedToolPath");
+  std::vector<TargetDefinition*> all    = curOP->targets;
+  std::vector<Handle(AIS_Shape)> cutParts;
+  std::vector<FeatureGroup>      groups;
+  std::vector<Workstep*>         path;
+  Handle(AIS_Shape)              cutPart = curOP->cutPart;
+  FeatureHasher                  hasher;
+  double                         clearZ  = curOP->wpBounds.CornerMax().Z() + curOP->safeZ1();
+  int                            copies  = 0;
+
+  for (TargetDefinition* td : all) {
+      curOP->targets = { td };
+      processTargets();
+      cutParts.push_back(curOP->cutPart);
+      if (curOP->cutPart.IsNull()) continue;
+      Bnd_Box bbCut = curOP->cutPart->BoundingBox(); bbCut.SetGap(0);
+
+      td->setZMin(bbCut.CornerMin().Z());
+      td->setZMax(bbCut.CornerMax().Z());
+      }
+  if (curOP->isOutside() || curOP->restStock) {
+     for (int i=0; i < (int)all.size(); ++i) groups.push_back({i, {}});
+     }
+  else groups = hasher.group(all, curOP->wpBounds);
+
+  for (const FeatureGroup& g : groups) {
+      const Handle(AIS_Shape)& repCut = cutParts.at(g.representative);
+
+      curOP->targets = { all.at(g.representative) };
+      curOP->cutPart = repCut;
+      std::vector<Workstep*> rp = genTargetPath();
+
+      dropToolChange(rp);
+      if (rp.empty()) continue;
+      appendPath(path, rp, clearZ);
+      for (const FeatureInstance& fi : g.copies) {
+          const Handle(AIS_Shape)& cut = cutParts.at(fi.target);
+
+          if (!repCut.IsNull() && !cut.IsNull()
+           && hasher.congruent(repCut->Shape(), cut->Shape(), fi.placement)) {
+             appendPath(path, FeatureHasher::placeCopy(rp, fi.placement), clearZ);
+             ++copies;
+             continue;
+             }
+          curOP->targets = { all.at(fi.target) };
+          curOP->cutPart = cut;
+          std::vector<Workstep*> own = genTargetPath();
+
+          dropToolChange(own);
+          appendPath(path, own, clearZ);
+          }
+      }
+  curOP->targets     = all;
+  curOP->cutPart     = cutPart;
+  curOP->workSteps() = path;
+  qCInfo(lcPath) << curOP->name() << ":" << all.size() << "targets in" << groups.size()
+                 << "groups," << copies << "placed as copies";
   }
 
 
@@ -299,39 +442,49 @@ void SubOPContour::genRoughingToolPath() {
      curOP->workSteps() = pathBuilder()->genToolPath(curOP, curOP->cutPart, true);
      }
   // try to cut selection based contour
+  else if (curOP->targets.size() > 1 && Core().isFeatureInstancing()) {
+     genInstancedToolPath();
+     }
   else if (curOP->targets.size()) {
-     ContourTargetDefinition* ctd = dynamic_cast<ContourTargetDefinition*>(curOP->targets.at(0));
+     if (curOP->cutPart.IsNull()) return;
+     curOP->workSteps() = genTargetPath();
+     }
+  showToolPath(curOP);
+  }
 
-     if (!ctd || curOP->cutPart.IsNull()) return;
 
-     if (kute::isEqual(ctd->radius(), 0)) {
-        // may be stored waterline contour?!?
-        curOP->workSteps() = pathBuilder()->genToolPath(curOP, curOP->cutPart, true);
-        }
-     else if (ctd->radius() < 0) {
-        // possibly contour from selected faces ...
-        curOP->workSteps() = pathBuilder()->genToolPath(curOP, curOP->cutPart, true);
+// toolpath of first target, cut part must be built already
+std::vector<Workstep*> SubOPContour::genTargetPath() {
+  ContourTargetDefinition* ctd = dynamic_cast<ContourTargetDefinition*>(curOP->targets.at(0));
+
+  if (!ctd || curOP->cutPart.IsNull()) return {};
+  if (kute::isEqual(ctd->radius(), 0)) {
+     // may be stored waterline contour?!?
+     return pathBuilder()->genToolPath(curOP, curOP->cutPart, true);
+     }
+  else if (ctd->radius() < 0) {
+     // possibly contour from selected faces ...
+     return pathBuilder()->genToolPath(curOP, curOP->cutPart, true);
+     }
+  else {
+     // possibly cylindrical face selection
+     qDebug() << "cut cylindrical face contour?!?";
+     Bnd_Box bbCut = curOP->cutPart->BoundingBox();
+     std::vector<TopoDS_Edge> edges = Core().helper3D()->allEdgesWithin(curOP->cutPart->Shape());
+     double dx = bbCut.CornerMax().X() - bbCut.CornerMin().X();
+     double dy = bbCut.CornerMax().Y() - bbCut.CornerMin().Y();
+
+     if (dx > (2.0 * ctd->radius() + 1) || dy > (2.0 * ctd->radius() + 1)) {
+        // mill outside of circle ...
+        return pathBuilder()->genToolPath(curOP, curOP->cutPart, false);
         }
      else {
-        // possibly cylindrical face selection
-        qDebug() << "cut cylindrical face contour?!?";
-        Bnd_Box bbCut = curOP->cutPart->BoundingBox();
-        std::vector<TopoDS_Edge> edges = Core().helper3D()->allEdgesWithin(curOP->cutPart->Shape());
-        double dx = bbCut.CornerMax().X() - bbCut.CornerMin().X();
-        double dy = bbCut.CornerMax().Y() - bbCut.CornerMin().Y();
-
-        if (dx > (2.0 * ctd->radius() + 1) || dy > (2.0 * ctd->radius() + 1)) {
-           // mill outside of circle ...
-           curOP->workSteps() = pathBuilder()->genToolPath(curOP, curOP->cutPart, false);
-           }
-        else {
-           // posibly circular pocket ...
-           std::vector<Handle(AIS_Shape)> cutPlanes = createCutPlanes(curOP);
-           curOP->workSteps() = pathBuilder()->genRoundToolpaths(curOP, cutPlanes);
-           }
+        // posibly circular pocket ...
+        std::vector<Handle(AIS_Shape)> cutPlanes = createCutPlanes(curOP);
+        return pathBuilder()->genRoundToolpaths(curOP, cutPlanes);
         }
      }
-  showToolPath(curOP);
+  return {};
   }
 
 
@@ -27,7 +27,9 @@
 #ifndef SUBOPCONTOUR_H
 #define SUBOPCONTOUR_H
 #include "operationsubpage.h"
+#include <vector>
 class PathBuilder;
+class Workstep;
 
 
 class SubOPContour : public OperationSubPage
@@ -46,6 +48,8 @@ public slots:
   void updateCut(double d);
 
 protected:
-  void processSelection();
+  void                   genInstancedToolPath();
+  std::vector<Workstep*> genTargetPath();
+  void                   processSelection();
   };
 #endif // SUBOPCONTOUR_H
@@ -25,6 +25,7 @@
  * **************************************************************************
  */
 #include "subopsweep.h"
+#include "booleanengine.h"
 #include "gocontour.h"
 #include "gopocket.h"
 #include "ui_opSub.h"
@@ -136,7 +137,7 @@ void SubOPSweep::processSelection() {
      else if (contour->centerPoint().Y() > (center.Y() + 5))
         center.SetY(bbCP.CornerMax().Y());
      if (!curOP->workPiece.IsNull()) {
-        TopoDS_Shape master = BRepAlgoAPI_Common(contour->toWire(0), curOP->workPiece->Shape());
+        TopoDS_Shape master = Core().booleanEngine()->common(contour->toWire(0), curOP->workPiece->Shape());
         Handle(AIS_Shape) asM = new AIS_Shape(master);
 
         qDebug() << "contour of selection: " << contour->toString();
@@ -204,7 +205,7 @@ void SubOPSweep::processSelection() {
               aw->SetWidth(3);
 
               if (!curOP->workPiece.IsNull()) {
-                 TopoDS_Shape master = BRepAlgoAPI_Common(contour->toWire(), curOP->workPiece->Shape());
+                 TopoDS_Shape master = Core().booleanEngine()->common(contour->toWire(), curOP->workPiece->Shape());
                  contour->setContour(master);
                  }
               std = new SweepTargetDefinition(pos, dir);
@@ -24,6 +24,7 @@
  * **************************************************************************
  */
 #include "subsimulation.h"
+#include "booleanengine.h"
 #include "ui_opSim.h"
 #include "core.h"
 #include "kuteCAM.h"
@@ -32,7 +33,6 @@
 #include "toollistmodel.h"
 #include <AIS_Shape.hxx>
 #include <BRepAdaptor_Curve.hxx>
-#include <BRepAlgoAPI_Fuse.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
 #include <BRepPrimAPI_MakeCone.hxx>
 #include <BRepPrimAPI_MakeCylinder.hxx>
@@ -81,10 +81,10 @@ void SubSimulation::createTool(int toolNum) {
   move.SetTranslation(gp_Pnt(0, 0, 0), gp_Pnt(0, 0, cutHeight));
   TopoDS_Shape movedShape = BRepBuilderAPI_Transform(mkShaft0.Shape(), move, false);
 
-  sTool = BRepAlgoAPI_Fuse(cutPart, movedShape);
+  sTool = Core().booleanEngine()->fuse(cutPart, movedShape);
   move.SetTranslation(gp_Pnt(0, 0, 0), gp_Pnt(0, 0, activeTool->cuttingDepth()));
   movedShape = BRepBuilderAPI_Transform(mkShaft1.Shape(), move, false);
-  sTool = BRepAlgoAPI_Fuse(sTool, movedShape);
+  sTool = Core().booleanEngine()->fuse(sTool, movedShape);
 
   asTool = new AIS_Shape(sTool);
   asTool->SetColor(Quantity_NOC_GRAY);
@@ -0,0 +1,251 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       surfacepathbuilder.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "surfacepathbuilder.h"
+#include "core.h"
+#include "dropcutter.h"
+#include "kuteCAM.h"
+#include "operation.h"
+#include "pathbuilderutil.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include "wsstraightmove.h"
+#include "wstraverse.h"
+#include <BRepBndLib.hxx>
+#include <BRep_Builder.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS_Compound.hxx>
+#include <gp_Vec.hxx>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <memory>
+
+
+typedef std::vector<gp_Pnt> Run;
+
+
+// stretches of one raster line, where the cutter touches the faces
+struct RasterLine
+{
+  std::vector<Run> runs;
+  };
+
+
+// drop points that deviate less than tolerance from the line
+// between their neighbors
+static void reduce(Run& run, double tolerance) {
+  if (run.size() < 3) return;
+  Run res;
+  int mx = run.size();
+
+  res.reserve(mx);
+  res.push_back(run.front());
+  for (int i=1; i < mx - 1; ++i) {
+      gp_Vec ab(res.back(), run[i + 1]);
+      gp_Vec ap(res.back(), run[i]);
+      double l = ab.Magnitude();
+
+      if (l > kute::MinDelta && ap.Crossed(ab).Magnitude() / l < tolerance) continue;
+      res.push_back(run[i]);
+      }
+  res.push_back(run.back());
+  run.swap(res);
+  }
+
+
+// drop onto selected faces. Neighbors of the model only lift the
+// cutter, they don't extend the area to machine.
+static bool dropOnto(const DropCutter& dc, const DropCutter* guard, double x, double y, double& z) {
+  double gz;
+
+  if (!dc.drop(x, y, z)) return false;
+  if (guard && guard->drop(x, y, gz)) z = std::max(z, gz);
+
+  return true;
+  }
+
+
+SurfacePathBuilder::SurfacePathBuilder(PathBuilderUtil* pbu)
+ : pbu(pbu) {
+  }
+
+
+std::vector<Workstep*> SurfacePathBuilder::genFinishingPath(Operation* op, const TopoDS_Shape& faces, const TopoDS_Shape& model) {
+  TraceSpan              span("SurfacePathBuilder::genFinishingPath");
+  std::vector<Workstep*> toolPath;
+  CutterShape            cutter;
+  double                 tolerance = Core().chordTolerance();
+  double                 stepOver  = op->cutWidth();
+  double                 allowance = op->offset();
+
+  if (faces.IsNull() || stepOver <= 0) return toolPath;
+  if (!CutterShape::fromTool(op->toolEntry(), cutter)) {
+     qCWarning(lcPath) << "surface finishing: tool of operation" << op->name()
+                       << "is neither flat, bull nose nor ball nose mill";
+     return toolPath;
+     }
+  // allowance is handled by a cutter grown by allowance
+  cutter.radius      += allowance;
+  cutter.cornerRadius = std::max(0.0, cutter.cornerRadius + allowance);
+  DropCutter                  dc(faces, cutter, tolerance / 2);
+  const Bnd_Box&              bb = dc.bounds();
+  std::unique_ptr<DropCutter> guard;
+
+  if (bb.IsVoid()) return toolPath;
+  if (!model.IsNull()) {
+     Bnd_Box      area = bb;                     // mesh bounds - without cutter
+
+     area.Enlarge(cutter.radius);
+     TopoDS_Shape nf = neighborFaces(model, area);
+
+     if (!nf.IsNull()) guard.reset(new DropCutter(nf, cutter, tolerance / 2));
+     }
+  double x0 = bb.CornerMin().X();
+  double x1 = bb.CornerMax().X();
+  double y0 = bb.CornerMin().Y();
+  double y1 = bb.CornerMax().Y();
+  double dx = std::max(0.01, std::min(cutter.radius / 2, std::sqrt(8 * cutter.radius * tolerance)));
+  int    nx = std::ceil((x1 - x0) / dx);
+  int    ny = std::ceil((y1 - y0) / stepOver) + 1;
+  std::vector<RasterLine> lines(ny);
+
+  OSD_Parallel::For(0, ny, [&](int i) {
+    RasterLine& line = lines[i];
+    double      y    = std::min(y1, y0 + i * stepOver);
+    Run         run;
+    double      z;
+
+    for (int j=0; j <= nx; ++j) {
+        double x = std::min(x1, x0 + j * dx);
+
+        if (dropOnto(dc, guard.get(), x, y, z)) run.emplace_back(x, y, z + allowance);
+        else if (run.size()) {
+           line.runs.push_back(run);
+           run.clear();
+           }
+        }
+    if (run.size()) line.runs.push_back(run);
+    for (auto& r : line.runs) reduce(r, tolerance);
+    if (i % 2) {                                // zigzag
+       std::reverse(line.runs.begin(), line.runs.end());
+       for (auto& r : line.runs) std::reverse(r.begin(), r.end());
+       }
+    });
+
+  // join raster lines
+  double              topZ  = guard ? std::max(bb.CornerMax().Z(), guard->bounds().CornerMax().Z())
+                                    : bb.CornerMax().Z();
+  double              safeZ = topZ + allowance + op->safeZ1();
+  gp_Pnt              e(x0, y0, safeZ);
+  std::vector<gp_Pnt> linkPoints;
+  bool                first = true;
+  int                 links = 0, retracts = 0;
+
+  for (auto& line : lines) {
+      for (auto& run : line.runs) {
+          const gp_Pnt& s = run.front();
+
+          if (!first && link(dc, guard.get(), e, s, dx, allowance, linkPoints)) {
+             for (auto& p : linkPoints) {
+                 toolPath.push_back(new WSStraightMove(e, p));
+                 e = p;
+                 }
+             ++links;
+             }
+          else {
+             gp_Pnt up(e.X(), e.Y(), safeZ);
+             gp_Pnt over(s.X(), s.Y(), safeZ);
+
+             if (!kute::isEqual(e, up))    toolPath.push_back(new WSTraverse(e, up));
+             if (!kute::isEqual(up, over)) toolPath.push_back(new WSTraverse(up, over));
+             toolPath.push_back(new WSStraightMove(over, s));
+             if (!first) ++retracts;
+             }
+          first = false;
+          e     = s;
+          for (size_t i=1; i < run.size(); ++i) {
+              toolPath.push_back(new WSStraightMove(e, run[i]));
+              e = run[i];
+              }
+          }
+      }
+  if (!first) toolPath.push_back(new WSTraverse(e, gp_Pnt(e.X(), e.Y(), safeZ)));
+  pbu->cleanup(toolPath);
+  qCDebug(lcPath) << "surface finishing:" << dc.triangleCount() << "triangles,"
+                  << ny << "raster lines," << links << "links," << retracts << "retracts";
+
+  return toolPath;
+  }
+
+
+// feed from end of one run to start of next one, if the cutter
+// keeps contact on the way and both are neighbors
+bool SurfacePathBuilder::link(const DropCutter& dc, const DropCutter* guard, const gp_Pnt& from, const gp_Pnt& to, double step, double allowance, std::vector<gp_Pnt>& points) const {
+  double dist = std::hypot(to.X() - from.X(), to.Y() - from.Y());
+  int    n    = std::max(1, (int)std::ceil(dist / step));
+  double z;
+
+  points.clear();
+  if (dist > 2 * dc.cutterShape().radius) return false;
+  for (int i=1; i < n; ++i) {
+      double x = from.X() + (to.X() - from.X()) * i / n;
+      double y = from.Y() + (to.Y() - from.Y()) * i / n;
+
+      if (!dropOnto(dc, guard, x, y, z)) return false;
+      points.emplace_back(x, y, z + allowance);
+      }
+  points.push_back(to);
+
+  return true;
+  }
+
+
+// faces of model, which may be touched by the cutter while it
+// machines the area. Selected faces are part of the result too,
+// which doesn't hurt.
+TopoDS_Shape SurfacePathBuilder::neighborFaces(const TopoDS_Shape& model, const Bnd_Box& area) const {
+  BRep_Builder    builder;
+  TopoDS_Compound comp;
+  int             n = 0;
+
+  builder.MakeCompound(comp);
+  for (TopExp_Explorer ex(model, TopAbs_FACE); ex.More(); ex.Next()) {
+      Bnd_Box fb;
+
+      BRepBndLib::Add(ex.Current(), fb);
+      if (fb.IsVoid()) continue;
+      // cutter drops along Z, so only XY extent matters
+      if (fb.CornerMax().X() < area.CornerMin().X() || fb.CornerMin().X() > area.CornerMax().X()
+       || fb.CornerMax().Y() < area.CornerMin().Y() || fb.CornerMin().Y() > area.CornerMax().Y()) continue;
+      builder.Add(comp, ex.Current());
+      ++n;
+      }
+  if (!n) return TopoDS_Shape();
+
+  return comp;
+  }
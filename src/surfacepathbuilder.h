@@ -0,0 +1,58 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       surfacepathbuilder.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef SURFACEPATHBUILDER_H
+#define SURFACEPATHBUILDER_H
+#include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
+#include <vector>
+class Bnd_Box;
+class DropCutter;
+class Operation;
+class PathBuilderUtil;
+class Workstep;
+
+
+// finishing of freeform surfaces by parallel raster lines along X.
+// The cutter gets dropped onto the triangulated faces, raster lines
+// are computed in parallel and joined to a zigzag path afterwards.
+// Faces of the model next to the selected ones get meshed as well
+// and may only lift the cutter, so neighbors don't get gouged.
+class SurfacePathBuilder
+{
+public:
+  SurfacePathBuilder(PathBuilderUtil* pbu);
+
+  std::vector<Workstep*> genFinishingPath(Operation* op, const TopoDS_Shape& faces, const TopoDS_Shape& model = TopoDS_Shape());
+
+protected:
+  bool         link(const DropCutter& dc, const DropCutter* guard, const gp_Pnt& from, const gp_Pnt& to, double step, double allowance, std::vector<gp_Pnt>& points) const;
+  TopoDS_Shape neighborFaces(const TopoDS_Shape& model, const Bnd_Box& area) const;
+
+private:
+  PathBuilderUtil* pbu;
+  };
+#endif // SURFACEPATHBUILDER_H
@@ -32,6 +32,7 @@
 #include "work.h"
 #include "wsstraightmove.h"
 #include "wstraverse.h"
+#include "tracer.h"
 #include <QDebug>
 
 
@@ -42,18 +43,20 @@ SweepPathBuilder::SweepPathBuilder(PathBuilderUtil* pbu)
 
 // prepare toolpath creation for sweepBigC...
 void SweepPathBuilder::createHorizontalToolpaths(Operation* op, const std::vector<Handle(AIS_Shape)>& cutPlanes) {
+  TraceSpan span("SweepPathBuilder::createHorizontalToolpaths");
   Work*  work = Core().workData();
   ToolEntry* activeTool = op->toolEntry();
   gp_Pnt from, to, lastTO;
   int    cntPaths = 0;
 
-  qDebug() << "create toolpaths for cutplanes:";
+  qCDebug(lcPath) << "create toolpaths for cutplanes:";
 
   for (auto s : cutPlanes) {
       Bnd_Box bb = s->BoundingBox(); bb.SetGap(0);
 
-      qDebug() << "workpiece is" << (work->roundWorkPiece ? "round" : "rectangled");
-      qDebug() << "cut plane: "
+      if (bb.IsVoid()) continue;       // level above or below of workpiece
+      qCDebug(lcPath) << "workpiece is" << (work->roundWorkPiece ? "round" : "rectangled");
+      qCDebug(lcPath) << "cut plane: "
                << bb.CornerMin().X() << "/" << bb.CornerMin().Y() << "/" << bb.CornerMin().Z()
                << "\tto\t"
                << bb.CornerMax().X() << "/" << bb.CornerMax().Y() << "/" << bb.CornerMax().Z();
@@ -169,7 +172,7 @@ gp_Pnt SweepPathBuilder::sweepBigClockwise(Operation* op, ToolEntry* activeTool,
      curX0 += op->cutWidth();
 
      if (curX1 < curX0) {
-        qDebug() << "leave cutplane before closing rectangle - last y"
+        qCDebug(lcPath) << "leave cutplane before closing rectangle - last y"
                  << curY1 << " - y before:" << curY0;
         from = to;
         to.SetY(cycle ? curY0 : startPos.Y());
@@ -233,7 +236,7 @@ gp_Pnt SweepPathBuilder::sweepBigCounterClockwise(Operation* op, ToolEntry* acti
      curY0 += op->cutWidth();
 
      if (curY1 < curY0) {
-        qDebug() << "leave cutplane before closing rectangle - last y"
+        qCDebug(lcPath) << "leave cutplane before closing rectangle - last y"
                  << curY1 << " - y before:" << curY0;
         from = to;
         to.SetY(cycle ? curY0 : startPos.Y());
@@ -53,12 +53,17 @@ TargetDefinition::TargetDefinition(QSettings& s, QObject* parent)
   r    = s.value("tdRadius").toDouble();
   zmin = s.value("tdZMin").toDouble();
   zmax = s.value("tdZMax").toDouble();
-  QString cSrc = s.value("contour").toString();
+  QByteArray bin = QByteArray::fromBase64(s.value("contourBin").toByteArray());
 
-  if (!cSrc.isEmpty()) {
-     GraphicObject* go = Core().helper3D()->parseGraphicObject(s.value("contour").toString());
+  if (!bin.isEmpty()) cc = GOContour::fromBinary(bin);
+  if (!cc) {                      // old text format
+     QString cSrc = s.value("contour").toString();
 
-     cc = static_cast<GOContour*>(go);
+     if (!cSrc.isEmpty()) {
+        GraphicObject* go = Core().helper3D()->parseGraphicObject(cSrc);
+
+        cc = static_cast<GOContour*>(go);
+        }
      }
   }
 
@@ -70,7 +75,13 @@ void TargetDefinition::store(QSettings& s) {
   s.setValue("tdRadius", r);
   s.setValue("tdZMin", zMin());
   s.setValue("tdZMax", zMax());
-  if (cc) s.setValue("contour", cc->toString());
+  s.remove("contour");
+  s.remove("contourBin");
+  if (!cc) return;
+  QByteArray bin = cc->toBinary();
+
+  if (bin.isEmpty()) s.setValue("contour", cc->toString());
+  else               s.setValue("contourBin", QString::fromLatin1(bin.toBase64()));
   }
 
 
@@ -28,6 +28,7 @@
 #include "cctargetdefinition.h"
 #include "contourtargetdefinition.h"
 #include "drilltargetdefinition.h"
+#include "face3dtargetdefinition.h"
 #include "notchtargetdefinition.h"
 #include "sweeptargetdefinition.h"
 #include <QSettings>
@@ -41,6 +42,6 @@ TargetDefinition* TDFactory::createTargetDefinition(QSettings &s) {
   else if (type == "CCTarget")      return new CCTargetDefinition(s);
   else if (type == "ContourTarget") return new ContourTargetDefinition(s);
   else if (type == "NotchTarget")   return new NotchTargetDefinition(s);
-//  else if (type == "Face3DTarget")  return new Face3DTargetDefinition(s);
+  else if (type == "Face3DTarget")  return new Face3DTargetDefinition(s);
   return nullptr;
   }
@@ -0,0 +1,241 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       tooldatabase.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "tooldatabase.h"
+#include "cuttingparameters.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include <QSqlDatabase>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QVariant>
+#include <QDebug>
+
+
+ToolDatabase::ToolDatabase(const QString& fileName, QObject* parent)
+ : QObject(parent)
+ , connection(QString("tools-%1").arg(reinterpret_cast<quintptr>(this)))
+ , open(false) {
+  QSqlDatabase db = QSqlDatabase::addDatabase("QSQLITE", connection);
+
+  db.setDatabaseName(fileName);
+  if (!db.open()) {
+     qWarning() << "failed to open tool database" << fileName << ":" << db.lastError().text();
+     return;
+     }
+  open = createSchema();
+  }
+
+
+ToolDatabase::~ToolDatabase() {
+  QSqlDatabase::database(connection, false).close();
+  QSqlDatabase::removeDatabase(connection);
+  }
+
+
+int ToolDatabase::count() const {
+  QSqlQuery q("SELECT COUNT(*) FROM tool", QSqlDatabase::database(connection));
+
+  return q.next() ? q.value(0).toInt() : 0;
+  }
+
+
+bool ToolDatabase::createSchema() {
+  QSqlQuery         q(QSqlDatabase::database(connection));
+  const char* const schema[] = {
+    "CREATE TABLE IF NOT EXISTS tool ("
+    " num INTEGER PRIMARY KEY, name TEXT, collet INTEGER, tipDiameter REAL"
+    ", fluteDiameter REAL, fluteLength REAL, cuttingDepth REAL, cuttingAngle REAL"
+    ", shankDiameter REAL, freeLength REAL, flutes INTEGER)"
+  , "CREATE TABLE IF NOT EXISTS cutparam ("
+    " tool INTEGER REFERENCES tool(num) ON DELETE CASCADE, row INTEGER, material TEXT"
+    ", speed REAL, feed REAL, width REAL, depth REAL, PRIMARY KEY (tool, row))"
+  , "CREATE INDEX IF NOT EXISTS toolDiameter ON tool(fluteDiameter)"
+  , "CREATE INDEX IF NOT EXISTS toolName ON tool(name)"
+  , "CREATE INDEX IF NOT EXISTS cutMaterial ON cutparam(material)"
+    };
+
+  for (const char* sql : schema) {
+      if (!q.exec(sql)) {
+         qWarning() << "tool database:" << q.lastError().text();
+         return false;
+         }
+      }
+  return true;
+  }
+
+
+QVector<int> ToolDatabase::findByDiameter(double min, double max) const {
+  return numbers("SELECT num FROM tool WHERE fluteDiameter BETWEEN ? AND ? ORDER BY fluteDiameter, num"
+               , { min, max });
+  }
+
+
+QVector<int> ToolDatabase::findByMaterial(const QString& material) const {
+  return numbers("SELECT DISTINCT tool FROM cutparam WHERE material = ? ORDER BY tool"
+               , { material });
+  }
+
+
+// pattern uses sql wildcards (% and _)
+QVector<int> ToolDatabase::findByName(const QString& pattern) const {
+  return numbers("SELECT num FROM tool WHERE name LIKE ? ORDER BY num"
+               , { pattern });
+  }
+
+
+QVector<int> ToolDatabase::numbers(const QString& sql, const QVariantList& args) const {
+  QVector<int> rv;
+  QSqlQuery    q(QSqlDatabase::database(connection));
+
+  q.setForwardOnly(true);
+  q.prepare(sql);
+  for (const QVariant& v : args) q.addBindValue(v);
+  if (!q.exec()) {
+     qWarning() << "tool database:" << q.lastError().text();
+     return rv;
+     }
+  while (q.next()) rv.append(q.value(0).toInt());
+
+  return rv;
+  }
+
+
+// replaces tools with same number. All in one transaction, so
+// importing a library of thousands of tools takes no time.
+int ToolDatabase::store(const QVector<ToolEntry*>& tools) {
+  TraceSpan    span("ToolDatabase::store");
+  QSqlDatabase db = QSqlDatabase::database(connection);
+  QSqlQuery    qt(db);
+  QSqlQuery    qd(db);
+  QSqlQuery    qc(db);
+  int          rv = 0;
+
+  if (!open) return 0;
+  db.transaction();
+  qt.prepare("INSERT OR REPLACE INTO tool VALUES (?, ?, ?, ?, ?, ?, ?, ?, ?, ?, ?)");
+  qd.prepare("DELETE FROM cutparam WHERE tool = ?");
+  qc.prepare("INSERT INTO cutparam VALUES (?, ?, ?, ?, ?, ?, ?)");
+  for (const ToolEntry* t : tools) {
+      if (!t || !t->toolNumber()) continue;
+      qt.addBindValue(t->toolNumber());
+      qt.addBindValue(t->toolName());
+      qt.addBindValue(t->collet());
+      qt.addBindValue(t->tipDiameter());
+      qt.addBindValue(t->fluteDiameter());
+      qt.addBindValue(t->fluteLength());
+      qt.addBindValue(t->cuttingDepth());
+      qt.addBindValue(t->cuttingAngle());
+      qt.addBindValue(t->shankDiameter());
+      qt.addBindValue(t->freeLength());
+      qt.addBindValue(t->numFlutes());
+      if (!qt.exec()) {
+         qWarning() << "tool database:" << qt.lastError().text();
+         db.rollback();
+         return 0;
+         }
+      qd.addBindValue(t->toolNumber());
+      qd.exec();
+      for (int i=0; i < t->cutParameters().size(); ++i) {
+          const CuttingParameters* cp = t->cutParameters().at(i);
+
+          qc.addBindValue(t->toolNumber());
+          qc.addBindValue(i);
+          qc.addBindValue(cp->name());
+          qc.addBindValue(cp->cuttingSpeed());
+          qc.addBindValue(cp->toothFeed());
+          qc.addBindValue(cp->widthOfCut());
+          qc.addBindValue(cp->depthOfCut());
+          qc.exec();
+          }
+      if (cache.value(t->toolNumber()) != t) cache.remove(t->toolNumber());
+      ++rv;
+      }
+  db.commit();
+
+  return rv;
+  }
+
+
+ToolEntry* ToolDatabase::tool(int num) {
+  auto it = cache.find(num);
+
+  if (it != cache.end()) return it.value();
+  QSqlDatabase db = QSqlDatabase::database(connection);
+  QSqlQuery    q(db);
+
+  q.prepare("SELECT name, collet, tipDiameter, fluteDiameter, fluteLength, cuttingDepth"
+            ", cuttingAngle, shankDiameter, freeLength, flutes FROM tool WHERE num = ?");
+  q.addBindValue(num);
+  if (!q.exec() || !q.next()) return nullptr;
+  ToolEntry* t = new ToolEntry(num, q.value(0).toString(), this);
+
+  t->setCollet(q.value(1).toInt());
+  t->setTipDiameter(q.value(2).toDouble());
+  t->setFluteDiameter(q.value(3).toDouble());
+  t->setFluteLength(q.value(4).toDouble());
+  t->setCuttingDepth(q.value(5).toDouble());
+  t->setCuttingAngle(q.value(6).toDouble());
+  t->setShankDiameter(q.value(7).toDouble());
+  t->setFreeLength(q.value(8).toDouble());
+  t->setNumFlutes(q.value(9).toInt());
+
+  QSqlQuery qc(db);
+
+  qc.prepare("SELECT material, speed, feed, width, depth FROM cutparam WHERE tool = ? ORDER BY row");
+  qc.addBindValue(num);
+  if (qc.exec()) {
+     while (qc.next()) {
+           CuttingParameters* cp = new CuttingParameters(qc.value(0).toString());
+
+           cp->setCuttingSpeed(qc.value(1).toDouble());
+           cp->setToothFeed(qc.value(2).toDouble());
+           cp->setWidthOfCut(qc.value(3).toDouble());
+           cp->setDepthOfCut(qc.value(4).toDouble());
+           t->cutParameters().append(cp);
+           }
+     }
+  cache.insert(num, t);
+
+  return t;
+  }
+
+
+QVector<int> ToolDatabase::toolNumbers() const {
+  return numbers("SELECT num FROM tool ORDER BY num", {});
+  }
+
+
+QVector<ToolEntry*> ToolDatabase::tools() {
+  QVector<ToolEntry*> rv;
+
+  for (int num : toolNumbers()) {
+      ToolEntry* t = tool(num);
+
+      if (t) rv.append(t);
+      }
+  return rv;
+  }
@@ -0,0 +1,65 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       tooldatabase.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef TOOLDATABASE_H
+#define TOOLDATABASE_H
+#include <QHash>
+#include <QObject>
+#include <QVector>
+class ToolEntry;
+
+
+// tool library in a sqlite file. Tools are indexed by number, flute
+// diameter, name and material of their cutting parameters. Entries
+// get created on first access only and stay cached as children of
+// the database, so large libraries cost nearly nothing until used.
+class ToolDatabase : public QObject
+{
+  Q_OBJECT
+public:
+  explicit ToolDatabase(const QString& fileName, QObject* parent = nullptr);
+  virtual ~ToolDatabase();
+
+  int                 count() const;
+  QVector<int>        findByDiameter(double min, double max) const;
+  QVector<int>        findByMaterial(const QString& material) const;
+  QVector<int>        findByName(const QString& pattern) const;
+  bool                isOpen() const { return open; }
+  int                 store(const QVector<ToolEntry*>& tools);
+  ToolEntry*          tool(int num);
+  QVector<int>        toolNumbers() const;
+  QVector<ToolEntry*> tools();
+
+protected:
+  bool                createSchema();
+  QVector<int>        numbers(const QString& sql, const QVariantList& args) const;
+
+private:
+  QString                connection;
+  bool                   open;
+  QHash<int, ToolEntry*> cache;
+  };
+#endif // TOOLDATABASE_H
@@ -25,12 +25,14 @@
  * **************************************************************************
  */
 #include "toollistmodel.h"
+#include "tooldatabase.h"
 #include "toolentry.h"
 #include <QDebug>
 
 
 ToolListModel::ToolListModel(QObject *parent)
- : QAbstractListModel(parent) {
+ : QAbstractListModel(parent)
+ , db(nullptr) {
   if (!noTool) noTool = new ToolEntry(0, tr("-- please select --"));
   }
 
@@ -40,6 +42,8 @@ void ToolListModel::add(ToolEntry* tool) {
 
   beginInsertRows(QModelIndex(), row, row);
   tList.append(tool);
+  tNums.append(tool->toolNumber());
+  if (!rowOfNum.contains(tool->toolNumber())) rowOfNum.insert(tool->toolNumber(), row);
   endInsertRows();
   }
 
@@ -47,7 +51,7 @@ void ToolListModel::add(ToolEntry* tool) {
 QVariant ToolListModel::data(const QModelIndex& index, int role) const {
   if (!index.isValid()) return QVariant();
   else if (role == Qt::DisplayRole) {
-    ToolEntry* te = tList.at(index.row());
+    ToolEntry* te = entry(index.row());
 
     if (!te) return QVariant();
     return te->toString();
@@ -56,11 +60,26 @@ QVariant ToolListModel::data(const QModelIndex& index, int role) const {
   }
 
 
+ToolEntry* ToolListModel::entry(int row) const {
+  if (!tList[row] && db) tList[row] = db->tool(tNums[row]);
+
+  return tList[row];
+  }
+
+
+// tool editor renumbers entries in place, so a cached row has to
+// carry the number asked for. Otherwise the index gets rebuilt from
+// the live numbers of all entries.
 int ToolListModel::findToolNum(int toolNum) {
+  int row = rowOfNum.value(toolNum, -1);
+
+  if (row >= 0 && row < tList.size() && numberOf(row) == toolNum) return row;
+  rowOfNum.clear();
   for (int i=0; i < tList.size(); ++i) {
-      if (tList.at(i)->toolNumber() == toolNum) return i;
+      tNums[i] = numberOf(i);
+      if (!rowOfNum.contains(tNums[i])) rowOfNum.insert(tNums[i], i);
       }
-  return -1;
+  return rowOfNum.value(toolNum, -1);
   }
 
 
@@ -69,13 +88,43 @@ QVariant ToolListModel::headerData(int section, Qt::Orientation orientation, int
   }
 
 
+// loaded entries may have been renumbered since
+int ToolListModel::numberOf(int row) const {
+  return tList[row] ? tList[row]->toolNumber() : tNums[row];
+  }
+
+
 int ToolListModel::rowCount(const QModelIndex& parent) const {
   return tList.count();
   }
 
 
+// only numbers are read from database, entries follow on first access
+void ToolListModel::setDatabase(ToolDatabase* db) {
+  beginResetModel();
+  this->db = db;
+  tList.clear();
+  tNums.clear();
+  rowOfNum.clear();
+  tList.append(noTool);
+  tNums.append(0);
+  rowOfNum.insert(0, 0);
+  if (db) {
+     for (int num : db->toolNumbers()) {
+         rowOfNum.insert(num, tList.size());
+         tList.append(nullptr);
+         tNums.append(num);
+         }
+     }
+  endResetModel();
+  }
+
+
 void ToolListModel::setData(const QVector<ToolEntry *> &tools) {
+  db = nullptr;
   tList.clear();
+  tNums.clear();
+  rowOfNum.clear();
   add(noTool);
   for (ToolEntry* t : tools) {
       add(t);
@@ -170,11 +219,13 @@ void ToolListModel::setupTestData() {
 
 ToolEntry* ToolListModel::tool(int row) {
   if (row < 0 || row >= tList.count()) return nullptr;
-  return tList.at(row);
+  return entry(row);
   }
 
 
 QVector<ToolEntry*> ToolListModel::tools() const {
+  for (int i=0; i < tList.size(); ++i) entry(i);
+
   return tList;
   }
 
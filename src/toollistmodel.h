@@ -27,7 +27,9 @@
 #ifndef TOOLLISTMODEL_H
 #define TOOLLISTMODEL_H
 #include <QAbstractListModel>
+#include <QHash>
 #include <QVector>
+class ToolDatabase;
 class ToolEntry;
 
 
@@ -45,11 +47,19 @@ public:
   virtual int                 rowCount(const QModelIndex &parent = QModelIndex()) const override;
   virtual void                setupTestData();
   virtual void                setData(const QVector<ToolEntry*>& tools);
+  virtual void                setDatabase(ToolDatabase* db);
   virtual ToolEntry*          tool(int row);
   virtual QVector<ToolEntry*> tools() const;
 
+protected:
+  ToolEntry*                  entry(int row) const;
+  int                         numberOf(int row) const;
+
 private:
-  QVector<ToolEntry*> tList;
-  static ToolEntry*   noTool;
+  mutable QVector<ToolEntry*> tList;      // entries of database get loaded on demand
+  QVector<int>                tNums;
+  QHash<int, int>             rowOfNum;
+  ToolDatabase*               db;
+  static ToolEntry*           noTool;
   };
 #endif // TOOLLISTMODEL_H
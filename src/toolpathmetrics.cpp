@@ -0,0 +1,210 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       toolpathmetrics.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "toolpathmetrics.h"
+#include "helixarc.h"
+#include "kuteCAM.h"
+#include "operation.h"
+#include "toolentry.h"
+#include "workstep.h"
+#include "wsarc.h"
+#include <cmath>
+
+
+const double ToolpathMetrics::DefaultRapidFeed = 5000;
+const char*  ToolpathMetrics::Names[] = { "moves", "retracts", "feedLength", "rapidLength", "airLength", "airTime", "cutTime", nullptr };
+
+
+ToolpathMetrics::ToolpathMetrics()
+ : moves(0)
+ , retracts(0)
+ , feedLength(0)
+ , rapidLength(0)
+ , airLength(0)
+ , airTime(0)
+ , cutTime(0) {
+  }
+
+
+static double arcLength(const WSArc* wa) {
+  HelixArc arc(wa->startPos(), wa->endPos(), wa->centerPos(), wa->isCCW());
+
+  if (arc.radius() < kute::MinDelta) return wa->startPos().Distance(wa->endPos());
+  return arc.length();
+  }
+
+
+// only increases beyond tolerance are regressions. Tolerances are
+// relative (0.01 == 1%), missing ones mean exact match.
+QStringList ToolpathMetrics::compare(const ToolpathMetrics& baseline, const QJsonObject& tolerances) const {
+  QStringList rv;
+
+  for (int i=0; Names[i]; ++i) {
+      QString key  = Names[i];
+      double  cur  = value(key);
+      double  base = baseline.value(key);
+      double  tol  = tolerances.value(key).toDouble(0);
+      double  max  = base + std::abs(base) * tol + kute::MinDelta;
+
+      if (cur > max)
+         rv << QString("%1: %2 > %3 (baseline %4, tolerance %5%)")
+                      .arg(key)
+                      .arg(cur, 0, 'f', 3)
+                      .arg(max, 0, 'f', 3)
+                      .arg(base, 0, 'f', 3)
+                      .arg(tol * 100);
+      }
+  return rv;
+  }
+
+
+QJsonObject ToolpathMetrics::defaultTolerances() {
+  QJsonObject rv;
+
+  rv["moves"]       = 0.02;
+  rv["retracts"]    = 0;
+  rv["feedLength"]  = 0.01;
+  rv["rapidLength"] = 0.02;
+  rv["airLength"]   = 0.02;
+  rv["airTime"]     = 0.02;
+  rv["cutTime"]     = 0.01;
+
+  return rv;
+  }
+
+
+// feed is calculated the same way as GCodeWriter does
+double ToolpathMetrics::feedOf(const Operation* op) {
+  ToolEntry* tool = op->toolEntry();
+
+  if (!tool || tool->fluteDiameter() <= 0) return 0;
+  double ss = op->speed() * 1000 / M_PI / tool->fluteDiameter();
+
+  return ss * tool->numFlutes() * op->feedPerTooth();
+  }
+
+
+ToolpathMetrics ToolpathMetrics::fromJson(const QJsonObject& jo) {
+  ToolpathMetrics rv;
+
+  rv.moves       = jo.value("moves").toInt();
+  rv.retracts    = jo.value("retracts").toInt();
+  rv.feedLength  = jo.value("feedLength").toDouble();
+  rv.rapidLength = jo.value("rapidLength").toDouble();
+  rv.airLength   = jo.value("airLength").toDouble();
+  rv.airTime     = jo.value("airTime").toDouble();
+  rv.cutTime     = jo.value("cutTime").toDouble();
+
+  return rv;
+  }
+
+
+ToolpathMetrics ToolpathMetrics::measure(const Operation* op, double stockTop, double rapidFeed) {
+  double          feed = feedOf(op);
+  ToolpathMetrics rv   = measure(op->workSteps(), feed, stockTop, rapidFeed);
+
+  // drill cycles: each hole gets drilled from upperZ to drillDepth
+  if (op->kind() == DrillOperation) {
+     for (Workstep* ws : op->workSteps()) {
+         if (ws->type() != WTCycle) continue;
+         double depth = std::abs(op->upperZ() - op->drillDepth());
+
+         rv.feedLength += depth;
+         if (feed > 0) rv.cutTime += depth / feed * 60;
+         }
+     }
+  return rv;
+  }
+
+
+ToolpathMetrics ToolpathMetrics::measure(const std::vector<Workstep*>& path, double feed, double stockTop, double rapidFeed) {
+  ToolpathMetrics rv;
+  gp_Pnt          lastCycle;
+  bool            seenCycle = false;
+
+  for (Workstep* ws : path) {
+      const gp_Pnt& from = ws->startPos();
+      const gp_Pnt& to   = ws->endPos();
+      double        len  = from.Distance(to);
+
+      ++rv.moves;
+      switch (ws->type()) {
+        case WTTraverse:
+             rv.rapidLength += len;
+             if (to.Z() > from.Z() + kute::MinDelta) ++rv.retracts;
+             break;
+        case WTArc:
+             len = arcLength(static_cast<WSArc*>(ws));
+             // fall through
+        case WTStraightMove: {
+             bool air = fmin(from.Z(), to.Z()) > stockTop + kute::MinDelta;
+
+             rv.feedLength += len;
+             if (air) rv.airLength += len;
+             if (feed > 0) {
+                if (air) rv.airTime += len / feed * 60;
+                else     rv.cutTime += len / feed * 60;
+                }
+             } break;
+        case WTCycle:                // positioning between holes is rapid
+             if (seenCycle) rv.rapidLength += std::hypot(from.X() - lastCycle.X(), from.Y() - lastCycle.Y());
+             lastCycle = from;
+             seenCycle = true;
+             ++rv.retracts;
+             break;
+        }
+      }
+  rv.airTime += rv.rapidLength / rapidFeed * 60;
+
+  return rv;
+  }
+
+
+QJsonObject ToolpathMetrics::toJson() const {
+  QJsonObject rv;
+
+  rv["moves"]       = moves;
+  rv["retracts"]    = retracts;
+  rv["feedLength"]  = feedLength;
+  rv["rapidLength"] = rapidLength;
+  rv["airLength"]   = airLength;
+  rv["airTime"]     = airTime;
+  rv["cutTime"]     = cutTime;
+
+  return rv;
+  }
+
+
+double ToolpathMetrics::value(const QString& key) const {
+  if (key == "moves")       return moves;
+  if (key == "retracts")    return retracts;
+  if (key == "feedLength")  return feedLength;
+  if (key == "rapidLength") return rapidLength;
+  if (key == "airLength")   return airLength;
+  if (key == "airTime")     return airTime;
+  if (key == "cutTime")     return cutTime;
+  return 0;
+  }
@@ -0,0 +1,67 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       toolpathmetrics.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef TOOLPATHMETRICS_H
+#define TOOLPATHMETRICS_H
+#include <QJsonObject>
+#include <QStringList>
+#include <vector>
+class Operation;
+class Workstep;
+
+
+// quality figures of a toolpath. Higher values are worse for all of
+// them, so a toolpath can be checked against a baseline. Air time is
+// an estimation: rapids plus feed moves, that stay above the stock.
+class ToolpathMetrics
+{
+public:
+  ToolpathMetrics();
+
+  QStringList compare(const ToolpathMetrics& baseline, const QJsonObject& tolerances) const;
+  QJsonObject toJson() const;
+
+  static ToolpathMetrics fromJson(const QJsonObject& jo);
+  static ToolpathMetrics measure(const Operation* op, double stockTop, double rapidFeed = DefaultRapidFeed);
+  static ToolpathMetrics measure(const std::vector<Workstep*>& path, double feed, double stockTop, double rapidFeed = DefaultRapidFeed);
+  static QJsonObject     defaultTolerances();
+  static double          feedOf(const Operation* op);
+
+  static const double DefaultRapidFeed;  // mm/min
+  static const char*  Names[];           // keys of json and tolerances
+
+  int    moves;
+  int    retracts;
+  double feedLength;     // mm
+  double rapidLength;    // mm
+  double airLength;      // mm, feed moves above stock
+  double airTime;        // seconds
+  double cutTime;        // seconds
+
+protected:
+  double value(const QString& key) const;
+  };
+#endif // TOOLPATHMETRICS_H
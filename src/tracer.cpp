@@ -0,0 +1,108 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       tracer.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "tracer.h"
+#include <QCoreApplication>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMutexLocker>
+#include <QDebug>
+#include <atomic>
+
+
+static int threadID() {
+  static std::atomic<int> nextID(1);
+  thread_local int        id = nextID++;
+
+  return id;
+  }
+
+
+Tracer::Tracer()
+ : fileName(qEnvironmentVariable("KUTECAM_TRACE"))
+ , enabled(!fileName.isEmpty()) {
+  clock.start();
+  if (enabled) events.reserve(100000);
+  }
+
+
+// trace gets written at program exit
+Tracer::~Tracer() {
+  write();
+  }
+
+
+Tracer& Tracer::instance() {
+  static Tracer tracer;
+
+  return tracer;
+  }
+
+
+void Tracer::record(const char* name, qint64 start, qint64 end) {
+  int          tid = threadID();
+  QMutexLocker lock(&mutex);
+
+  events.push_back({name, start, end - start, tid});
+  }
+
+
+bool Tracer::write() {
+  QMutexLocker lock(&mutex);
+
+  if (!enabled || events.empty()) return false;
+  QFile      file(fileName);
+  QJsonArray traceEvents;
+  qint64     pid = QCoreApplication::applicationPid();
+
+  if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+     qWarning() << "failed to write trace file" << fileName;
+     return false;
+     }
+  for (const Event& e : events) {
+      QJsonObject je;
+
+      je["name"] = e.name;
+      je["cat"]  = "kute";
+      je["ph"]   = "X";                // complete event
+      je["ts"]   = e.start / 1000.0;   // microseconds
+      je["dur"]  = e.duration / 1000.0;
+      je["pid"]  = pid;
+      je["tid"]  = e.tid;
+      traceEvents.append(je);
+      }
+  QJsonObject root;
+
+  root["traceEvents"]     = traceEvents;
+  root["displayTimeUnit"] = "ms";
+  file.write(QJsonDocument(root).toJson(QJsonDocument::Compact));
+  file.close();
+  events.clear();
+
+  return true;
+  }
@@ -0,0 +1,84 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       tracer.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef TRACER_H
+#define TRACER_H
+#include <QElapsedTimer>
+#include <QMutex>
+#include <QString>
+#include <vector>
+
+
+// collects timing spans and writes them as Chrome/Perfetto trace json
+// (load it with chrome://tracing or ui.perfetto.dev). Tracing is off,
+// unless environment variable KUTECAM_TRACE names the output file.
+// When off, a span costs just one check of a flag.
+class Tracer
+{
+public:
+  static Tracer& instance();
+
+  bool   isEnabled() const { return enabled; }
+  qint64 now() const       { return clock.nsecsElapsed(); }
+  void   record(const char* name, qint64 start, qint64 end);
+  bool   write();
+
+private:
+  Tracer();
+ ~Tracer();
+
+  struct Event {
+    const char* name;
+    qint64      start;
+    qint64      duration;
+    int         tid;
+    };
+  QString            fileName;
+  bool               enabled;
+  QElapsedTimer      clock;
+  QMutex             mutex;
+  std::vector<Event> events;
+  };
+
+
+// measures the scope it lives in. Name must be a string literal,
+// as only the pointer is kept.
+class TraceSpan
+{
+public:
+  explicit TraceSpan(const char* name)
+   : name(name)
+   , start(Tracer::instance().isEnabled() ? Tracer::instance().now() : -1) {
+    }
+ ~TraceSpan() {
+    if (start >= 0) Tracer::instance().record(name, start, Tracer::instance().now());
+    }
+
+private:
+  const char* name;
+  qint64      start;
+  };
+#endif // TRACER_H
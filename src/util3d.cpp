@@ -25,21 +25,23 @@
  * **************************************************************************
  */
 #include "util3d.h"
-#include "Geom_HelixData.h"
+#include "booleanengine.h"
+#include "edgechainer.h"
 #include "graphicobject.h"
 #include "gocircle.h"
 #include "gocontour.h"
 #include "goline.h"
 #include "gopocket.h"
+#include "helixarc.h"
 #include "kuteCAM.h"
+#include "meshslicer.h"
+#include "tracer.h"
 #include <BRepAdaptor_Surface.hxx>
-#include <BRepAlgoAPI_Section.hxx>
-#include <BOPAlgo_Splitter.hxx>
 #include <BRepBuilderAPI_MakeFace.hxx>
+#include <BRepBuilderAPI_MakePolygon.hxx>
 #include <BRepBuilderAPI_Transform.hxx>
 #include <BRepPrimAPI_MakeBox.hxx>
 #include <BRepPrimAPI_MakePrism.hxx>
-#include <BRepAlgoAPI_Splitter.hxx>
 #include <BRepBuilderAPI_MakeWire.hxx>
 #include <BRepBuilderAPI_MakeEdge.hxx>
 #include <BRep_Tool.hxx>
@@ -56,7 +58,6 @@
 #include <Geom_Plane.hxx>
 #include <Geom_Surface.hxx>
 #include <Geom_BSplineCurve.hxx>
-#include <ShapeAnalysis_FreeBounds.hxx>
 #include <STEPControl_Reader.hxx>
 #include <TopExp_Explorer.hxx>
 #include <TopExp.hxx>
@@ -64,7 +65,6 @@
 #include <TopoDS_Shape.hxx>
 #include <TopoDS_Vertex.hxx>
 #include <QString>
-#include <QVector3D>
 #include <QDebug>
 #include <cmath>
 
@@ -78,8 +78,10 @@ bool operator<(const gp_Pnt& l,
   }
 
 
+// wire of the chain that holds the first edge of shape
 TopoDS_Shape Util3D::allEdgesWithin(const TopoDS_Shape& shape, Handle(TopTools_HSequenceOfShape) v) {
-  TopoDS_Shape rv;
+  TopoDS_Shape             rv;
+  std::vector<TopoDS_Edge> edges;
 
   if (v.IsNull()) return rv;
 
@@ -88,16 +90,13 @@ TopoDS_Shape Util3D::allEdgesWithin(const TopoDS_Shape& shape, Handle(TopTools_H
 
       if (edge.IsNull()) continue;
       v->Append(edge);
+      edges.push_back(edge);
       }
-  ShapeAnalysis_FreeBounds          fb;
-  Handle(TopTools_HSequenceOfShape) wires;
+  EdgeChainer            chainer(kute::MinDelta);
+  std::vector<EdgeChain> chains = chainer.chain(edges);
 
-  fb.ConnectEdgesToWires(v, kute::MinDelta, false, wires);
+  if (chains.size()) rv = EdgeChainer::toWire(chains.front());
 
-  if (!wires.IsNull()) {
-     qDebug() << wires->Size();
-     if (wires->Size()) rv = wires->First();
-     }
   return rv;
   }
 
@@ -271,53 +270,23 @@ TopoDS_Edge Util3D::createArc(const gp_Pnt& from, const gp_Pnt& to, double radiu
   }
 
 
+// helices (start and end Z differ) get tessellated analytically into
+// a polyline. A real helix curve needs a B-spline fit, which is too
+// expensive for every ramp of a toolpath.
 Handle(AIS_Shape) Util3D::createArc(const gp_Pnt& from, const gp_Pnt& to, const gp_Pnt& center, bool ccw) {
   Handle(AIS_Shape) rv;
 
   if (!kute::isEqual(from.Z(), to.Z())
    || !kute::isEqual(from.Z(), center.Z())
    || !kute::isEqual(to.Z(), center.Z())) {
-     QVector3D start(from.X(), from.Y(), from.Z());
-     QVector3D end(to.X(), to.Y(), from.Z());
-     QVector3D c(center.X(), center.Y(), from.Z());
-     gp_Dir    hAxis(0, 0, ccw ? 1 : -1);
-     QVector3D s = start - c;
-     QVector3D e = end - c;
-
-     double r0 = s.length();
-     double a0 = atan2(s.y(), s.x());
-     double a1 = atan2(e.y(), e.x());
-
-     if (a0 < 0) a0 += 2 * M_PI;
-     if (a1 < 0) a1 += 2 * M_PI;
-     Handle(Geom_BSplineCurve) aHelix;
-     Geom_HelixData helDat;
-     gp_Ax3 pos(center, hAxis);
-     double arc        = ccw ? 2 * M_PI - abs(a1 - a0) : abs(a1 - a0);
-     double height     = to.Z() - from.Z();
-     double turnFactor = arc / (2.0 * M_PI);
-     double pitch      = (ccw ? 1 : -1) * height / turnFactor;
-
-     qDebug() << "U3D: create Helix from" << from.X() << " / " << from.Y() << " / " << from.Z()
-              << "   to   " << to.X() << " / " << to.Y() << " / " << to.Z()
-              << "   with center:" << center.X() << " / " << center.Y() << " / " << center.Z()
-              << "   and ccw ==" << (ccw ? "YES" : "NO");
-     qDebug() << "Helix - a0:" << a0 << "   a1:" << a1 << "   arc:" << arc;
-     helDat.setPosition(pos);
-     helDat.setRadius(r0);
-     helDat.setPitch(pitch);
-     helDat.setRangeMax(arc);
-     Handle(AIS_Shape) shape;
+     HelixArc                   helix(from, to, center, ccw);
+     std::vector<gp_Pnt>        points;
+     BRepBuilderAPI_MakePolygon poly;
 
-     if (helDat.MakeHelix(helDat, aHelix)) {
-        TopoDS_Shape ts = BRepBuilderAPI_MakeEdge(aHelix);
-        gp_Trsf rot;
+     helix.tessellate(Core().chordTolerance(), points);
+     for (const gp_Pnt& p : points) poly.Add(p);
+     if (poly.IsDone()) rv = new AIS_Shape(poly.Wire());
 
-        rot.SetRotation(pos.Axis(), ccw ? a0 : -(a0 + M_PI));
-        TopoDS_Shape rts = BRepBuilderAPI_Transform(ts, rot);
-
-        rv = new AIS_Shape(rts);
-        }
      return rv;
      }
   else {
@@ -365,26 +334,11 @@ Handle(AIS_Shape) Util3D::createLine(const gp_Pnt& from, const gp_Pnt& to) {
 
 
 Handle(AIS_Shape) Util3D::cut(const TopoDS_Shape& src, const TopoDS_Shape& tool) {
-  BOPAlgo_Splitter aSplitter;
-  // Setting arguments and tools
-  TopTools_ListOfShape aLO; // Objects
-  TopTools_ListOfShape aLT; // Tools
-
-  aLO.Append(src);
-  aLT.Append(tool);
-  aSplitter.SetArguments(aLO);
-  aSplitter.SetTools(aLT);
-
-  // Set options for the algorithm
-  // setting options for this algorithm is similar to setting options for GF algorithm (see "GF Usage" chapter)
+  TopoDS_Shape      parts = Core().booleanEngine()->split(src, tool);
   Handle(AIS_Shape) result;
 
-  // Perform the operation
-  aSplitter.Perform();
-  if (aSplitter.HasErrors()) { //check error status
-    return result;
-  }
-  result = new AIS_Shape(aSplitter.Shape());
+  if (parts.IsNull()) return result;
+  result = new AIS_Shape(parts);
   result->SetColor(Quantity_NOC_CYAN);
 
   return result;
@@ -553,26 +507,12 @@ Handle(AIS_Shape) Util3D::genWorkLine(const gp_Pnt& from, const gp_Pnt& to) {
 
 
 TopoDS_Shape Util3D::intersect(const TopoDS_Shape& src, const TopoDS_Shape& tool) {
-  Standard_Boolean     bRunParallel = Standard_True;
-  Standard_Real        aFuzzyValue  = 2.1e-5;
-  BRepAlgoAPI_Section  opCut;
-  TopTools_ListOfShape aLO;
-  TopTools_ListOfShape aLT;
-
-  aLO.Append(src);
-  aLT.Append(tool);
-  opCut.SetArguments(aLO);
-  opCut.SetTools(aLT);
-  opCut.SetNonDestructive(Standard_True);
-  opCut.SetCheckInverted(Standard_True);
-  opCut.SetUseOBB(Standard_True);
-  opCut.Build();
-
-  return opCut.Shape();
+  return Core().booleanEngine()->section(src, tool);
   }
 
 
 TopoDS_Shape Util3D::loadBRep(const QString& fileName) {
+  TraceSpan span("Util3D::loadBRep");
   BRep_Builder builder;
   TopoDS_Shape result;
 
@@ -583,6 +523,7 @@ TopoDS_Shape Util3D::loadBRep(const QString& fileName) {
 
 
 TopoDS_Shape Util3D::loadStep(const QString& fileName) {
+  TraceSpan span("Util3D::loadStep");
   STEPControl_Reader reader;
 
   reader.ReadFile(fileName.toStdString().c_str());
@@ -628,6 +569,44 @@ GraphicObject* Util3D::parseGraphicObject(const QString& s) {
   }
 
 
+// horizontal sections of shape at given levels. Default is to slice
+// a triangulation of the shape, which is cheap for many levels.
+// Exact B-rep sections are used, when requested (i.e. finishing)
+// or when configured as default.
+std::vector<TopoDS_Shape> Util3D::sections(const TopoDS_Shape& shape, const std::vector<double>& levels, bool exact) {
+  TraceSpan span("Util3D::sections");
+  std::vector<TopoDS_Shape> rv;
+
+  if (exact || Core().isExactSections()) {
+     for (double z : levels) {
+         gp_Pln                  pln({0, 0, z}, {0, 0, 1});
+         BRepBuilderAPI_MakeFace mf(pln, -500, 500, -500, 500);
+
+         rv.push_back(intersect(shape, mf.Shape()));
+         }
+     return rv;
+     }
+  MeshSlicer                              slicer(shape, Core().meshDeflection());
+  std::vector<std::vector<SlicePolyline>> polyLines = slicer.slice(levels);
+
+  qCDebug(lcPath) << "U3D: sliced" << levels.size() << "levels from"
+                  << slicer.triangleCount() << "triangles";
+  // mesh sections count nodes on the level as above, so a level
+  // right on a horizontal face yields nothing - take exact section
+  for (int i=0; i < (int)levels.size(); ++i) {
+      if (polyLines[i].size()) {
+         rv.push_back(slicer.toShape(polyLines[i]));
+         continue;
+         }
+      gp_Pln                  pln({0, 0, levels[i]}, {0, 0, 1});
+      BRepBuilderAPI_MakeFace mf(pln, -500, 500, -500, 500);
+
+      rv.push_back(intersect(shape, mf.Shape()));
+      }
+  return rv;
+  }
+
+
 GraphicObject* Util3D::toGraphicObject(TopoDS_Edge edge) {
   GraphicObject*     rv = nullptr;
   double             param0, param1;
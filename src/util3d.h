@@ -92,6 +92,7 @@ public:
   TopoDS_Shape                   makeCube(const gp_Pnt& p0, const gp_Pnt& p1);
   gp_Vec                         normalOfFace(const TopoDS_Shape& face);
   GraphicObject*                 parseGraphicObject(const QString& line);
+  std::vector<TopoDS_Shape>      sections(const TopoDS_Shape& shape, const std::vector<double>& levels, bool exact = false);
   GOContour*                     toContour(const std::vector<TopoDS_Edge>& segments);
   GraphicObject*                 toGraphicObject(TopoDS_Edge edge);
   };
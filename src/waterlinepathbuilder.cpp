@@ -0,0 +1,519 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       waterlinepathbuilder.cpp
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#include "waterlinepathbuilder.h"
+#include "core.h"
+#include "dropcutter.h"
+#include "kuteCAM.h"
+#include "operation.h"
+#include "pathbuilderutil.h"
+#include "toolentry.h"
+#include "tracer.h"
+#include "wsstraightmove.h"
+#include "wstraverse.h"
+#include <BRepBndLib.hxx>
+#include <BRepClass3d_SolidClassifier.hxx>
+#include <OSD_Parallel.hxx>
+#include <TopExp_Explorer.hxx>
+#include <TopoDS.hxx>
+#include <QDebug>
+#include <algorithm>
+#include <cmath>
+#include <unordered_map>
+
+
+static const double NoHeight     = -1e99;
+static const double MinWallAngle = 30;         // degrees, flatter areas don't limit Z step
+static const int    MaxLevels    = 10000;
+
+
+typedef WaterlinePathBuilder::Loop Loop;
+typedef WaterlinePathBuilder::Line Line;
+
+
+// tip height of cutter on grid nodes. Nodes without contact
+// get NoHeight, so the outer ring of the grid is always free.
+struct HeightField
+{
+  double              x0;
+  double              y0;
+  double              g;
+  int                 nx;
+  int                 ny;
+  std::vector<double> h;
+
+  double at(int i, int j) const { return h[j * nx + i]; }
+  double x(int i) const         { return x0 + i * g; }
+  double y(int j) const         { return y0 + j * g; }
+  };
+
+
+// grid edges are numbered, so iso line segments of neighboring
+// cells share their end points exactly.
+class IsoLevel
+{
+public:
+  IsoLevel(const HeightField& hf, const DropCutter& dc, double z, double allowance, double tolerance)
+   : hf(hf)
+   , dc(dc)
+   , z(z)
+   , allowance(allowance)
+   , tolerance(tolerance) {
+    }
+
+  std::vector<Loop> loops() {
+    std::vector<std::pair<long long, long long>> segments;
+
+    for (int j=0; j < hf.ny - 1; ++j)
+        for (int i=0; i < hf.nx - 1; ++i)
+            addCell(i, j, segments);
+    return chain(segments);
+    }
+
+protected:
+  long long hEdge(int i, int j) const { return 2LL * (j * (long long)hf.nx + i); }
+  long long vEdge(int i, int j) const { return 2LL * (j * (long long)hf.nx + i) + 1; }
+
+  // material (cutter would be below its contact) on the right
+  void addCell(int i, int j, std::vector<std::pair<long long, long long>>& segments) {
+    bool in[4] = { hf.at(i, j)         >= z
+                 , hf.at(i + 1, j)     >= z
+                 , hf.at(i + 1, j + 1) >= z
+                 , hf.at(i, j + 1)     >= z };
+    if (in[0] == in[1] && in[1] == in[2] && in[2] == in[3]) return;
+    long long e[4] = { hEdge(i, j), vEdge(i + 1, j), hEdge(i, j + 1), vEdge(i, j) };
+    gp_Pnt    c[4] = { gp_Pnt(hf.x(i), hf.y(j), 0), gp_Pnt(hf.x(i + 1), hf.y(j), 0)
+                     , gp_Pnt(hf.x(i + 1), hf.y(j + 1), 0), gp_Pnt(hf.x(i), hf.y(j + 1), 0) };
+    std::vector<std::pair<int, int>> cuts;
+
+    if (in[0] != in[1] && in[1] != in[2] && in[2] != in[3]) {   // saddle
+       double center = (hf.at(i, j) + hf.at(i + 1, j) + hf.at(i + 1, j + 1) + hf.at(i, j + 1)) / 4;
+
+       if (in[0] == (center >= z)) {
+          cuts.emplace_back(0, 1);
+          cuts.emplace_back(2, 3);
+          }
+       else {
+          cuts.emplace_back(3, 0);
+          cuts.emplace_back(1, 2);
+          }
+       }
+    else {
+       int crossed[2], n = 0;
+
+       for (int k=0; k < 4; ++k)
+           if (in[k] != in[(k + 1) % 4] && n < 2) crossed[n++] = k;
+       cuts.emplace_back(crossed[0], crossed[1]);
+       }
+    for (auto& cut : cuts) {
+        const gp_Pnt& p = point(e[cut.first],  i, j, cut.first);
+        const gp_Pnt& q = point(e[cut.second], i, j, cut.second);
+        double        mx = (p.X() + q.X()) / 2;
+        double        my = (p.Y() + q.Y()) / 2;
+        int           nearest = 0;
+
+        for (int k=1; k < 4; ++k)
+            if (std::hypot(c[k].X() - mx, c[k].Y() - my) < std::hypot(c[nearest].X() - mx, c[nearest].Y() - my))
+               nearest = k;
+        double cross = (q.X() - p.X()) * (c[nearest].Y() - p.Y()) - (q.Y() - p.Y()) * (c[nearest].X() - p.X());
+
+        // inside corner has to be on the right (negative cross product)
+        if ((cross < 0) == in[nearest]) segments.emplace_back(e[cut.first], e[cut.second]);
+        else                            segments.emplace_back(e[cut.second], e[cut.first]);
+        }
+    }
+
+  std::vector<Loop> chain(const std::vector<std::pair<long long, long long>>& segments) const {
+    std::unordered_map<long long, int> startOf;
+    std::vector<bool>                  used(segments.size(), false);
+    std::vector<Loop>                  rv;
+
+    for (int s=0; s < (int)segments.size(); ++s) startOf[segments[s].first] = s;
+    for (int s=0; s < (int)segments.size(); ++s) {
+        if (used[s]) continue;
+        Loop loop;
+        int  cur = s;
+
+        while (cur >= 0 && !used[cur]) {
+              used[cur] = true;
+              loop.push_back(cache.at(segments[cur].first));
+              auto it = startOf.find(segments[cur].second);
+
+              cur = it == startOf.end() ? -1 : it->second;
+              }
+        if (loop.size() > 2) rv.push_back(loop);
+        }
+    return rv;
+    }
+
+  // crossing of iso level on grid edge, refined by drops (false position)
+  const gp_Pnt& point(long long id, int i, int j, int side) {
+    auto it = cache.find(id);
+
+    if (it != cache.end()) return it->second;
+    int ai = i, aj = j, bi = i, bj = j;
+
+    switch (side) {
+      case 0: bi = i + 1; break;
+      case 1: ai = bi = i + 1; bj = j + 1; break;
+      case 2: aj = bj = j + 1; bi = i + 1; break;
+      default: bj = j + 1; break;
+      }
+    double ha = hf.at(ai, aj);
+    double hb = hf.at(bi, bj);
+
+    if (ha < z) {                       // a is inside
+       std::swap(ai, bi); std::swap(aj, bj); std::swap(ha, hb);
+       }
+    double lo = 0, hi = 1, t = 0.5, tip;
+    double hLo = ha, hHi = hb;
+
+    for (int n=0; n < 6; ++n) {
+        t = hHi > NoHeight ? lo + (hi - lo) * (hLo - z) / (hLo - hHi) : (lo + hi) / 2;
+        double x  = hf.x(ai) + t * (hf.x(bi) - hf.x(ai));
+        double y  = hf.y(aj) + t * (hf.y(bj) - hf.y(aj));
+        double hm = dc.drop(x, y, tip) ? tip + allowance : NoHeight;
+
+        if (std::abs(hm - z) < tolerance || (hi - lo) * hf.g < tolerance) break;
+        if (hm >= z) {
+           lo  = t;
+           hLo = hm;
+           }
+        else {
+           hi  = t;
+           hHi = hm;
+           }
+        }
+    gp_Pnt p(hf.x(ai) + t * (hf.x(bi) - hf.x(ai)), hf.y(aj) + t * (hf.y(bj) - hf.y(aj)), z);
+
+    return cache.emplace(id, p).first->second;
+    }
+
+private:
+  const HeightField&                    hf;
+  const DropCutter&                     dc;
+  double                                z;
+  double                                allowance;
+  double                                tolerance;
+  std::unordered_map<long long, gp_Pnt> cache;
+  };
+
+
+// drop points of closed loop that deviate less than tolerance
+// from the line between their neighbors
+static void reduce(Loop& loop, double tolerance) {
+  if (loop.size() < 4) return;
+  Loop res;
+  int  mx = loop.size();
+
+  res.push_back(loop.front());
+  for (int i=1; i < mx; ++i) {
+      const gp_Pnt& a  = res.back();
+      const gp_Pnt& b  = i + 1 < mx ? loop[i + 1] : loop.front();
+      double        dx = b.X() - a.X();
+      double        dy = b.Y() - a.Y();
+      double        l  = std::sqrt(dx * dx + dy * dy);
+
+      if (l > tolerance && std::abs((loop[i].X() - a.X()) * dy - (loop[i].Y() - a.Y()) * dx) / l < tolerance)
+         continue;
+      res.push_back(loop[i]);
+      }
+  loop.swap(res);
+  }
+
+
+WaterlinePathBuilder::WaterlinePathBuilder(PathBuilderUtil* pbu)
+ : pbu(pbu) {
+  }
+
+
+// keep the parts of each line, where the tip stays inside of area
+void WaterlinePathBuilder::clip(std::vector<Line>& lines, const TopoDS_Shape& area) const {
+  std::vector<BRepClass3d_SolidClassifier*> solids;
+  std::vector<Line>                         rv;
+  Bnd_Box                                   bb;
+  double                                    tolerance = Core().chordTolerance();
+  auto                                      inside    = [&](const gp_Pnt& p) {
+    if (bb.IsOut(p)) return false;
+    for (auto sc : solids) {
+        sc->Perform(p, tolerance);
+        if (sc->State() == TopAbs_IN || sc->State() == TopAbs_ON) return true;
+        }
+    return false;
+    };
+
+  BRepBndLib::Add(area, bb);
+  bb.Enlarge(tolerance);
+  for (TopExp_Explorer ex(area, TopAbs_SOLID); ex.More(); ex.Next())
+      solids.push_back(new BRepClass3d_SolidClassifier(TopoDS::Solid(ex.Current())));
+
+  for (Line& line : lines) {
+      int               mx = line.points.size();
+      std::vector<bool> in(mx);
+      int               first = -1;
+
+      for (int i=0; i < mx; ++i) {
+          in[i] = inside(line.points[i]);
+          if (!in[i] && first < 0) first = i;
+          }
+      if (first < 0) {
+         rv.push_back(line);
+         continue;
+         }
+      Line chain;
+
+      chain.closed = false;
+      for (int n=1; n <= mx; ++n) {
+          int i = (first + n) % mx;
+
+          if (in[i]) {
+             chain.points.push_back(line.points[i]);
+             continue;
+             }
+          if (chain.points.size() > 1) rv.push_back(chain);
+          chain.points.clear();
+          }
+      }
+  for (auto sc : solids) delete sc;
+  lines.swap(rv);
+  }
+
+
+std::vector<Workstep*> WaterlinePathBuilder::genFinishingPath(Operation* op, const TopoDS_Shape& part, double zTop, double zBottom, const TopoDS_Shape& area) {
+  TraceSpan              span("WaterlinePathBuilder::genFinishingPath");
+  std::vector<Workstep*> toolPath;
+  CutterShape            cutter;
+  double                 tolerance = Core().chordTolerance();
+  double                 scallop   = Core().scallopHeight();
+  double                 allowance = op->offset();
+  double                 cornerR;
+
+  if (!area.IsNull()) {
+     Bnd_Box ab;
+
+     BRepBndLib::Add(area, ab);
+     if (ab.IsVoid()) return toolPath;
+     zTop    = std::min(zTop,    ab.CornerMax().Z());
+     zBottom = std::max(zBottom, ab.CornerMin().Z());
+     }
+  if (part.IsNull() || zTop <= zBottom) return toolPath;
+  if (!CutterShape::fromTool(op->toolEntry(), cutter)) {
+     qCWarning(lcPath) << "waterline finishing: tool of operation" << op->name()
+                       << "is neither flat, bull nose nor ball nose mill";
+     return toolPath;
+     }
+  cornerR              = cutter.cornerRadius;
+  cutter.radius       += allowance;
+  cutter.cornerRadius  = std::max(0.0, cutter.cornerRadius + allowance);
+  DropCutter     dc(part, cutter, tolerance / 2);
+  const Bnd_Box& bb = dc.bounds();
+
+  if (bb.IsVoid()) return toolPath;
+
+  // height field over part, grown by cutter, so outer nodes miss
+  HeightField hf;
+  double      r = cutter.radius;
+
+  hf.g = std::max(0.05, std::min(2.0, r / 4));
+  while ((bb.CornerMax().X() - bb.CornerMin().X() + 2 * r) * (bb.CornerMax().Y() - bb.CornerMin().Y() + 2 * r)
+         / (hf.g * hf.g) > 1e6) hf.g *= 1.5;
+  hf.x0 = bb.CornerMin().X() - r - 2 * hf.g;
+  hf.y0 = bb.CornerMin().Y() - r - 2 * hf.g;
+  hf.nx = std::ceil((bb.CornerMax().X() + r + 2 * hf.g - hf.x0) / hf.g) + 1;
+  hf.ny = std::ceil((bb.CornerMax().Y() + r + 2 * hf.g - hf.y0) / hf.g) + 1;
+  hf.h.resize(hf.nx * hf.ny);
+  OSD_Parallel::For(0, hf.ny, [&](int j) {
+    double tip;
+
+    for (int i=0; i < hf.nx; ++i)
+        hf.h[j * hf.nx + i] = dc.drop(hf.x(i), hf.y(j), tip) ? tip + allowance : NoHeight;
+    });
+
+  // Z step limit by slope of walls. Scallop of a corner radius on a
+  // wall of slope a is (dz / sin a)^2 / 8r, flat end mills leave
+  // terraces of dz * cos a.
+  double              dzMax   = op->cutDepth() > 0 ? op->cutDepth() : r;
+  double              dzMin   = std::max(0.01, std::min(scallop, dzMax));
+  int                 nBins   = std::ceil((zTop - zBottom) / dzMin) + 1;
+  std::vector<double> limit(nBins, dzMax);
+  double              minTan  = std::tan(kute::deg2rad(MinWallAngle));
+
+  for (int j=0; j < hf.ny - 1; ++j) {
+      for (int i=0; i < hf.nx - 1; ++i) {
+          double h[4] = { hf.at(i, j), hf.at(i + 1, j), hf.at(i + 1, j + 1), hf.at(i, j + 1) };
+
+          if (*std::min_element(h, h + 4) <= NoHeight) continue;
+          double gx = (h[1] - h[0] + h[2] - h[3]) / (2 * hf.g);
+          double gy = (h[3] - h[0] + h[2] - h[1]) / (2 * hf.g);
+          double slope = std::hypot(gx, gy);
+
+          if (slope < minTan) continue;
+          double a  = std::atan(slope);
+          double dz = cornerR > 0 ? std::sin(a) * std::sqrt(8 * cornerR * scallop)
+                                  : scallop / std::max(std::cos(a), 1e-6);
+          int    b0 = std::max(0,         (int)std::floor((*std::min_element(h, h + 4) - zBottom) / dzMin));
+          int    b1 = std::min(nBins - 1, (int)std::floor((*std::max_element(h, h + 4) - zBottom) / dzMin));
+
+          for (int b=b0; b <= b1; ++b) limit[b] = std::min(limit[b], dz);
+          }
+      }
+  std::vector<double> levels;
+
+  for (double z = zTop; z > zBottom + kute::MinDelta && (int)levels.size() < MaxLevels; ) {
+      int    b1 = std::min(nBins - 1, (int)std::floor((z - zBottom) / dzMin));
+      int    b0 = std::max(0,         (int)std::floor((z - dzMax - zBottom) / dzMin));
+      double dz = dzMax;
+
+      for (int b=b0; b <= b1; ++b) dz = std::min(dz, limit[b]);
+      z = std::max(zBottom, z - std::max(dz, dzMin));
+      levels.push_back(z);
+      }
+
+  // waterlines of all levels in parallel
+  std::vector<std::vector<Line>> lines(levels.size());
+  bool                           conventional = op->direction() == 1;
+
+  OSD_Parallel::For(0, levels.size(), [&](int l) {
+    IsoLevel iso(hf, dc, levels[l], allowance, tolerance);
+
+    for (auto& loop : iso.loops()) {
+        Line line;
+
+        reduce(loop, tolerance);
+        if (conventional) std::reverse(loop.begin(), loop.end());
+        line.points.swap(loop);
+        lines[l].push_back(line);
+        }
+    });
+  if (!area.IsNull()) for (auto& level : lines) clip(level, area);
+
+  // link loops level by level, next loop is the nearest one
+  double safeZ = bb.CornerMax().Z() + allowance + op->safeZ1();
+  gp_Pnt e(hf.x0, hf.y0, safeZ);
+  bool   down  = false;
+  int    links = 0, lifts = 0;
+
+  for (auto& level : lines) {
+      std::vector<bool> done(level.size(), false);
+
+      for (size_t n=0; n < level.size(); ++n) {
+          int    best = -1, bestI = 0;
+          double bestD = 1e99;
+
+          for (size_t k=0; k < level.size(); ++k) {
+              if (done[k]) continue;
+              // open chains have to start at their begin
+              size_t mxI = level[k].closed ? level[k].points.size() : 1;
+
+              for (size_t i=0; i < mxI; ++i) {
+                  double d = std::hypot(level[k].points[i].X() - e.X(), level[k].points[i].Y() - e.Y());
+
+                  if (d < bestD) {
+                     bestD = d;
+                     best  = k;
+                     bestI = i;
+                     }
+                  }
+              }
+          if (best < 0) break;
+          done[best] = true;
+          Loop& loop = level[best].points;
+
+          if (level[best].closed) {
+             std::rotate(loop.begin(), loop.begin() + bestI, loop.end());
+             loop.push_back(loop.front());
+             }
+          const gp_Pnt& s = loop.front();
+
+          if (down && std::hypot(s.X() - e.X(), s.Y() - e.Y()) <= 2 * r
+                   && isFree(dc, e, s, hf.g, allowance, tolerance)) {
+             toolPath.push_back(new WSStraightMove(e, s));
+             ++links;
+             }
+          else {
+             double liftZ = safeZ;
+
+             if (down) {
+                liftZ = std::min(safeZ, maxHeight(dc, e, s, hf.g, allowance) + op->safeZ0());
+                liftZ = std::max(liftZ, std::max(e.Z(), s.Z()) + op->safeZ0());
+                ++lifts;
+                }
+             gp_Pnt up(e.X(), e.Y(), liftZ);
+             gp_Pnt over(s.X(), s.Y(), liftZ);
+
+             if (!kute::isEqual(e, up))    toolPath.push_back(new WSTraverse(e, up));
+             if (!kute::isEqual(up, over)) toolPath.push_back(new WSTraverse(up, over));
+             toolPath.push_back(new WSStraightMove(over, s));
+             }
+          down = true;
+          e    = s;
+          for (size_t i=1; i < loop.size(); ++i) {
+              toolPath.push_back(new WSStraightMove(e, loop[i]));
+              e = loop[i];
+              }
+          }
+      }
+  if (down) toolPath.push_back(new WSTraverse(e, gp_Pnt(e.X(), e.Y(), safeZ)));
+  pbu->cleanup(toolPath);
+  qCDebug(lcPath) << "waterline finishing:" << levels.size() << "levels," << hf.nx * hf.ny
+                  << "grid nodes," << links << "links," << lifts << "lifts";
+
+  return toolPath;
+  }
+
+
+// straight move between two points does not touch the part
+bool WaterlinePathBuilder::isFree(const DropCutter& dc, const gp_Pnt& from, const gp_Pnt& to, double step, double allowance, double tolerance) const {
+  double dist = std::hypot(to.X() - from.X(), to.Y() - from.Y());
+  int    n    = std::max(1, (int)std::ceil(dist / step));
+  double tip;
+
+  for (int i=1; i < n; ++i) {
+      double x = from.X() + (to.X() - from.X()) * i / n;
+      double y = from.Y() + (to.Y() - from.Y()) * i / n;
+      double z = from.Z() + (to.Z() - from.Z()) * i / n;
+
+      if (dc.drop(x, y, tip) && tip + allowance > z + tolerance) return false;
+      }
+  return true;
+  }
+
+
+// highest tip position of cutter on the way between two points
+double WaterlinePathBuilder::maxHeight(const DropCutter& dc, const gp_Pnt& from, const gp_Pnt& to, double step, double allowance) const {
+  double dist = std::hypot(to.X() - from.X(), to.Y() - from.Y());
+  int    n    = std::max(1, (int)std::ceil(dist / step));
+  double rv   = NoHeight;
+  double tip;
+
+  for (int i=0; i <= n; ++i) {
+      double x = from.X() + (to.X() - from.X()) * i / n;
+      double y = from.Y() + (to.Y() - from.Y()) * i / n;
+
+      if (dc.drop(x, y, tip)) rv = std::max(rv, tip + allowance);
+      }
+  return rv;
+  }
@@ -0,0 +1,67 @@
+/*
+ * **************************************************************************
+ *
+ *  file:       waterlinepathbuilder.h
+ *  project:    kuteCAM
+ *  subproject: main application
+ *  purpose:    create a graphical application, that assists in identify
+ *              and process model elements
+ *  created:    19.10.2026 by Django Reinhard
+ *  copyright:  (c) 2022 Django Reinhard -  all rights reserved
+ *
+ *  This program is free software: you can redistribute it and/or modify
+ *  it under the terms of the GNU General Public License as published by
+ *  the Free Software Foundation, either version 2 of the License, or
+ *  (at your option) any later version.
+ *
+ *  This program is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ *  GNU General Public License for more details.
+ *
+ *  You should have received a copy of the GNU General Public License
+ *  along with this program.  If not, see <https://www.gnu.org/licenses/>.
+ *
+ * **************************************************************************
+ */
+#ifndef WATERLINEPATHBUILDER_H
+#define WATERLINEPATHBUILDER_H
+#include <TopoDS_Shape.hxx>
+#include <gp_Pnt.hxx>
+#include <vector>
+class DropCutter;
+class Operation;
+class PathBuilderUtil;
+class Workstep;
+
+
+// constant Z finishing of steep walls. The cutter gets dropped onto
+// a grid over the part once. Each waterline is the iso line of that
+// height field at the level, refined by further drops, so it is
+// compensated by the real cutter profile. Z step follows the wall
+// slope so that scallops stay below configured scallop height.
+// Cutter contacts the whole part, but waterlines may be limited to
+// an area (i.e. cut part of a target). Loops leaving that area get
+// split into open chains.
+class WaterlinePathBuilder
+{
+public:
+  WaterlinePathBuilder(PathBuilderUtil* pbu);
+
+  std::vector<Workstep*> genFinishingPath(Operation* op, const TopoDS_Shape& part, double zTop, double zBottom, const TopoDS_Shape& area = TopoDS_Shape());
+
+  typedef std::vector<gp_Pnt> Loop;
+  struct Line {
+    Loop points;
+    bool closed = true;
+    };
+
+protected:
+  void   clip(std::vector<Line>& lines, const TopoDS_Shape& area) const;
+  bool   isFree(const DropCutter& dc, const gp_Pnt& from, const gp_Pnt& to, double step, double allowance, double tolerance) const;
+  double maxHeight(const DropCutter& dc, const gp_Pnt& from, const gp_Pnt& to, double step, double allowance) const;
+
+private:
+  PathBuilderUtil* pbu;
+  };
+#endif // WATERLINEPATHBUILDER_H
@@ -27,8 +27,8 @@
 #include "xmltoolreader.h"
 #include "toolentry.h"
 #include "cuttingparameters.h"
-#include <QDomDocument>
 #include <QIODevice>
+#include <QXmlStreamReader>
 #include <QDebug>
 static const bool debug = false;
 
@@ -38,162 +38,110 @@ XmlToolReader::XmlToolReader(QObject *parent)
   }
 
 
-void XmlToolReader::processDoc(const QDomDocument& doc, QVector<ToolEntry*>& tools) {
-  ToolEntry*          tool;
-  QDomNodeList        xTools = doc.elementsByTagName("ToolDefinition");
-
-  for (int i=0; i < xTools.count(); ++i) {
-      QDomNode xt = xTools.item(i);
-
-      if (xt.isElement()) {
-         tool = new ToolEntry();
-         readElement(tool, xt.toElement());
-         tools.append(tool);
-         }
-      }
-  }
-
-
-void XmlToolReader::processText(CuttingParameters* cp, const QDomNode& n) {
-  if (!cp) return;
-  const QString& rawData = n.toText().data();
-  bool           ok;
-  double         value = rawData.toDouble(&ok);
-  const QString& name  = n.parentNode().nodeName();
-
-  if (debug) {
-     if (ok) qDebug() << "\tcolumn value:" << value;
-     else    qDebug() << "\tcolumn value:" << rawData;
-     }
-  if (name == "Material")   cp->setName(rawData);
-  else if (name == "Speed") cp->setCuttingSpeed(value);
-  else if (name == "Feed")  cp->setToothFeed(value);
-  else if (name == "Width") cp->setWidthOfCut(value);
-  else if (name == "Depth") cp->setDepthOfCut(value);
-  }
-
-
-void XmlToolReader::processText(ToolEntry* t, const QDomNode& n) {
-  if (!t) return;
-  const QString& rawData = n.toText().data();
-  bool           ok;
-  double         value = rawData.toDouble(&ok);
-  const QString& name  = n.parentNode().nodeName();
+// tool definitions may be nested anywhere in the document. A broken
+// document yields no tools at all, same as a failed parse did before.
+QVector<ToolEntry*> XmlToolReader::process(QXmlStreamReader& xml) {
+  QVector<ToolEntry*> tools;
 
-  if (debug) {
-     if (ok) qDebug() << "\tcolumn value:" << value;
-     else    qDebug() << "\tcolumn value:" << rawData;
+  while (!xml.atEnd()) {
+        if (xml.readNext() == QXmlStreamReader::StartElement
+         && xml.name() == QLatin1String("ToolDefinition"))
+           tools.append(readTool(xml));
+        }
+  if (xml.hasError()) {
+     qWarning() << "failed to read tool library - line" << xml.lineNumber()
+                << "column" << xml.columnNumber() << ":" << xml.errorString();
+     qDeleteAll(tools);
+     tools.clear();
      }
-  if (name      == "Name")          t->setToolName(rawData);
-  else if (name == "Collet")        t->setCollet(value);
-  else if (name == "TipDiameter")   t->setTipDiameter(value);
-  else if (name == "FluteDiameter") t->setFluteDiameter(value);
-  else if (name == "FluteLength")   t->setFluteLength(value);
-  else if (name == "Flutes")        t->setNumFlutes(value);
-  else if (name == "CuttingDepth")  t->setCuttingDepth(value);
-  else if (name == "CuttingAngle")  t->setCuttingAngle(value);
-  else if (name == "ShankDiameter") t->setShankDiameter(value);
-  else if (name == "FreeLength")    t->setFreeLength(value);
+  return tools;
   }
 
 
 QVector<ToolEntry*> XmlToolReader::read(QIODevice* io) {
-  QDomDocument doc;
+  if (!io->isOpen() && !io->open(QIODevice::ReadOnly)) return QVector<ToolEntry*>();
+  QXmlStreamReader    xml(io);
+  QVector<ToolEntry*> tools = process(xml);
 
-  doc.setContent(io);
   io->close();
-  QVector<ToolEntry*> tools;
-
-  processDoc(doc, tools);
 
   return tools;
   }
 
 
 QVector<ToolEntry*> XmlToolReader::read(const QByteArray& ba) {
-  QDomDocument doc;
-
-  doc.setContent(ba);
-  QVector<ToolEntry*> tools;
-
-  processDoc(doc, tools);
-
-  return tools;
-  }
-
+  QXmlStreamReader xml(ba);
 
-void XmlToolReader::readAttribute(ToolEntry* t, CuttingParameters* cp, const QDomAttr& a) {
-  if (debug) qDebug() << "Attribute: " << a.name() << "has value:" << a.value();
-
-  if (a.name() == "num") {
-     t->insertCuttingParameters(a.value().toInt(), cp);
-     }
+  return process(xml);
   }
 
 
-void XmlToolReader::readAttribute(ToolEntry* t, const QDomAttr& a) {
-  if (debug) qDebug() << "Attribute: " << a.name() << "has value:" << a.value();
-
-  if (a.name() == "Number") t->setToolNumber(a.value().toInt());
-  }
+// parameters without row number have no place in the tool
+void XmlToolReader::readCuttingParameters(QXmlStreamReader& xml, ToolEntry* t) {
+  CuttingParameters*   cp    = new CuttingParameters();
+  QXmlStreamAttributes attrs = xml.attributes();
 
+  if (debug) qDebug() << "Element: CuttingParameters - num:" << attrs.value("num");
 
-void XmlToolReader::readAttributes(ToolEntry *t, const QDomNamedNodeMap &attrs) {
-  int mx = attrs.count();
+  while (xml.readNextStartElement()) readProperty(xml, cp);
 
-  for (int i=0; i < mx; ++i) {
-      QDomNode n = attrs.item(i);
-
-      if (n.isAttr()) readAttribute(t, n.toAttr());
-      }
+  if (attrs.hasAttribute("num")) t->insertCuttingParameters(attrs.value("num").toInt(), cp);
+  else                           delete cp;
   }
 
 
-void XmlToolReader::readAttributes(ToolEntry *t, CuttingParameters* cp, const QDomNamedNodeMap &attrs) {
-  int mx = attrs.count();
-
-  for (int i=0; i < mx; ++i) {
-      QDomNode n = attrs.item(i);
+void XmlToolReader::readProperty(QXmlStreamReader& xml, CuttingParameters* cp) {
+  const QString name    = xml.name().toString();
+  const QString rawData = xml.readElementText(QXmlStreamReader::SkipChildElements);
+  bool          ok;
+  double        value   = rawData.toDouble(&ok);
 
-      if (n.isAttr()) readAttribute(t, cp, n.toAttr());
-      }
+  if (debug) {
+     if (ok) qDebug() << "\t" << name << "value:" << value;
+     else    qDebug() << "\t" << name << "value:" << rawData;
+     }
+  if (name == "Material")   cp->setName(rawData);
+  else if (name == "Speed") cp->setCuttingSpeed(value);
+  else if (name == "Feed")  cp->setToothFeed(value);
+  else if (name == "Width") cp->setWidthOfCut(value);
+  else if (name == "Depth") cp->setDepthOfCut(value);
   }
 
 
-void XmlToolReader::readElement(ToolEntry* t, CuttingParameters* cp, const QDomElement& e) {
-  if (debug) qDebug() << "Element: " << e.tagName() << " - parent:" << e.parentNode().nodeName();
+void XmlToolReader::readProperty(QXmlStreamReader& xml, ToolEntry* t) {
+  const QString name    = xml.name().toString();
+  const QString rawData = xml.readElementText(QXmlStreamReader::SkipChildElements);
+  bool          ok;
+  double        value   = rawData.toDouble(&ok);
 
-  if (e.hasAttributes()) readAttributes(t, cp, e.attributes());
-  for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling()) {
-      if (n.isAttr()) readAttribute(t, cp, n.toAttr());
-      else if (n.isText()) processText(cp, n);
-      else if (n.isElement()) readElement(t, cp, n.toElement());
-      else {
-         if (debug) qDebug() << "Element of unknown type!";
-         }
-      }
+  if (debug) {
+     if (ok) qDebug() << "\t" << name << "value:" << value;
+     else    qDebug() << "\t" << name << "value:" << rawData;
+     }
+  if (name      == "Name")          t->setToolName(rawData);
+  else if (name == "Collet")        t->setCollet(value);
+  else if (name == "TipDiameter")   t->setTipDiameter(value);
+  else if (name == "FluteDiameter") t->setFluteDiameter(value);
+  else if (name == "FluteLength")   t->setFluteLength(value);
+  else if (name == "Flutes")        t->setNumFlutes(value);
+  else if (name == "CuttingDepth")  t->setCuttingDepth(value);
+  else if (name == "CuttingAngle")  t->setCuttingAngle(value);
+  else if (name == "ShankDiameter") t->setShankDiameter(value);
+  else if (name == "FreeLength")    t->setFreeLength(value);
   }
 
 
-void XmlToolReader::readElement(ToolEntry* t, const QDomElement& e) {
-  if (debug) qDebug() << "Element: " << e.tagName() << " - parent:" << e.parentNode().nodeName();
-
-  if (e.hasAttributes()) readAttributes(t, e.attributes());
-  for (QDomNode n = e.firstChild(); !n.isNull(); n = n.nextSibling()) {
-      if (n.isAttr()) readAttribute(t, n.toAttr());
-      else if (n.isText()) processText(t, n);
-      else if (n.isElement()) {
-         if (debug) qDebug() << "node name:" << n.nodeName();
+// consumes the tool definition up to its end element
+ToolEntry* XmlToolReader::readTool(QXmlStreamReader& xml) {
+  ToolEntry*           t     = new ToolEntry();
+  QXmlStreamAttributes attrs = xml.attributes();
 
-         if (n.nodeName() == "CuttingParameters") {
-            CuttingParameters* cp = new CuttingParameters();
+  if (attrs.hasAttribute("Number")) t->setToolNumber(attrs.value("Number").toInt());
+  if (debug) qDebug() << "Element: ToolDefinition - Number:" << attrs.value("Number");
 
-            readElement(t, cp, n.toElement());
-            }
-         else readElement(t, n.toElement());
-         }
-      else {
-         if (debug) qDebug() << "Element of unknown type!";
-         }
-      }
+  while (xml.readNextStartElement()) {
+        if (xml.name() == QLatin1String("CuttingParameters")) readCuttingParameters(xml, t);
+        else                                                  readProperty(xml, t);
+        }
+  return t;
   }
@@ -28,15 +28,14 @@
 #define XMLTOOLREADER_H
 #include <QObject>
 class QIODevice;
-class QDomAttr;
-class QDomDocument;
-class QDomElement;
-class QDomNamedNodeMap;
-class QDomNode;
+class QXmlStreamReader;
 class CuttingParameters;
 class ToolEntry;
 
 
+// reads tool libraries in a single forward pass. Only the tool
+// under construction is held besides the result, so memory does
+// not grow with the size of the document.
 class XmlToolReader : public QObject
 {
   Q_OBJECT
@@ -47,14 +46,10 @@ public:
   QVector<ToolEntry*> read(const QByteArray& ba);
 
 protected:
-  void processDoc(const QDomDocument& doc, QVector<ToolEntry*>& tools);
-  void processText(CuttingParameters* cp, const QDomNode& n);
-  void processText(ToolEntry* t, const QDomNode& n);
-  void readAttribute(ToolEntry* t, const QDomAttr& a);
-  void readAttribute(ToolEntry* t, CuttingParameters* cp, const QDomAttr& a);
-  void readAttributes(ToolEntry* t, const QDomNamedNodeMap& attrs);
-  void readAttributes(ToolEntry* t, CuttingParameters* cp, const QDomNamedNodeMap& attrs);
-  void readElement(ToolEntry* t, const QDomElement& e);
-  void readElement(ToolEntry* t, CuttingParameters* cp, const QDomElement& e);
+  QVector<ToolEntry*> process(QXmlStreamReader& xml);
+  void                readCuttingParameters(QXmlStreamReader& xml, ToolEntry* t);
+  void                readProperty(QXmlStreamReader& xml, CuttingParameters* cp);
+  void                readProperty(QXmlStreamReader& xml, ToolEntry* t);
+  ToolEntry*          readTool(QXmlStreamReader& xml);
   };
 #endif // XMLTOOLREADER_H
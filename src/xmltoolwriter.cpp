@@ -28,7 +28,8 @@
 #include "toolentry.h"
 #include "cuttingparameters.h"
 #include <QFile>
-#include <QTextStream>
+#include <QXmlStreamWriter>
+#include <QDebug>
 
 
 XmlToolWriter::XmlToolWriter(QObject* parent)
@@ -36,44 +37,60 @@ XmlToolWriter::XmlToolWriter(QObject* parent)
   }
 
 
-void XmlToolWriter::write(const QString& fileName, const QVector<ToolEntry *>& tools) {
+bool XmlToolWriter::write(const QString& fileName, const QVector<ToolEntry *>& tools) {
   QFile toolFile(fileName);
 
-  if (toolFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-     QTextStream out(&toolFile);
-
-     writeLibrary(out, tools);
-     toolFile.flush();
-     toolFile.close();
+  if (!toolFile.open(QIODevice::WriteOnly)) {
+     qWarning() << "failed to open" << fileName << ":" << toolFile.errorString();
+     return false;
      }
+  bool rv = write(&toolFile, tools);
+
+  toolFile.close();
+
+  return rv;
+  }
+
+
+// tools get written one by one straight to the device, so
+// nothing like a document tree gets build up in memory.
+bool XmlToolWriter::write(QIODevice* io, const QVector<ToolEntry*>& tools) {
+  QXmlStreamWriter out(io);
+
+  out.setAutoFormatting(true);
+  out.setAutoFormattingIndent(2);
+  writeLibrary(out, tools);
+
+  return !out.hasError();
   }
 
 
-void XmlToolWriter::writeLibrary(QTextStream& out, const QVector<ToolEntry*>& tools) {
-  out << "<?xml version=\"1.0\" ?>\n<ToolLibrary>\n";
+void XmlToolWriter::writeLibrary(QXmlStreamWriter& out, const QVector<ToolEntry*>& tools) {
+  out.writeStartDocument();
+  out.writeStartElement("ToolLibrary");
   for (ToolEntry* t : tools) {
       if (t->toolNumber() < 1) continue;
       writeTool(out, t);
       }
-  out << "</ToolLibrary>\n";
+  out.writeEndElement();
+  out.writeEndDocument();
   }
 
 
-void XmlToolWriter::writeProperty(QTextStream& out, const QString &name, const QString v, bool doubleIndent) {
-  if (doubleIndent) out << "    ";
-  out << QString("    <%1>%2</%1>\n").arg(name).arg(v);
+void XmlToolWriter::writeProperty(QXmlStreamWriter& out, const QString &name, const QString& v) {
+  out.writeTextElement(name, v);
   }
 
 
-void XmlToolWriter::writeProperty(QTextStream& out, const QString &name, double v, bool doubleIndent) {
-  if (doubleIndent) out << "    ";
-  out << QString("    <%1>%2</%1>\n").arg(name).arg(v, 0, 'f', 2);
+void XmlToolWriter::writeProperty(QXmlStreamWriter& out, const QString &name, double v) {
+  out.writeTextElement(name, QString::number(v, 'f', 2));
   }
 
 
-void XmlToolWriter::writeTool(QTextStream& out, ToolEntry* t) {
+void XmlToolWriter::writeTool(QXmlStreamWriter& out, ToolEntry* t) {
   if (!t) return;
-  out << QString("  <ToolDefinition Number=\"%1\">\n").arg(t->toolNumber());
+  out.writeStartElement("ToolDefinition");
+  out.writeAttribute("Number", QString::number(t->toolNumber()));
 
   writeProperty(out, "Name",          t->toolName());
   writeProperty(out, "Collet",        t->collet());
@@ -92,13 +109,14 @@ void XmlToolWriter::writeTool(QTextStream& out, ToolEntry* t) {
   for (int i=0; i < mx; ++i) {
       cp = cpList.at(i);
 
-      out << QString("    <CuttingParameters num=\"%1\">\n").arg(i);
-      writeProperty(out, "Material", cp->name(), true);
-      writeProperty(out, "Speed", cp->cuttingSpeed(), true);
-      writeProperty(out, "Feed",  cp->toothFeed(), true);
-      writeProperty(out, "Width", cp->widthOfCut(), true);
-      writeProperty(out, "Depth", cp->depthOfCut(), true);
-      out << "    </CuttingParameters>\n";
+      out.writeStartElement("CuttingParameters");
+      out.writeAttribute("num", QString::number(i));
+      writeProperty(out, "Material", cp->name());
+      writeProperty(out, "Speed",    cp->cuttingSpeed());
+      writeProperty(out, "Feed",     cp->toothFeed());
+      writeProperty(out, "Width",    cp->widthOfCut());
+      writeProperty(out, "Depth",    cp->depthOfCut());
+      out.writeEndElement();
       }
-  out << "  </ToolDefinition>\n";
+  out.writeEndElement();
   }
@@ -27,8 +27,9 @@
 #ifndef XMLTOOLWRITER_H
 #define XMLTOOLWRITER_H
 #include <QObject>
+class QIODevice;
 class QString;
-class QTextStream;
+class QXmlStreamWriter;
 class ToolEntry;
 
 
@@ -38,12 +39,13 @@ class XmlToolWriter : public QObject
 public:
   explicit XmlToolWriter(QObject *parent = nullptr);
 
-  void write(const QString& fileName, const QVector<ToolEntry*>& tools);
+  bool write(const QString& fileName, const QVector<ToolEntry*>& tools);
+  bool write(QIODevice* io, const QVector<ToolEntry*>& tools);
 
 protected:
-  void writeLibrary(QTextStream& out, const QVector<ToolEntry*>& tools);
-  void writeTool(QTextStream& out, ToolEntry* t);
-  void writeProperty(QTextStream& out, const QString& name, const QString v, bool doubleIndent = false);
-  void writeProperty(QTextStream& out, const QString& name, double v, bool doubleIndent = false);
+  void writeLibrary(QXmlStreamWriter& out, const QVector<ToolEntry*>& tools);
+  void writeTool(QXmlStreamWriter& out, ToolEntry* t);
+  void writeProperty(QXmlStreamWriter& out, const QString& name, const QString& v);
+  void writeProperty(QXmlStreamWriter& out, const QString& name, double v);
   };
 #endif // XMLTOOLWRITER_H